@@ -0,0 +1,149 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#include "batch.hpp"
+
+using namespace std;
+
+namespace casadi {
+
+  Function Batch::create(const Function& f, casadi_int n) {
+    casadi_assert(n>=1, "Number of instances must be positive");
+    return Function::create(new Batch("batch" + str(n) + "_" + f.name(), f, n), Dict());
+  }
+
+  Batch::Batch(const std::string& name, const Function& f, casadi_int n)
+    : FunctionInternal(name), f_(f), n_(n) {
+  }
+
+  Batch::~Batch() {
+  }
+
+  void Batch::init(const Dict& opts) {
+    // Call the initialization method of the base class
+    FunctionInternal::init(opts);
+
+    // Buffers for a single instance
+    alloc_arg(f_.sz_arg());
+    alloc_res(f_.sz_res());
+    alloc_iw(f_.sz_iw());
+    alloc_w(f_.nnz_in() + f_.nnz_out() + f_.sz_w());
+
+    // Instances evaluated side by side in generated code
+    if (f_->has_codegen_batch()) alloc_w(f_.sz_w()*n_);
+  }
+
+  int Batch::eval(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const {
+    casadi_int nnz_in = f_.nnz_in(), nnz_out = f_.nnz_out();
+    // Input and output buffers for a single instance
+    const double** arg1 = arg + n_in_;
+    double** res1 = res + n_out_;
+    double* x = w;
+    for (casadi_int i=0; i<n_in_; ++i) {
+      arg1[i] = arg[i] ? x : nullptr;
+      x += f_.nnz_in(i);
+    }
+    for (casadi_int i=0; i<n_out_; ++i) {
+      res1[i] = res[i] ? x : nullptr;
+      x += f_.nnz_out(i);
+    }
+    for (casadi_int k=0; k<n_; ++k) {
+      // Gather inputs
+      x = w;
+      for (casadi_int i=0; i<n_in_; ++i) {
+        casadi_int nnz = f_.nnz_in(i);
+        if (arg[i]) {
+          for (casadi_int j=0; j<nnz; ++j) x[j] = arg[i][j*n_ + k];
+        }
+        x += nnz;
+      }
+      // Evaluate
+      if (f_(arg1, res1, iw, w + nnz_in + nnz_out)) return 1;
+      // Scatter outputs
+      for (casadi_int i=0; i<n_out_; ++i) {
+        casadi_int nnz = f_.nnz_out(i);
+        if (res[i]) {
+          for (casadi_int j=0; j<nnz; ++j) res[i][j*n_ + k] = x[j];
+        }
+        x += nnz;
+      }
+    }
+    return 0;
+  }
+
+  void Batch::codegen_declarations(CodeGenerator& g) const {
+    if (f_->has_codegen_batch()) {
+      f_->codegen_declarations(g);
+    } else {
+      g.add_dependency(f_);
+    }
+  }
+
+  void Batch::codegen_body(CodeGenerator& g) const {
+    // Loops over the instances generated by the function
+    if (f_->has_codegen_batch()) {
+      f_->codegen_batch(g, n_);
+      return;
+    }
+
+    // Evaluate the instances one by one
+    g.local("k", "casadi_int");
+    g.local("j", "casadi_int");
+    g.local("arg1", "const casadi_real", "**");
+    g.local("res1", "casadi_real", "**");
+    g << "arg1 = arg+" << n_in_ << ";\n"
+      << "res1 = res+" << n_out_ << ";\n";
+    // Input and output buffers for a single instance
+    casadi_int offset = 0;
+    for (casadi_int i=0; i<n_in_; ++i) {
+      g << "arg1[" << i << "] = arg[" << i << "] ? w+" << offset << " : 0;\n";
+      offset += f_.nnz_in(i);
+    }
+    for (casadi_int i=0; i<n_out_; ++i) {
+      g << "res1[" << i << "] = res[" << i << "] ? w+" << offset << " : 0;\n";
+      offset += f_.nnz_out(i);
+    }
+    g << "for (k=0; k<" << n_ << "; ++k) {\n";
+    // Gather inputs
+    offset = 0;
+    for (casadi_int i=0; i<n_in_; ++i) {
+      g << "if (arg[" << i << "]) for (j=0; j<" << f_.nnz_in(i) << "; ++j) "
+        << "w[" << offset << "+j] = arg[" << i << "][j*" << n_ << "+k];\n";
+      offset += f_.nnz_in(i);
+    }
+    // Evaluate
+    g << "if (" << g(f_, "arg1", "res1", "iw", "w+" + str(f_.nnz_in() + f_.nnz_out()))
+      << ") return 1;\n";
+    // Scatter outputs
+    for (casadi_int i=0; i<n_out_; ++i) {
+      g << "if (res[" << i << "]) for (j=0; j<" << f_.nnz_out(i) << "; ++j) "
+        << "res[" << i << "][j*" << n_ << "+k] = w[" << offset << "+j];\n";
+      offset += f_.nnz_out(i);
+    }
+    g << "}\n";
+  }
+
+} // namespace casadi
@@ -0,0 +1,113 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#ifndef CASADI_BATCH_HPP
+#define CASADI_BATCH_HPP
+
+#include "function_internal.hpp"
+
+/// \cond INTERNAL
+
+namespace casadi {
+
+  /** Evaluate a function for several instances stored as a structure of arrays
+
+      Input and output i are dense matrices with n rows and f.nnz_in(i)
+      (f.nnz_out(i)) columns, i.e. nonzero j of instance k is stored at
+      position j*n + k. Functions that support it generate code with loops
+      over the instances that a C compiler can vectorize.
+  */
+  class CASADI_EXPORT Batch : public FunctionInternal {
+  public:
+    // Create function (use instead of constructor)
+    static Function create(const Function& f, casadi_int n);
+
+    /** \brief Destructor */
+    ~Batch() override;
+
+    /** \brief Get type name */
+    std::string class_name() const override {return "Batch";}
+
+    /** \brief Check if the function is of a particular type */
+    bool is_a(const std::string& type, bool recursive) const override {
+      return type=="Batch" || (recursive && FunctionInternal::is_a(type, recursive));
+    }
+
+    /// @{
+    /** \brief Sparsities of function inputs and outputs */
+    Sparsity get_sparsity_in(casadi_int i) override {
+      return Sparsity::dense(n_, f_.nnz_in(i));
+    }
+    Sparsity get_sparsity_out(casadi_int i) override {
+      return Sparsity::dense(n_, f_.nnz_out(i));
+    }
+    /// @}
+
+    ///@{
+    /** \brief Number of function inputs and outputs */
+    size_t get_n_in() override { return f_.n_in();}
+    size_t get_n_out() override { return f_.n_out();}
+    ///@}
+
+    ///@{
+    /** \brief Names of function input and outputs */
+    std::string get_name_in(casadi_int i) override { return f_.name_in(i);}
+    std::string get_name_out(casadi_int i) override { return f_.name_out(i);}
+    /// @}
+
+    /// Evaluate the function numerically
+    int eval(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const override;
+
+    /** \brief Is codegen supported? */
+    bool has_codegen() const override { return true;}
+
+    /** \brief Generate code for the declarations of the C function */
+    void codegen_declarations(CodeGenerator& g) const override;
+
+    /** \brief Generate code for the body of the C function */
+    void codegen_body(CodeGenerator& g) const override;
+
+    /** \brief  Initialize */
+    void init(const Dict& opts) override;
+
+    /** Obtain information about node */
+    Dict info() const override { return {{"f", f_}, {"n", n_}}; }
+
+  protected:
+    // Constructor (protected, use create function)
+    Batch(const std::string& name, const Function& f, casadi_int n);
+
+    // The function which is to be evaluated for each instance
+    Function f_;
+
+    // Number of instances
+    casadi_int n_;
+  };
+
+} // namespace casadi
+/// \endcond
+
+#endif // CASADI_BATCH_HPP
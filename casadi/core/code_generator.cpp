@@ -26,6 +26,7 @@
 
 #include "code_generator.hpp"
 #include "function_internal.hpp"
+#include "batch.hpp"
 #include <iomanip>
 #include <casadi_runtime_str.h>
 
@@ -48,6 +49,14 @@ namespace casadi {
     this->include_math = true;
     avoid_stack_ = false;
     indent_ = 2;
+    chunk_indent_ = -1;
+    this->split = 1;
+    this->reroll = false;
+    this->batch = 0;
+    this->openmp = false;
+    this->static_memory = false;
+    this->mixed_precision = 0;
+    this->mixed_precision_bound = 1;
 
     // Read options
     for (auto&& e : opts) {
@@ -80,11 +89,41 @@ namespace casadi {
         casadi_assert_dev(indent_>=0);
       } else if (e.first=="avoid_stack") {
         avoid_stack_ = e.second;
+      } else if (e.first=="split") {
+        this->split = e.second;
+        casadi_assert(this->split>=1, "Option 'split' must be positive");
+      } else if (e.first=="reroll") {
+        this->reroll = e.second;
+      } else if (e.first=="static_memory") {
+        this->static_memory = e.second;
+      } else if (e.first=="mixed_precision") {
+        this->mixed_precision = e.second;
+        casadi_assert(this->mixed_precision>=0, "Option 'mixed_precision' must be nonnegative");
+      } else if (e.first=="mixed_precision_bound") {
+        this->mixed_precision_bound = e.second;
+        casadi_assert(this->mixed_precision_bound>=0,
+                      "Option 'mixed_precision_bound' must be nonnegative");
+      } else if (e.first=="openmp") {
+        this->openmp = e.second;
+      } else if (e.first=="batch") {
+        this->batch = e.second;
+        casadi_assert(this->batch>=0, "Option 'batch' must be nonnegative");
       } else {
         casadi_error("Unrecongnized option: " + str(e.first));
       }
     }
 
+    // Rolled loops index into the double precision work vector
+    casadi_assert(!(this->reroll && this->mixed_precision>0),
+                  "Options 'reroll' and 'mixed_precision' cannot be combined");
+
+    // Loops index into the work vector, static memory replaces the stack
+    if (this->reroll || this->static_memory) avoid_stack_ = true;
+
+    // The casadi_mem interface allocates its arrays on the heap
+    casadi_assert(!(this->static_memory && this->with_mem),
+                  "Options 'static_memory' and 'with_mem' cannot be combined");
+
     // Start at new line with no indentation
     newline_ = true;
     current_indent_ = 0;
@@ -129,16 +168,29 @@ namespace casadi {
 
   string CodeGenerator::add_dependency(const Function& f) {
     // Quick return if it already exists
-    for (auto&& e : added_functions_) if (e.f==f) return e.codegen_name;
+    for (auto&& e : added_functions_) {
+      if (e.f==f) {
+        if (!dep_stack_.empty()) callees_[dep_stack_.back()].insert(e.codegen_name);
+        return e.codegen_name;
+      }
+    }
+
+    // Memory objects of external code are not part of the static buffers
+    casadi_assert(!(this->static_memory && f->has_refcount_),
+                  "Option 'static_memory': '" + f.name() + "' has memory objects "
+                  "managed by external code (incref/decref), which cannot be accounted for");
 
     // Give it a name
     string fname = shorthand("f" + str(added_functions_.size()));
+    if (!dep_stack_.empty()) callees_[dep_stack_.back()].insert(fname);
 
     // Add to list of functions
     added_functions_.push_back({f, fname});
 
     // Generate declarations
+    dep_stack_.push_back(fname);
     f->codegen_declarations(*this);
+    dep_stack_.pop_back();
 
     // Print to file
     f->codegen(*this, fname);
@@ -159,6 +211,16 @@ namespace casadi {
     // Flush to body
     flush(this->body);
 
+    // Possible location for dividing the source
+    body_split_.push_back(this->body.tellp());
+
+    // Parts of the body defined as separate functions
+    for (auto&& c : pending_chunks_) {
+      this->body << c;
+      body_split_.push_back(this->body.tellp());
+    }
+    pending_chunks_.clear();
+
     return fname;
   }
 
@@ -187,6 +249,9 @@ namespace casadi {
 
     // Add to list of exposed symbols
     this->exposed_fname.push_back(f.name());
+
+    // Batch variant
+    if (this->batch>0 && !f.is_a("Batch")) add(Batch::create(f, this->batch));
   }
 
   string CodeGenerator::dump() const {
@@ -246,6 +311,19 @@ namespace casadi {
       << "#endif\n\n";
   }
 
+  void  CodeGenerator::generate_shared_symbol(std::ostream &s) const {
+      s << "/* Linkage of functions shared between the source files */\n"
+      << "#ifndef CASADI_SHARED\n"
+      << "  #if defined(_WIN32) || defined(__WIN32__) || defined(__CYGWIN__)\n"
+      << "    #define CASADI_SHARED\n"
+      << "  #elif defined(__GNUC__)\n"
+      << "    #define CASADI_SHARED __attribute__ ((visibility (\"hidden\")))\n"
+      << "  #else"  << endl
+      << "    #define CASADI_SHARED\n"
+      << "  #endif\n"
+      << "#endif\n\n";
+  }
+
   void  CodeGenerator::generate_import_symbol(std::ostream &s) const {
       s << "/* Symbol visibility in DLLs */\n"
       << "#ifndef CASADI_SYMBOL_IMPORT\n"
@@ -282,7 +360,27 @@ namespace casadi {
     file_open(s, fullname);
 
     // Dump code to file
-    dump(s);
+    if (this->split>1) {
+      // Function definitions divided into several files
+      vector<string> parts = split_body();
+      dump_preamble(s);
+      s << parts.front() << endl;
+      // Additional files, listed in the meta data
+      s << "/*CASADIMETA\n"
+        << ":split " << parts.size()-1 << "\n";
+      for (casadi_int k=1; k<parts.size(); ++k) {
+        string partname = this->name + "_" + str(k) + this->suffix;
+        s << ":split[" << k-1 << "] " << partname << "\n";
+        ofstream sk;
+        file_open(sk, prefix + partname);
+        dump_preamble(sk, k);
+        sk << parts[k] << endl;
+        file_close(sk);
+      }
+      s << "*/\n";
+    } else {
+      dump(s);
+    }
 
     // Mex entry point
     if (this->mex) generate_mex(s);
@@ -293,6 +391,9 @@ namespace casadi {
     // Finalize file
     file_close(s);
 
+    // Memory report
+    if (this->static_memory) generate_memory_report(prefix + this->name + "_memory.txt");
+
     // Generate header
     if (this->with_header) {
       // Create a header file
@@ -357,7 +458,50 @@ namespace casadi {
          << "#endif\n";
   }
 
+  size_t CodeGenerator::worst_stack(const std::string& fname) const {
+    size_t r = 0;
+    auto it = callees_.find(fname);
+    if (it!=callees_.end()) {
+      for (auto&& c : it->second) r = max(r, worst_stack(c));
+    }
+    auto f = frame_size_.find(fname);
+    if (f!=frame_size_.end()) r += f->second;
+    return r;
+  }
+
+  void CodeGenerator::generate_memory_report(const std::string& fullname) const {
+    ofstream s(fullname);
+    size_t sz_real = this->casadi_real=="float" ? sizeof(float) : sizeof(double);
+    s << "Memory report for " << this->name << this->suffix << "\n\n"
+      << "Static buffers, used by NAME_static (bytes):\n";
+    for (auto&& e : static_memory_) {
+      size_t b = (e.sz_arg + e.sz_res)*sizeof(void*) + e.sz_iw*sizeof(casadi_int)
+        + e.sz_w*sz_real;
+      s << "  " << e.name << ": " << b << " (arg " << e.sz_arg << ", res " << e.sz_res
+        << ", iw " << e.sz_iw << ", w " << e.sz_w << ")\n";
+    }
+    s << "\nWorst-case stack, local variables including called functions (bytes):\n";
+    for (auto&& e : static_memory_) {
+      s << "  " << e.name << ": " << worst_stack(e.codegen_name) << "\n";
+    }
+    s << "\nStack frame of each generated function (bytes):\n";
+    for (auto&& e : added_functions_) {
+      auto f = frame_size_.find(e.codegen_name);
+      s << "  " << e.codegen_name << " (" << e.f.name() << "): "
+        << (f==frame_size_.end() ? 0 : f->second) << "\n";
+    }
+    s << "\nSizes of casadi_int and pointers are those of the generating platform.\n";
+  }
+
   void CodeGenerator::generate_main(std::ostream &s) const {
+    // Entry points may be defined in a different file
+    if (this->split>1) {
+      for (casadi_int i=0; i<exposed_fname.size(); ++i) {
+        s << "casadi_int main_" << exposed_fname[i] << "(casadi_int argc, char* argv[]);\n";
+      }
+      s << endl;
+    }
+
     s << "int main(int argc, char* argv[]) {\n";
 
     // Create switch
@@ -382,6 +526,34 @@ namespace casadi {
   }
 
   void CodeGenerator::dump(std::ostream& s) const {
+    dump_preamble(s);
+
+    // Codegen body
+    s << this->body.str();
+
+    // End with new line
+    s << endl;
+  }
+
+  std::vector<std::string> CodeGenerator::split_body() const {
+    string b = this->body.str();
+    vector<string> parts(1);
+    size_t start = 0;
+    for (casadi_int k=0; k<=body_split_.size(); ++k) {
+      size_t stop = k<body_split_.size() ? static_cast<size_t>(body_split_[k]) : b.size();
+      if (stop<=start) continue;
+      // Start a new part when most of the next piece is beyond the share of the current one
+      if (parts.size()<this->split && !parts.back().empty()
+          && (start+stop)*this->split >= 2*parts.size()*b.size()) {
+        parts.push_back(string());
+      }
+      parts.back() += b.substr(start, stop-start);
+      start = stop;
+    }
+    return parts;
+  }
+
+  void CodeGenerator::dump_preamble(std::ostream& s, casadi_int part) const {
     // Consistency check
     casadi_assert_dev(current_indent_ == 0);
 
@@ -406,14 +578,23 @@ namespace casadi {
 
     // Macros
     if (!added_shorthands_.empty()) {
+      // Functions shared between source files
+      set<string> shared;
+      if (part>0) {
+        for (auto&& e : added_functions_) shared.insert(e.codegen_name.substr(7));
+        for (auto&& c : added_chunks_) shared.insert(c.substr(7));
+      }
       s << "/* Add prefix to internal symbols */\n";
       for (auto&& i : added_shorthands_) {
-        s << "#define " << "casadi_" << i <<  " CASADI_PREFIX(" << i <<  ")\n";
+        // Symbols local to an additional source file get a unique name
+        string id = part==0 || shared.count(i) ? i : "p" + str(part) + "_" + i;
+        s << "#define " << "casadi_" << i <<  " CASADI_PREFIX(" << id <<  ")\n";
       }
       s << endl;
     }
 
     if (this->with_export) generate_export_symbol(s);
+    if (this->split>1) generate_shared_symbol(s);
 
     // Print integer constants
     if (!integer_constants_.empty()) {
@@ -443,11 +624,20 @@ namespace casadi {
     // Codegen auxiliary functions
     s << this->auxiliaries.str();
 
-    // Codegen body
-    s << this->body.str();
-
-    // End with new line
-    s << endl;
+    // Functions may be defined in a different file
+    if (this->split>1) {
+      for (auto&& e : added_functions_) {
+        s << "CASADI_SHARED " << e.f->signature(e.codegen_name) << ";\n";
+        if (e.f->has_refcount_) {
+          s << "void " << e.codegen_name << "_incref(void);\n"
+            << "void " << e.codegen_name << "_decref(void);\n";
+        }
+      }
+      for (auto&& c : added_chunks_) {
+        s << "CASADI_SHARED " << chunk_signature(c) << ";\n";
+      }
+      s << endl;
+    }
   }
 
   string CodeGenerator::work(casadi_int n, casadi_int sz) const {
@@ -741,6 +931,9 @@ namespace casadi {
     case AUX_MTIMES:
       this->auxiliaries << sanitize_source(casadi_mtimes_str, inst);
       break;
+    case AUX_BLOCK_MTIMES:
+      this->auxiliaries << sanitize_source(casadi_block_mtimes_str, inst);
+      break;
     case AUX_PROJECT:
       this->auxiliaries << sanitize_source(casadi_project_str, inst);
       break;
@@ -756,6 +949,9 @@ namespace casadi {
     case AUX_TRANS:
       this->auxiliaries << sanitize_source(casadi_trans_str, inst);
       break;
+    case AUX_BLOCK_TRANS:
+      this->auxiliaries << sanitize_source(casadi_block_trans_str, inst);
+      break;
     case AUX_TO_MEX:
       add_auxiliary(AUX_TO_DOUBLE);
       this->auxiliaries << "#ifdef MATLAB_MEX_FILE\n"
@@ -782,6 +978,9 @@ namespace casadi {
     case AUX_LDL:
       this->auxiliaries << sanitize_source(casadi_ldl_str, inst);
       break;
+    case AUX_BLOCK_LDL:
+      this->auxiliaries << sanitize_source(casadi_block_ldl_str, inst);
+      break;
     case AUX_NEWTON:
       add_auxiliary(AUX_COPY);
       add_auxiliary(AUX_AXPY);
@@ -789,6 +988,47 @@ namespace casadi {
       add_auxiliary(AUX_QR);
       this->auxiliaries << sanitize_source(casadi_newton_str, inst);
       break;
+    case AUX_QP:
+      add_auxiliary(AUX_MAX);
+      add_auxiliary(AUX_FMIN);
+      add_auxiliary(AUX_FMAX);
+      add_auxiliary(AUX_COPY);
+      add_auxiliary(AUX_FILL);
+      add_auxiliary(AUX_SCAL);
+      add_auxiliary(AUX_AXPY);
+      add_auxiliary(AUX_DOT);
+      add_auxiliary(AUX_BILIN);
+      add_auxiliary(AUX_MV);
+      add_auxiliary(AUX_TRANS);
+      add_auxiliary(AUX_QR);
+      add_include("stdarg.h");
+      add_include("stdio.h");
+      this->auxiliaries << sanitize_source(casadi_qp_str, inst);
+      break;
+    case AUX_MAX_VIOL:
+      add_auxiliary(AUX_FMAX);
+      this->auxiliaries << sanitize_source(casadi_max_viol_str, inst);
+      break;
+    case AUX_BFGS:
+      add_auxiliary(AUX_IF_ELSE);
+      add_auxiliary(AUX_COPY);
+      add_auxiliary(AUX_AXPY);
+      add_auxiliary(AUX_FILL);
+      add_auxiliary(AUX_MV);
+      add_auxiliary(AUX_DOT);
+      add_auxiliary(AUX_SCAL);
+      add_auxiliary(AUX_RANK1);
+      this->auxiliaries << sanitize_source(casadi_bfgs_str, inst);
+      break;
+    case AUX_REGULARIZE:
+      add_auxiliary(AUX_FMIN);
+      this->auxiliaries << sanitize_source(casadi_regularize_str, inst);
+      break;
+    case AUX_BOUND_CONSISTENCY:
+      add_auxiliary(AUX_FMIN);
+      add_auxiliary(AUX_FMAX);
+      this->auxiliaries << sanitize_source(casadi_bound_consistency_str, inst);
+      break;
     case AUX_TO_DOUBLE:
       this->auxiliaries << "#define casadi_to_double(x) "
                         << "(" << (this->cpp ? "static_cast<double>(x)" : "(double) x") << ")\n\n";
@@ -839,6 +1079,9 @@ namespace casadi {
                         << "#endif\n"
                         << "}\n\n";
       break;
+    case AUX_MAX:
+      this->auxiliaries << "#define casadi_max(x, y) ((x)>(y) ? (x) : (y))\n\n";
+      break;
     case AUX_FMAX:
       shorthand("fmax");
       this->auxiliaries << "casadi_real casadi_fmax(casadi_real x, casadi_real y) {\n"
@@ -946,6 +1189,21 @@ namespace casadi {
     return s.str();
   }
 
+  string CodeGenerator::norm_inf(casadi_int n, const string& x) {
+    add_auxiliary(AUX_NORM_INF);
+    stringstream s;
+    s << "casadi_norm_inf(" << n << ", " << x << ")";
+    return s.str();
+  }
+
+  string CodeGenerator::max_viol(casadi_int n, const string& x,
+                                 const string& lb, const string& ub) {
+    add_auxiliary(AUX_MAX_VIOL);
+    stringstream s;
+    s << "casadi_max_viol(" << n << ", " << x << ", " << lb << ", " << ub << ")";
+    return s.str();
+  }
+
   string CodeGenerator::bilin(const string& A, const Sparsity& sp_A,
                                    const string& x, const string& y) {
     add_auxiliary(AUX_BILIN);
@@ -996,6 +1254,14 @@ namespace casadi {
             + y + ", " + sparsity(sp_y) + ", " + iw + ")";
   }
 
+  string CodeGenerator::block_trans(const string& x, const Sparsity& sp_x,
+                                    const string& y, const Sparsity& sp_y,
+                                    const string& iw, casadi_int bs) {
+    add_auxiliary(CodeGenerator::AUX_BLOCK_TRANS);
+    return "casadi_block_trans(" + x + ", " + sparsity(sp_x) + ", "
+            + y + ", " + sparsity(sp_y) + ", " + iw + ", " + str(bs) + ")";
+  }
+
   string CodeGenerator::declare(string s) {
     // Add c linkage
     string cpp_prefix = this->cpp ? "extern \"C\" " : "";
@@ -1091,6 +1357,15 @@ namespace casadi {
       + z + ", " + sparsity(sp_z) + ", " + w + ", " +  (tr ? "1" : "0") + ");";
   }
 
+  string CodeGenerator::block_mtimes(const string& x, const Sparsity& sp_x,
+                                     const string& y, const Sparsity& sp_y,
+                                     const string& z, const Sparsity& sp_z,
+                                     const string& w, casadi_int bs) {
+    add_auxiliary(AUX_BLOCK_MTIMES);
+    return "casadi_block_mtimes(" + x + ", " + sparsity(sp_x) + ", " + y + ", "
+      + sparsity(sp_y) + ", " + z + ", " + sparsity(sp_z) + ", " + w + ", " + str(bs) + ");";
+  }
+
   void CodeGenerator::print_formatted(const string& s) {
     // Quick return if empty
     if (s.empty()) return;
@@ -1157,6 +1432,98 @@ namespace casadi {
     }
   }
 
+  size_t CodeGenerator::print_locals(std::ostream& s) const {
+    // Stack frame, for the memory report
+    size_t frame = 0;
+    for (auto&& e : local_variables_) {
+      const string& type = e.second.first;
+      if (!e.second.second.empty()) {
+        frame += sizeof(void*);
+      } else if (type=="casadi_int") {
+        frame += sizeof(casadi_int);
+      } else if (type=="int") {
+        frame += sizeof(int);
+      } else if (type=="float") {
+        frame += sizeof(float);
+      } else if (type.compare(0, 7, "struct ")==0) {
+        auto it = struct_size_.find(type);
+        if (it!=struct_size_.end()) {
+          frame += it->second;
+        } else {
+          casadi_assert(!this->static_memory, "Size of local '" + e.first + "' of type '"
+                        + type + "' unknown, cannot generate the memory report");
+        }
+      } else {
+        frame += this->casadi_real=="float" ? sizeof(float) : sizeof(double);
+      }
+    }
+
+    // Order local variables
+    std::map<string, set<pair<string, string>>> local_variables_by_type;
+    for (auto&& e : local_variables_) {
+      local_variables_by_type[e.second.first].insert(make_pair(e.first, e.second.second));
+    }
+
+    // Codegen local variables
+    for (auto&& e : local_variables_by_type) {
+      s << "  " << e.first;
+      for (auto it=e.second.begin(); it!=e.second.end(); ++it) {
+        s << (it==e.second.begin() ? " " : ", ") << it->second << it->first;
+        // Insert definition, if any
+        auto k=local_default_.find(it->first);
+        if (k!=local_default_.end()) s << "=" << k->second;
+      }
+      s << ";\n";
+    }
+    return frame;
+  }
+
+  std::string CodeGenerator::chunk_signature(const std::string& cname) {
+    return "void " + cname + "(const casadi_real** arg, casadi_real** res, casadi_real* w)";
+  }
+
+  std::string CodeGenerator::begin_chunk(const std::string& caller) {
+    casadi_assert(chunk_indent_<0, "Chunks cannot be nested");
+    casadi_assert(this->split>1, "Chunks require the definitions to be split");
+    string cname = shorthand("fc" + str(added_chunks_.size()), false);
+    added_chunks_.push_back(cname);
+    callees_[caller].insert(cname);
+    chunk_caller_ = caller;
+
+    // Set aside the code and local variables of the caller
+    chunk_buffer_ = this->buffer.str();
+    this->buffer.str(string());
+    chunk_variables_.swap(local_variables_);
+    chunk_default_.swap(local_default_);
+    local_variables_.clear();
+    local_default_.clear();
+    chunk_indent_ = current_indent_;
+    current_indent_ = 1;
+    return cname;
+  }
+
+  void CodeGenerator::end_chunk() {
+    casadi_assert(chunk_indent_>=0, "No chunk started");
+    const string& cname = added_chunks_.back();
+
+    // Complete definition, placed after the caller
+    stringstream s;
+    s << "/* Part of " << chunk_caller_ << " */\n";
+    s << "CASADI_SHARED " << chunk_signature(cname) << " {\n";
+    frame_size_[cname] = print_locals(s);
+    s << this->buffer.str() << "}\n\n";
+    pending_chunks_.push_back(s.str());
+
+    // Restore the caller
+    this->buffer.str(chunk_buffer_);
+    this->buffer.seekp(0, std::ios_base::end);
+    chunk_buffer_.clear();
+    local_variables_.swap(chunk_variables_);
+    local_default_.swap(chunk_default_);
+    current_indent_ = chunk_indent_;
+    chunk_indent_ = -1;
+  }
+
   std::string CodeGenerator::sx_work(casadi_int i) {
     if (avoid_stack_) {
       return "w[" + str(i) + "]";
@@ -1170,6 +1537,12 @@ namespace casadi {
     }
   }
 
+  std::string CodeGenerator::sx_work_float(casadi_int i) {
+    std::string name = "f"+str(i);
+    local(name, "float");
+    return name;
+  }
+
   void CodeGenerator::init_local(const string& name, const string& def) {
     bool inserted = local_default_.insert(make_pair(name, def)).second;
     casadi_assert(inserted, name + " already defined");
@@ -1338,4 +1711,23 @@ namespace casadi {
            + lt + ", " + d + ", " + p + ", " + w + ");";
   }
 
+  std::string CodeGenerator::
+  block_ldl(const std::string& sp_a, const std::string& a,
+            const std::string& sp_lt, const std::string& lt, const std::string& dl,
+            const std::string& d, const std::string& p, const std::string& w, casadi_int bs) {
+    add_auxiliary(CodeGenerator::AUX_BLOCK_LDL);
+    return "casadi_block_ldl(" + sp_a + ", " + a + ", " + sp_lt + ", " + lt + ", "
+           + dl + ", " + d + ", " + p + ", " + w + ", " + str(bs) + ");";
+  }
+
+  std::string CodeGenerator::
+  block_ldl_solve(const std::string& x, casadi_int nrhs,
+                  const std::string& sp_lt, const std::string& lt, const std::string& dl,
+                  const std::string& d, const std::string& p, const std::string& w,
+                  casadi_int bs) {
+    add_auxiliary(CodeGenerator::AUX_BLOCK_LDL);
+    return "casadi_block_ldl_solve(" + x + ", " + str(nrhs) + ", " + sp_lt + ", "
+           + lt + ", " + dl + ", " + d + ", " + p + ", " + w + ", " + str(bs) + ");";
+  }
+
 } // namespace casadi
@@ -48,6 +48,14 @@ namespace casadi {
 #ifndef SWIG
     /// Generate the code to a stream
     void dump(std::ostream& s) const;
+
+    /** \brief Print everything preceding the function definitions
+     * Additional source files (part>0) get their own copies of the auxiliary functions
+     */
+    void dump_preamble(std::ostream& s, casadi_int part=0) const;
+
+    /// Divide the function definitions into at most split parts of similar size
+    std::vector<std::string> split_body() const;
 #endif // SWIG
 
     /// Generate a file, return code as string
@@ -123,9 +131,34 @@ namespace casadi {
     /** \brief Declare a local variable */
     void local(const std::string& name, const std::string& type, const std::string& ref="");
 
+    /** \brief Declare a local variable of a runtime struct type, e.g. casadi_qp_data
+     * The size of the struct is recorded for the stack frames in the memory report
+     */
+    template<template<typename> class T>
+    void local_struct(const std::string& name, const std::string& type) {
+      local(name, "struct " + type);
+      struct_size_["struct " + type] = this->casadi_real=="float" ? sizeof(T<float>)
+                                                                   : sizeof(T<double>);
+    }
+
+    /** \brief Print the declarations of the local variables, return the stack frame (bytes) */
+    size_t print_locals(std::ostream& s) const;
+
+    /** \brief Continue the body of function \a caller in a separate function
+     * Code up to end_chunk goes into a function of the work vector, defined after
+     * the caller and possibly in a different source file. Returns its name.
+     */
+    std::string begin_chunk(const std::string& caller);
+
+    /** \brief Complete a function started with begin_chunk */
+    void end_chunk();
+
     /** \brief Declare a work vector element */
     std::string sx_work(casadi_int i);
 
+    /** \brief Declare a single precision work vector element */
+    std::string sx_work_float(casadi_int i);
+
     /** \brief Specify the default value for a local variable */
     void init_local(const std::string& name, const std::string& def);
 
@@ -154,6 +187,13 @@ namespace casadi {
     /** \brief Codegen inner product */
     std::string dot(casadi_int n, const std::string& x, const std::string& y);
 
+    /** \brief Codegen infinity norm */
+    std::string norm_inf(casadi_int n, const std::string& x);
+
+    /** \brief Codegen largest bound violation */
+    std::string max_viol(casadi_int n, const std::string& x,
+                         const std::string& lb, const std::string& ub);
+
     /** \brief Codegen sparse matrix-vector multiplication */
     std::string mv(const std::string& x, const Sparsity& sp_x,
                    const std::string& y, const std::string& z, bool tr);
@@ -175,6 +215,12 @@ namespace casadi {
                        const std::string& z, const Sparsity& sp_z,
                        const std::string& w, bool tr);
 
+    /** \brief Codegen block-sparse matrix-matrix multiplication */
+    std::string block_mtimes(const std::string& x, const Sparsity& sp_x,
+                             const std::string& y, const Sparsity& sp_y,
+                             const std::string& z, const Sparsity& sp_z,
+                             const std::string& w, casadi_int bs);
+
     /** \brief Codegen bilinear form */
     std::string bilin(const std::string& A, const Sparsity& sp_A,
                       const std::string& x, const std::string& y);
@@ -202,6 +248,10 @@ namespace casadi {
     std::string trans(const std::string& x, const Sparsity& sp_x,
       const std::string& y, const Sparsity& sp_y, const std::string& iw);
 
+    /** \brief Block-sparse transpose, sparsities of the blocks */
+    std::string block_trans(const std::string& x, const Sparsity& sp_x,
+      const std::string& y, const Sparsity& sp_y, const std::string& iw, casadi_int bs);
+
     /** \brief QR factorization */
     std::string qr(const std::string& sp, const std::string& A,
                    const std::string& w, const std::string& sp_v,
@@ -228,6 +278,18 @@ namespace casadi {
                          const std::string& d, const std::string& p,
                          const std::string& w);
 
+    /** \brief Block LDL factorization */
+    std::string block_ldl(const std::string& sp_a, const std::string& a,
+                          const std::string& sp_lt, const std::string& lt,
+                          const std::string& dl, const std::string& d,
+                          const std::string& p, const std::string& w, casadi_int bs);
+
+    /** \brief Block LDL solve */
+    std::string block_ldl_solve(const std::string& x, casadi_int nrhs,
+                                const std::string& sp_lt, const std::string& lt,
+                                const std::string& dl, const std::string& d,
+                                const std::string& p, const std::string& w, casadi_int bs);
+
     /** \brief Declare a function */
     std::string declare(std::string s);
 
@@ -251,9 +313,11 @@ namespace casadi {
       AUX_MV,
       AUX_MV_DENSE,
       AUX_MTIMES,
+      AUX_BLOCK_MTIMES,
       AUX_PROJECT,
       AUX_DENSIFY,
       AUX_TRANS,
+      AUX_BLOCK_TRANS,
       AUX_TO_MEX,
       AUX_FROM_MEX,
       AUX_INTERPN,
@@ -267,7 +331,13 @@ namespace casadi {
       AUX_FINITE_DIFF,
       AUX_QR,
       AUX_LDL,
+      AUX_BLOCK_LDL,
       AUX_NEWTON,
+      AUX_QP,
+      AUX_MAX_VIOL,
+      AUX_BFGS,
+      AUX_REGULARIZE,
+      AUX_BOUND_CONSISTENCY,
       AUX_TO_DOUBLE,
       AUX_TO_INT,
       AUX_CAST,
@@ -276,7 +346,8 @@ namespace casadi {
       AUX_IF_ELSE,
       AUX_PRINTF,
       AUX_FMIN,
-      AUX_FMAX
+      AUX_FMAX,
+      AUX_MAX
     };
 
     /** \brief Add a built-in auxiliary function */
@@ -358,6 +429,18 @@ namespace casadi {
     // Generate export symbol macros
     void generate_export_symbol(std::ostream &s) const;
 
+    // Generate linkage macro for functions shared between source files
+    void generate_shared_symbol(std::ostream &s) const;
+
+    // Signature of a function started with begin_chunk
+    static std::string chunk_signature(const std::string& cname);
+
+    // Generate report on static memory and stack usage
+    void generate_memory_report(const std::string& fullname) const;
+
+    // Worst-case stack usage of a generated function, including called functions
+    size_t worst_stack(const std::string& fname) const;
+
     // Generate import symbol macros
     void generate_import_symbol(std::ostream &s) const;
 
@@ -398,6 +481,44 @@ namespace casadi {
     // Do we want to be lean on stack usage?
     bool avoid_stack_;
 
+    /** \brief Number of source files to divide the function definitions into
+     * The additional files are listed in the meta data of the main file.
+     * Large SX algorithms are divided into chunks as well, unless mixed_precision is set.
+     */
+    casadi_int split;
+
+    /** \brief Roll repeated instruction blocks into loops
+     * Requires the work vector elements to be addressable, implies avoid_stack
+     */
+    bool reroll;
+
+    /** \brief Number of instances in the batch variant of each added function
+     * Inputs and outputs are stored as structures of arrays, see Function::batch
+     */
+    casadi_int batch;
+
+    /** \brief Evaluate independent function calls in MX functions in parallel
+     * Uses OpenMP sections, the generated code is serial if OpenMP is not enabled
+     */
+    bool openmp;
+
+    /** \brief Statically allocated memory for each exposed function
+     * Adds the entry point NAME_static(arg, res) using a single static buffer of
+     * compile-time constant size and writes a memory report. Implies avoid_stack.
+     * Memory structs of generated solvers are locals, included in the stack frames.
+     * Not available with with_mem, or for functions holding memory in external code.
+     */
+    bool static_memory;
+
+    /** \brief Tolerance on the forward error of mixed precision code, 0 if disabled
+     * Operations in SX functions are carried out in single precision when the
+     * propagated bound on their absolute error stays below the tolerance
+     */
+    double mixed_precision;
+
+    /// Bound on the magnitude of the inputs, used for the error analysis
+    double mixed_precision_bound;
+
     /** \brief Codegen scalar
      * Use the work vector for storing work vector elements of length 1
      * (typically scalar) instead of using local variables
@@ -449,6 +570,40 @@ namespace casadi {
     };
     std::vector<FunctionMeta> added_functions_;
 
+    // Positions in the body after each complete function definition
+    std::vector<std::streamoff> body_split_;
+
+    // Functions continuing the body of another function, see begin_chunk
+    std::vector<std::string> added_chunks_;
+
+    // Definitions of chunks, added to the body after the function they belong to
+    std::vector<std::string> pending_chunks_;
+
+    // Code and local variables of the caller while a chunk is being generated
+    std::string chunk_caller_, chunk_buffer_;
+    std::map<std::string, std::pair<std::string, std::string> > chunk_variables_;
+    std::map<std::string, std::string> chunk_default_;
+    casadi_int chunk_indent_;
+
+    // Work vector sizes of exposed functions, for the memory report
+    struct StaticMemory {
+      std::string name, codegen_name;
+      size_t sz_arg, sz_res, sz_iw, sz_w;
+    };
+    std::vector<StaticMemory> static_memory_;
+
+    // Stack frame of each generated function, local variables only
+    std::map<std::string, size_t> frame_size_;
+
+    // Sizes of the struct types used for local variables
+    std::map<std::string, size_t> struct_size_;
+
+    // Functions called by each generated function
+    std::map<std::string, std::set<std::string> > callees_;
+
+    // Functions whose declarations are being generated
+    std::vector<std::string> dep_stack_;
+
     // Constants
     std::vector<std::vector<double> > double_constants_;
     std::vector<std::vector<casadi_int> > integer_constants_;
@@ -660,6 +660,11 @@ namespace casadi {
     }
   }
 
+  Function Function::batch(casadi_int n) const {
+    casadi_assert(n>0, "Degenerate batch operation");
+    return (*this)->batch(n);
+  }
+
   Function Function::
   slice(const std::string& name, const std::vector<casadi_int>& order_in,
         const std::vector<casadi_int>& order_out, const Dict& opts) const {
@@ -825,7 +830,23 @@ namespace casadi {
   }
 
   Dict Function::stats(casadi_int mem) const {
-    return (*this)->get_stats(memory(mem));
+    Dict ret = (*this)->get_stats(memory(mem));
+    // Add statistics that are not associated with a memory object
+    for (auto&& e : (*this)->stats_) ret.insert(e);
+    if ((*this)->jit_background_) {
+#ifdef CASADI_WITH_THREAD
+      const JitBackground& bg = (*this)->jit_bg_;
+      bool ready = bg.eval.load(std::memory_order_acquire)!=nullptr;
+      if (ready) {
+        std::lock_guard<std::mutex> lock(bg.mtx);
+        for (auto&& e : bg.stats) ret.insert(e);
+      }
+#else // CASADI_WITH_THREAD
+      bool ready = true;
+#endif // CASADI_WITH_THREAD
+      ret["jit_ready"] = ready;
+    }
+    return ret;
   }
 
   const Sparsity Function::
@@ -585,6 +585,18 @@ namespace casadi {
     Function map(casadi_int n, const std::string& parallelization,
       casadi_int max_num_threads) const;
 
+    /** \brief  Create a batched version of this function
+
+        Evaluates \a n instances, with input and output i stored as dense
+        matrices with \a n rows and nnz_in(i) (nnz_out(i)) columns, i.e.
+        nonzero j of instance k in row k and column j (structure of arrays).
+        Generated code loops over the instances in a way that allows a C
+        compiler to vectorize. If the function was compiled with the option
+        "jit_batch" equal to \a n, the compiled variant is returned.
+        Integrators integrate the instances simultaneously, as one system.
+    */
+    Function batch(casadi_int n) const;
+
     ///@{
     /** \brief Map with reduction
       A subset of the inputs are non-repeated and a subset of the outputs summed
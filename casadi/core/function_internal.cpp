@@ -30,6 +30,10 @@
 #include "external.hpp"
 #include "finite_differences.hpp"
 #include "map.hpp"
+#include "batch.hpp"
+#include "timing.hpp"
+#include "importer_internal.hpp"
+#include "casadi_meta.hpp"
 
 #include <typeinfo>
 #include <cctype>
@@ -38,10 +42,103 @@
 #include <ctime>
 #endif // WITH_DL
 #include <iomanip>
+#include <fstream>
+#include <algorithm>
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#include <sys/utime.h>
+#else // _WIN32
+#include <dirent.h>
+#include <utime.h>
+#endif // _WIN32
 
 using namespace std;
 
 namespace casadi {
+  static void jit_cache_touch(const std::string& path) {
+    // Update the modification time, used for least recently used removal
+#ifdef _WIN32
+    _utime(path.c_str(), nullptr);
+#else // _WIN32
+    utime(path.c_str(), nullptr);
+#endif // _WIN32
+  }
+
+  static void jit_cache_store(const std::string& lib, const std::string& bin,
+                              const std::string& folder, casadi_int max_size) {
+    // Create folder, if needed
+#ifdef _WIN32
+    _mkdir(folder.c_str());
+#else // _WIN32
+    mkdir(folder.c_str(), 0755);
+#endif // _WIN32
+
+    // Write to a unique temporary file in the cache, then rename atomically so that
+    // concurrent processes never see a partially written library
+    string tmp = temporary_file(bin + ".", ".tmp");
+    {
+      ifstream in(lib, ios::binary);
+      ofstream out(tmp, ios::binary | ios::trunc);
+      out << in.rdbuf();
+      if (!in.good() || !out.good()) {
+        remove(tmp.c_str());
+        casadi_warning("JIT cache: failed to write " + tmp);
+        return;
+      }
+    }
+#ifdef _WIN32
+    // rename does not replace an existing file on Windows
+    if (rename(tmp.c_str(), bin.c_str())) remove(tmp.c_str());
+#else // _WIN32
+    if (rename(tmp.c_str(), bin.c_str())) {
+      remove(tmp.c_str());
+      casadi_warning("JIT cache: failed to store " + bin);
+      return;
+    }
+#endif // _WIN32
+
+    // Size limit: remove least recently used libraries
+#ifndef _WIN32
+    vector<pair<time_t, string> > entries;
+    casadi_int total = 0;
+    if (DIR* dir = opendir(folder.c_str())) {
+      string suffix = SHARED_LIBRARY_SUFFIX;
+      while (struct dirent* e = readdir(dir)) {
+        string name = e->d_name;
+        if (name.size()<=suffix.size()
+            || name.compare(name.size()-suffix.size(), suffix.size(), suffix)) continue;
+        string path = folder + "/" + name;
+        struct stat st;
+        if (stat(path.c_str(), &st)) continue;
+        total += st.st_size;
+        entries.push_back(make_pair(st.st_mtime, path));
+      }
+      closedir(dir);
+    }
+    sort(entries.begin(), entries.end());
+    for (auto&& e : entries) {
+      if (total<=max_size) break;
+      if (e.second==bin) continue;
+      struct stat st;
+      if (stat(e.second.c_str(), &st)==0 && remove(e.second.c_str())==0) total -= st.st_size;
+    }
+#endif // _WIN32
+  }
+
+  static std::vector<std::string> jit_sources(const std::string& src) {
+    // Main file and any additional files listed in its meta data
+    vector<string> ret = {src};
+    Importer meta(src, "none");
+    if (meta.has_meta("split")) {
+      string dir = src.substr(0, src.find_last_of("/\\")+1);
+      casadi_int n_split = meta.meta_int("split");
+      for (casadi_int k=0; k<n_split; ++k) ret.push_back(dir + meta.meta_string("split", k));
+    }
+    return ret;
+  }
+
   Dict combine(const Dict& first, const Dict& second) {
     if (first.empty()) return second;
     if (second.empty()) return first;
@@ -78,7 +175,13 @@ namespace casadi {
     regularity_check_ = false;
     inputs_check_ = true;
     jit_ = false;
+    jit_background_ = false;
     compilerplugin_ = "clang";
+    jit_split_ = 1;
+    jit_batch_ = 0;
+    jit_cache_ = false;
+    jit_cache_folder_ = "casadi_jit_cache";
+    jit_cache_size_ = 1000000000;
     print_time_ = true;
     eval_ = nullptr;
     has_refcount_ = false;
@@ -86,6 +189,7 @@ namespace casadi {
     enable_reverse_ = true;
     enable_jacobian_ = true;
     enable_fd_ = false;
+    bicoloring_ = false;
     sz_arg_tmp_ = 0;
     sz_res_tmp_ = 0;
     sz_iw_tmp_ = 0;
@@ -104,6 +208,10 @@ namespace casadi {
   }
 
   FunctionInternal::~FunctionInternal() {
+#ifdef CASADI_WITH_THREAD
+    // Wait for background compilation to finish, the thread only accesses jit_bg_
+    if (jit_thread_.joinable()) jit_thread_.join();
+#endif // CASADI_WITH_THREAD
   }
 
   void ProtoFunction::construct(const Dict& opts) {
@@ -196,6 +304,34 @@ namespace casadi {
       {"jit_options",
        {OT_DICT,
         "Options to be passed to the jit compiler."}},
+      {"jit_background",
+       {OT_BOOL,
+        "Tiered execution: compile in a background thread and evaluate without the "
+        "compiled code until it is ready, then switch to it. "
+        "Requires CasADi to be compiled with WITH_THREAD. Without it, the option "
+        "has no effect apart from a warning and the compilation is synchronous."}},
+      {"jit_split",
+       {OT_INT,
+        "Number of source files to divide the JIT generated code into. "
+        "Large SX function bodies are divided as well. The files are compiled "
+        "in parallel by compiler plugins that support it, e.g. 'shell' [1]"}},
+      {"jit_batch",
+       {OT_INT,
+        "Also generate and compile a batched variant evaluating this many instances, "
+        "returned by Function::batch"}},
+      {"jit_cache",
+       {OT_BOOL,
+        "Keep JIT compiled shared libraries in an on-disk cache, keyed by a hash of "
+        "the generated source, the compiler plugin and its options and the CasADi version. "
+        "On a hit, the cached library is loaded without compiling. "
+        "Requires a compiler plugin that produces a shared library, e.g. 'shell'."}},
+      {"jit_cache_folder",
+       {OT_STRING,
+        "Folder of the JIT cache [casadi_jit_cache]"}},
+      {"jit_cache_size",
+       {OT_INT,
+        "Maximum total size in bytes of the JIT cache. The least recently used "
+        "libraries are removed when exceeded [1e9]"}},
       {"derivative_of",
        {OT_FUNCTION,
         "The function is a derivative of another function. "
@@ -231,7 +367,19 @@ namespace casadi {
         "Options to be passed to the finite difference instance"}},
       {"fd_method",
        {OT_STRING,
-        "Method for finite differencing [default 'central']"}}
+        "Method for finite differencing [default 'central']"}},
+      {"coloring",
+       {OT_STRING,
+        "Vertex ordering for the graph coloring of Jacobian and Hessian sparsity patterns: "
+        "natural|largest_first|smallest_last|incidence_degree|dynamic_largest_first|best. "
+        "The value 'best' tries all orderings and keeps the one with the fewest colors. "
+        "Coloring statistics are reported in the stats of the Jacobian function. "
+        "[default: largest_first for Hessians, natural otherwise]"}},
+      {"bicoloring",
+       {OT_BOOL,
+        "Also consider bidirectional partitions of Jacobians, where rows with many "
+        "nonzeros are calculated with reverse mode and the remaining rows with "
+        "forward mode directional derivatives [default: false]"}}
      }
   };
 
@@ -273,6 +421,18 @@ namespace casadi {
         compilerplugin_ = op.second.to_string();
       } else if (op.first=="jit_options") {
         jit_options_ = op.second;
+      } else if (op.first=="jit_background") {
+        jit_background_ = op.second;
+      } else if (op.first=="jit_split") {
+        jit_split_ = op.second;
+      } else if (op.first=="jit_batch") {
+        jit_batch_ = op.second;
+      } else if (op.first=="jit_cache") {
+        jit_cache_ = op.second;
+      } else if (op.first=="jit_cache_folder") {
+        jit_cache_folder_ = op.second.to_string();
+      } else if (op.first=="jit_cache_size") {
+        jit_cache_size_ = op.second;
       } else if (op.first=="derivative_of") {
         derivative_of_ = op.second;
       } else if (op.first=="ad_weight") {
@@ -295,9 +455,22 @@ namespace casadi {
         fd_options_ = op.second;
       } else if (op.first=="fd_method") {
         fd_method_ = op.second.to_string();
+      } else if (op.first=="coloring") {
+        coloring_ = op.second.to_string();
+        // Check validity
+        coloring_ordering(coloring_, false);
+      } else if (op.first=="bicoloring") {
+        bicoloring_ = op.second;
       }
     }
 
+#ifndef CASADI_WITH_THREAD
+    if (jit_ && jit_background_) {
+      casadi_warning("Option 'jit_background' requires CasADi to be compiled with "
+                     "WITH_THREAD. Compiling '" + name_ + "' synchronously.");
+    }
+#endif // CASADI_WITH_THREAD
+
     // Verbose?
     if (verbose_) casadi_message(name_ + "::init");
 
@@ -378,10 +551,31 @@ namespace casadi {
       if (has_codegen()) {
         if (verbose_) casadi_message("Codegenerating function '" + name_ + "'.");
         // JIT everything
-        CodeGenerator gen(jit_name);
+        Dict jit_gen_opts;
+        if (jit_split_>1) jit_gen_opts["split"] = jit_split_;
+        if (jit_batch_>0) jit_gen_opts["batch"] = jit_batch_;
+        CodeGenerator gen(jit_name, jit_gen_opts);
         gen.add(self());
+#ifdef CASADI_WITH_THREAD
+        if (jit_background_) {
+          // Unique source file, the default name could be overwritten before it is compiled
+          string prefix = temporary_file("tmp_casadi_jit", "");
+          string src = gen.generate(prefix + "_");
+          if (verbose_) casadi_message("Compiling function '" + name_ + "' in the background");
+          // Load the plugin before branching off, the plugin registry is shared
+          ImporterInternal::getPlugin(compilerplugin_);
+          // The thread works on a copy of everything it needs
+          jit_bg_.settings = jit_settings();
+          jit_bg_.settings.options = JitBackground::deep_copy(jit_options_);
+          jit_bg_.name = name_;
+          jit_bg_.prefix = prefix;
+          jit_bg_.src = src;
+          jit_thread_ = std::thread(JitBackground::run, &jit_bg_);
+          return ProtoFunction::finalize(opts);
+        }
+#endif // CASADI_WITH_THREAD
         if (verbose_) casadi_message("Compiling function '" + name_ + "'..");
-        compiler_ = Importer(gen.generate(), compilerplugin_, jit_options_);
+        compiler_ = jit_settings().compile(gen.generate(), stats_);
         if (verbose_) casadi_message("Compiling function '" + name_ + "' done.");
         // Try to load
         eval_ = (eval_t)compiler_.get_function(name_);
@@ -395,6 +589,130 @@ namespace casadi {
     ProtoFunction::finalize(opts);
   }
 
+#ifdef CASADI_WITH_THREAD
+  void JitBackground::run(JitBackground* s) {
+    try {
+      Dict stats;
+      Importer compiler = s->settings.compile(s->src, stats);
+      eval_t f = (eval_t)compiler.get_function(s->name);
+      if (f==nullptr) {
+        casadi_warning("Cannot load JIT'ed function '" + s->name + "'");
+      } else {
+        {
+          // Hand over without leaving references behind, the counts are not atomic
+          std::lock_guard<std::mutex> lock(s->mtx);
+          s->compiler = compiler;
+          compiler = Importer();
+          s->stats = std::move(stats);
+          stats.clear();
+        }
+        s->eval.store(f, std::memory_order_release);
+        if (s->settings.verbose) casadi_message("Compiling function '" + s->name + "' done.");
+      }
+    } catch (exception& e) {
+      casadi_warning("Background compilation of '" + s->name + "' failed: "
+                     + string(e.what()));
+    }
+    for (auto&& e : jit_sources(s->src)) remove(e.c_str());
+    remove(s->prefix.c_str());
+  }
+
+  Dict JitBackground::deep_copy(const Dict& d) {
+    Dict ret;
+    for (auto&& e : d) {
+      const GenericType& v = e.second;
+      switch (v.getType()) {
+        case OT_BOOL: ret[e.first] = v.to_bool(); break;
+        case OT_INT: ret[e.first] = v.to_int(); break;
+        case OT_DOUBLE: ret[e.first] = v.to_double(); break;
+        case OT_STRING: ret[e.first] = v.to_string(); break;
+        case OT_INTVECTOR: ret[e.first] = v.to_int_vector(); break;
+        case OT_INTVECTORVECTOR: ret[e.first] = v.to_int_vector_vector(); break;
+        case OT_BOOLVECTOR: ret[e.first] = v.to_bool_vector(); break;
+        case OT_DOUBLEVECTOR: ret[e.first] = v.to_double_vector(); break;
+        case OT_DOUBLEVECTORVECTOR: ret[e.first] = v.to_double_vector_vector(); break;
+        case OT_STRINGVECTOR: ret[e.first] = v.to_string_vector(); break;
+        case OT_DICT: ret[e.first] = deep_copy(v.as_dict()); break;
+        default:
+          casadi_error("Compiler option '" + e.first + "' of type " + v.get_description()
+                       + " cannot be passed to a background compilation");
+      }
+    }
+    return ret;
+  }
+#endif // CASADI_WITH_THREAD
+
+  JitSettings FunctionInternal::jit_settings() const {
+    JitSettings s;
+    s.plugin = compilerplugin_;
+    s.options = jit_options_;
+    s.cache = jit_cache_;
+    s.cache_folder = jit_cache_folder_;
+    s.cache_size = jit_cache_size_;
+    s.verbose = verbose_;
+    return s;
+  }
+
+  Importer FunctionInternal::jit_compiler() const {
+#ifdef CASADI_WITH_THREAD
+    if (jit_background_) {
+      std::lock_guard<std::mutex> lock(jit_bg_.mtx);
+      return jit_bg_.compiler;
+    }
+#endif // CASADI_WITH_THREAD
+    return compiler_;
+  }
+
+  std::string JitSettings::cache_key(const std::string& src) const {
+    // Hashed content
+    stringstream ss;
+    for (auto&& s : jit_sources(src)) {
+      ifstream file(s, ios::binary);
+      casadi_assert(file.good(), "Cannot open generated source " + s);
+      ss << file.rdbuf() << '\n';
+    }
+    ss << plugin << '\n' << str(options) << '\n' << CasadiMeta::version();
+    // 64-bit FNV-1a hash, stable across runs and platforms
+    uint64_t h = 14695981039346656037ull;
+    for (unsigned char c : ss.str()) {
+      h ^= c;
+      h *= 1099511628211ull;
+    }
+    stringstream key;
+    key << hex << setw(16) << setfill('0') << h;
+    return key.str();
+  }
+
+  Importer JitSettings::compile(const std::string& src, Dict& stats) const {
+    if (!cache) return Importer(src, plugin, options);
+
+    // Location in the cache
+    string key = cache_key(src);
+    string bin = cache_folder + "/" + key + SHARED_LIBRARY_SUFFIX;
+    stats["jit_cache_key"] = key;
+
+    // Hit: load the cached shared library directly
+    if (ifstream(bin).good()) {
+      if (verbose) casadi_message("JIT cache hit: " + bin);
+      stats["jit_cache_hit"] = true;
+      jit_cache_touch(bin);
+      return Importer(bin, "dll");
+    }
+
+    // Miss: compile and store a copy of the shared library
+    if (verbose) casadi_message("JIT cache miss: " + bin);
+    stats["jit_cache_hit"] = false;
+    Importer compiler(src, plugin, options);
+    string lib = compiler->library();
+    if (lib.empty()) {
+      casadi_warning("JIT cache: compiler plugin '" + plugin + "' does not "
+                     "produce a shared library, nothing cached");
+      return compiler;
+    }
+    jit_cache_store(lib, bin, cache_folder, cache_size);
+    return compiler;
+  }
+
   void ProtoFunction::finalize(const Dict& opts) {
     // Create memory object
     casadi_int mem = checkout();
@@ -405,9 +723,13 @@ namespace casadi {
   eval_gen(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const {
     if (eval_) {
       return eval_(arg, res, iw, w, mem);
-    } else {
-      return eval(arg, res, iw, w, mem);
     }
+#ifdef CASADI_WITH_THREAD
+    // Switch to the code compiled in the background once it is ready
+    eval_t jit_eval = jit_bg_.eval.load(std::memory_order_acquire);
+    if (jit_eval) return jit_eval(arg, res, iw, w, mem);
+#endif // CASADI_WITH_THREAD
+    return eval(arg, res, iw, w, mem);
   }
 
   void FunctionInternal::print_dimensions(ostream &stream) const {
@@ -504,6 +826,28 @@ namespace casadi {
     return f;
   }
 
+  Function FunctionInternal::batch(casadi_int n) const {
+    string fname = "batch" + str(n) + "_" + name_;
+    // Entry point in the JIT compiled code
+    if (jit_ && jit_batch_==n) {
+      bool ready = eval_!=nullptr;
+#ifdef CASADI_WITH_THREAD
+      ready = ready || jit_bg_.eval.load(std::memory_order_acquire)!=nullptr;
+#endif // CASADI_WITH_THREAD
+      if (ready) return external(fname, jit_compiler());
+    }
+    Function f;
+    if (!incache(fname, f)) {
+      if (has_batch(n)) {
+        f = get_batch(n, fname);
+      } else {
+        f = Batch::create(self(), n);
+      }
+      tocache(f);
+    }
+    return f;
+  }
+
   Function FunctionInternal::wrap() const {
     Function f;
     string fname = "wrap_" + name_;
@@ -1317,7 +1661,8 @@ namespace casadi {
 
   void FunctionInternal::get_partition(casadi_int iind, casadi_int oind, Sparsity& D1, Sparsity& D2,
                                        bool compact, bool symmetric,
-                                       bool allow_forward, bool allow_reverse) const {
+                                       bool allow_forward, bool allow_reverse,
+                                       Dict* stats) const {
     if (verbose_) casadi_message(name_ + "::get_partition");
     casadi_assert(allow_forward || allow_reverse, "Inconsistent options");
 
@@ -1325,6 +1670,10 @@ namespace casadi {
     Sparsity &AT = sparsity_jac(iind, oind, compact, symmetric);
     Sparsity A = symmetric ? AT : AT.T();
 
+    // Time the coloring
+    FStats coloring_stats;
+    coloring_stats.tic();
+
     // Get seed matrices by graph coloring
     if (symmetric) {
       casadi_assert_dev(enable_forward_ || enable_fd_);
@@ -1332,7 +1681,7 @@ namespace casadi {
 
       // Star coloring if symmetric
       if (verbose_) casadi_message("FunctionInternal::getPartition star_coloring");
-      D1 = A.star_coloring();
+      D1 = A.star_coloring(coloring_ordering(coloring_, true));
       if (verbose_) {
         casadi_message("Star coloring completed: " + str(D1.size2())
           + " directional derivatives needed ("
@@ -1341,9 +1690,10 @@ namespace casadi {
 
     } else {
       casadi_assert_dev(enable_forward_ || enable_fd_ || enable_reverse_);
+      casadi_int ordering = coloring_ordering(coloring_, false);
+
       // Get weighting factor
       double w = ad_weight();
-
       // Which AD mode?
       if (w==1) allow_forward = false;
       if (w==0) allow_reverse = false;
@@ -1372,7 +1722,7 @@ namespace casadi {
           bool d = best_coloring>=w*static_cast<double>(A.size1());
           casadi_int max_colorings_to_test =
             d ? A.size1() : static_cast<casadi_int>(floor(best_coloring/w));
-          D1 = AT.uni_coloring(A, max_colorings_to_test);
+          D1 = AT.uni_coloring(A, max_colorings_to_test, ordering);
           if (D1.is_null()) {
             if (verbose_) {
               casadi_message("Forward mode coloring interrupted (more than "
@@ -1393,7 +1743,7 @@ namespace casadi {
           casadi_int max_colorings_to_test =
             d ? A.size2() : static_cast<casadi_int>(floor(best_coloring/(1-w)));
 
-          D2 = A.uni_coloring(AT, max_colorings_to_test);
+          D2 = A.uni_coloring(AT, max_colorings_to_test, ordering);
           if (D2.is_null()) {
             if (verbose_) {
               casadi_message("Adjoint mode coloring interrupted (more than "
@@ -1411,9 +1761,61 @@ namespace casadi {
         }
       }
 
+      // Try to improve with a bidirectional partition
+      if (bicoloring_ && allow_forward && allow_reverse) {
+        if (verbose_) casadi_message("Bidirectional coloring");
+        Sparsity D1_bi, D2_bi;
+        AT.bi_coloring(D1_bi, D2_bi, w, best_coloring, ordering);
+        if (D1_bi.is_null()) {
+          if (verbose_) casadi_message("Bidirectional coloring gave no improvement");
+        } else {
+          if (verbose_) {
+            casadi_message("Bidirectional coloring completed: "
+                           + str(D1_bi.size2()) + " forward and "
+                           + str(D2_bi.size2()) + " adjoint directional derivatives needed.");
+          }
+          D1 = D1_bi;
+          D2 = D2_bi;
+        }
+      }
+
+    }
+    coloring_stats.toc();
+
+    // Coloring statistics, if requested
+    if (stats) {
+      casadi_int n_fwd = D1.is_null() ? 0 : D1.size2();
+      casadi_int n_adj = D2.is_null() ? 0 : D2.size2();
+      (*stats)["coloring_n_fwd"] = n_fwd;
+      (*stats)["coloring_n_adj"] = n_adj;
+      // The bound only holds for unidirectional partitions
+      if (n_fwd==0 || n_adj==0) {
+        (*stats)["coloring_lower_bound"] = (n_adj>0 ? A : AT).coloring_lower_bound(symmetric);
+      }
+      (*stats)["coloring_t_wall"] = coloring_stats.t_wall;
+      (*stats)["coloring_t_proc"] = coloring_stats.t_proc;
     }
   }
 
+  casadi_int FunctionInternal::coloring_ordering(const std::string& s, bool symmetric) {
+    if (s.empty()) {
+      return symmetric ? 1 : 0;
+    } else if (s=="natural") {
+      return 0;
+    } else if (s=="largest_first") {
+      return 1;
+    } else if (s=="smallest_last") {
+      return 2;
+    } else if (s=="incidence_degree") {
+      return 3;
+    } else if (s=="dynamic_largest_first") {
+      return 4;
+    } else if (s=="best") {
+      return -1;
+    }
+    casadi_error("Unknown coloring ordering '" + s + "'");
+  }
+
   std::vector<DM> FunctionInternal::eval_dm(const std::vector<DM>& arg) const {
     casadi_error("'eval', 'eval_dm' not defined for " + class_name());
   }
@@ -1541,6 +1943,10 @@ namespace casadi {
     casadi_error("'get_reverse' not defined for " + class_name());
   }
 
+  Function FunctionInternal::get_batch(casadi_int n, const std::string& name) const {
+    casadi_error("'get_batch' not defined for " + class_name());
+  }
+
   void FunctionInternal::export_code(const std::string& lang, std::ostream &stream,
       const Dict& options) const {
     casadi_error("'export_code' not defined for " + class_name());
@@ -1762,7 +2168,9 @@ namespace casadi {
   void FunctionInternal::codegen(CodeGenerator& g, const std::string& fname) const {
     // Define function
     g << "/* " << definition() << " */\n";
-    g << "static " << signature(fname) << " {\n";
+    // Visible to the other source files, but not exported, if the definitions are divided
+    g << (g.split==1 ? "static " : "CASADI_SHARED ");
+    g << signature(fname) << " {\n";
 
     // Reset local variables, flush buffer
     g.flush(g.body);
@@ -1772,23 +2180,8 @@ namespace casadi {
     // Generate function body (to buffer)
     codegen_body(g);
 
-    // Order local variables
-    std::map<string, set<pair<string, string>>> local_variables_by_type;
-    for (auto&& e : g.local_variables_) {
-      local_variables_by_type[e.second.first].insert(make_pair(e.first, e.second.second));
-    }
-
-    // Codegen local variables
-    for (auto&& e : local_variables_by_type) {
-      g.body << "  " << e.first;
-      for (auto it=e.second.begin(); it!=e.second.end(); ++it) {
-        g.body << (it==e.second.begin() ? " " : ", ") << it->second << it->first;
-        // Insert definition, if any
-        auto k=g.local_default_.find(it->first);
-        if (k!=g.local_default_.end()) g.body << "=" << k->second;
-      }
-      g.body << ";\n";
-    }
+    // Local variables, stack frame for the memory report
+    g.frame_size_[fname] += g.print_locals(g.body);
 
     // Finalize the function
     g << "return 0;\n";
@@ -1844,8 +2237,7 @@ namespace casadi {
     codegen_sparsities(g);
 
     // Determine work vector size
-    casadi_int sz_w_codegen = sz_w();
-    if (is_a("SXFunction", true) && !g.avoid_stack()) sz_w_codegen = 0;
+    casadi_int sz_w_codegen = codegen_sz_w(g);
 
     // Function that returns work vector lengths
     g << g.declare(
@@ -1859,6 +2251,36 @@ namespace casadi {
       << "return 0;\n"
       << "}\n\n";
 
+    // Entry point using statically allocated memory
+    if (g.static_memory) {
+      g.static_memory_.push_back({name_, codegen_name(g), sz_arg(), sz_res(), sz_iw(),
+                                  static_cast<size_t>(sz_w_codegen)});
+      stringstream def;
+      def << "#define " << name_ << "_SZ_ARG " << sz_arg() << "\n"
+          << "#define " << name_ << "_SZ_RES " << sz_res() << "\n"
+          << "#define " << name_ << "_SZ_IW " << sz_iw() << "\n"
+          << "#define " << name_ << "_SZ_W " << sz_w_codegen << "\n"
+          << "#define " << name_ << "_SZ_MEM (" << name_ << "_SZ_ARG*sizeof(const casadi_real*)+"
+          << name_ << "_SZ_RES*sizeof(casadi_real*)+" << name_ << "_SZ_IW*sizeof(casadi_int)+"
+          << name_ << "_SZ_W*sizeof(casadi_real))\n";
+      g << def.str();
+      if (g.with_header) g.header << def.str();
+      g << "static struct {\n"
+        << "const casadi_real* arg[" << max(sz_arg(), size_t(1)) << "];\n"
+        << "casadi_real* res[" << max(sz_res(), size_t(1)) << "];\n"
+        << "casadi_int iw[" << max(sz_iw(), size_t(1)) << "];\n"
+        << "casadi_real w[" << max(static_cast<size_t>(sz_w_codegen), size_t(1)) << "];\n"
+        << "} " << name_ << "_mem;\n\n";
+      g << g.declare("int " + name_ + "_static(const casadi_real** arg, casadi_real** res)")
+        << " {\n"
+        << "casadi_int i;\n"
+        << "for (i=0; i<" << n_in_ << "; ++i) " << name_ << "_mem.arg[i] = arg[i];\n"
+        << "for (i=0; i<" << n_out_ << "; ++i) " << name_ << "_mem.res[i] = res[i];\n"
+        << "return " << name_ << "(" << name_ << "_mem.arg, " << name_ << "_mem.res, "
+        << name_ << "_mem.iw, " << name_ << "_mem.w, 0);\n"
+        << "}\n\n";
+    }
+
     // Generate mex gateway for the function
     if (g.mex) {
       // Begin conditional compilation
@@ -2027,6 +2449,10 @@ namespace casadi {
     g << "#error Code generation not supported for " << class_name() << "\n";
   }
 
+  void FunctionInternal::codegen_batch(CodeGenerator& g, casadi_int n) const {
+    casadi_error("'codegen_batch' not defined for " + class_name());
+  }
+
   std::string FunctionInternal::
   generate_dependencies(const std::string& fname, const Dict& opts) const {
     casadi_error("'generate_dependencies' not defined for " + class_name());
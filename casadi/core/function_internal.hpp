@@ -37,9 +37,12 @@
 #ifdef CASADI_WITH_THREAD
 #ifdef CASADI_WITH_THREAD_MINGW
 #include <mingw.mutex.h>
+#include <mingw.thread.h>
 #else // CASADI_WITH_THREAD_MINGW
 #include <mutex>
+#include <thread>
 #endif // CASADI_WITH_THREAD_MINGW
+#include <atomic>
 #endif //CASADI_WITH_THREAD
 
 // This macro is for documentation purposes
@@ -63,6 +66,63 @@ namespace casadi {
   /// Combine two dictionaries, giving priority to first one
   Dict CASADI_EXPORT combine(const Dict& first, const Dict& second);
 
+  /** \brief Settings of a JIT compilation
+
+      A copy is handed to background compilations, which then never access
+      the Function being compiled.
+  */
+  struct CASADI_EXPORT JitSettings {
+    /// Compiler plugin and its options
+    std::string plugin;
+    Dict options;
+
+    /// On-disk cache of JIT compiled shared libraries
+    bool cache;
+    std::string cache_folder;
+    casadi_int cache_size;
+
+    /// Print progress
+    bool verbose;
+
+    /// Key of the JIT cache: hash of the generated source, compiler and CasADi version
+    std::string cache_key(const std::string& src) const;
+
+    /// Compile, or load from the JIT cache
+    Importer compile(const std::string& src, Dict& stats) const;
+  };
+
+#ifdef CASADI_WITH_THREAD
+  /** \brief State of a background JIT compilation
+
+      Owned by the Function, which joins the compile thread before the state is
+      destroyed. The compile thread only accesses this object.
+  */
+  struct CASADI_EXPORT JitBackground {
+    /// Inputs of the compilation
+    JitSettings settings;
+    std::string name, prefix, src;
+
+    /// Entry point of the compiled code, set once ready
+    std::atomic<eval_t> eval;
+
+    /// Guards compiler and stats
+    mutable std::mutex mtx;
+
+    /// Compiled code and statistics of the compilation
+    Importer compiler;
+    Dict stats;
+
+    /// Constructor
+    JitBackground() : eval(nullptr) {}
+
+    /// Compile, the entry point of the compile thread
+    static void run(JitBackground* s);
+
+    /// Copy of options that shares no reference counted objects with the original
+    static Dict deep_copy(const Dict& d);
+  };
+#endif // CASADI_WITH_THREAD
+
   /** \brief Base class for FunctionInternal and LinsolInternal
     \author Joel Andersson
     \date 2017
@@ -461,12 +521,21 @@ namespace casadi {
     /** \brief Generate code for the function body */
     virtual void codegen_body(CodeGenerator& g) const;
 
+    /** \brief Length of the work vector used by the generated code */
+    virtual size_t codegen_sz_w(const CodeGenerator& g) const { return sz_w();}
+
     /** \brief Export / Generate C code for the dependency function */
     virtual std::string generate_dependencies(const std::string& fname, const Dict& opts) const;
 
     /** \brief Is codegen supported? */
     virtual bool has_codegen() const { return false;}
 
+    /** \brief Can code be generated for several instances side by side? */
+    virtual bool has_codegen_batch() const { return false;}
+
+    /** \brief Generate code for \a n instances stored as a structure of arrays */
+    virtual void codegen_batch(CodeGenerator& g, casadi_int n) const;
+
     /** \brief Jit dependencies */
     virtual void jit_dependencies(const std::string& fname) {}
 
@@ -514,10 +583,16 @@ namespace casadi {
     /** \brief Print free variables */
     virtual std::vector<std::string> get_free() const;
 
-    /** \brief Get the unidirectional or bidirectional partition */
+    /** \brief Get the unidirectional or bidirectional partition
+
+        Coloring statistics are written to \a stats, if not null.
+    */
     void get_partition(casadi_int iind, casadi_int oind, Sparsity& D1, Sparsity& D2,
                       bool compact, bool symmetric,
-                      bool allow_forward, bool allow_reverse) const;
+                      bool allow_forward, bool allow_reverse, Dict* stats=nullptr) const;
+
+    /** \brief Ordering option passed to the coloring algorithms */
+    static casadi_int coloring_ordering(const std::string& s, bool symmetric);
 
     ///@{
     /** \brief Number of input/output nonzeros */
@@ -708,6 +783,16 @@ namespace casadi {
     /** \brief Generate/retrieve cached serial map */
     Function map(casadi_int n, const std::string& parallelization) const;
 
+    ///@{
+    /** \brief Generate/retrieve cached batch evaluation
+     *    batch(n) calls <tt>Function get_batch(casadi_int n)</tt> if the class
+     *    has a specialized batch evaluation, otherwise a generic one is created.
+     */
+    Function batch(casadi_int n) const;
+    virtual bool has_batch(casadi_int n) const { return false;}
+    virtual Function get_batch(casadi_int n, const std::string& name) const;
+    ///@}
+
     /// Number of inputs and outputs
     size_t n_in_, n_out_;
 
@@ -720,10 +805,23 @@ namespace casadi {
     /** \brief  Use just-in-time compiler */
     bool jit_;
 
+    /** \brief Compile in a background thread, evaluate without the compiled code until done */
+    bool jit_background_;
+
+#ifdef CASADI_WITH_THREAD
+    /// Background JIT compilation, jit_thread_ only accesses jit_bg_
+    JitBackground jit_bg_;
+    std::thread jit_thread_;
+#endif // CASADI_WITH_THREAD
+
     /** \brief Numerical evaluation redirected to a C function */
     eval_t eval_;
 
-    /** \brief Dict of statistics (resulting from evaluate) */
+    /** \brief Statistics not associated with a memory object, set at construction
+
+        E.g. the coloring statistics of a Jacobian function. Only written before the
+        Function is handed out, so never modified concurrently with evaluation.
+    */
     Dict stats_;
 
     /** \brief Reference counting in codegen? */
@@ -749,6 +847,23 @@ namespace casadi {
     Importer compiler_;
     Dict jit_options_;
 
+    /// Number of source files for JIT generated code
+    casadi_int jit_split_;
+
+    /// Number of instances in the batch variant of the JIT generated code
+    casadi_int jit_batch_;
+
+    /// On-disk cache of JIT compiled shared libraries
+    bool jit_cache_;
+    std::string jit_cache_folder_;
+    casadi_int jit_cache_size_;
+
+    /// Settings of the JIT compilation
+    JitSettings jit_settings() const;
+
+    /// Compiled code, if any, also when compiled in the background
+    Importer jit_compiler() const;
+
     /// Penalty factor for using a complete Jacobian to calculate directional derivatives
     double jac_penalty_;
 
@@ -758,6 +873,12 @@ namespace casadi {
     /// Weighting factor for derivative calculation and sparsity pattern calculation
     double ad_weight_, ad_weight_sp_;
 
+    /// Ordering for the graph coloring, empty for default
+    std::string coloring_;
+
+    /// Consider bidirectional partitions for Jacobians
+    bool bicoloring_;
+
     /// Maximum number of sensitivity directions
     casadi_int max_num_dir_;
 
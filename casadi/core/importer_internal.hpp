@@ -92,6 +92,9 @@ namespace casadi {
     /// Get a function pointer for numerical evaluation
     virtual signal_t get_function(const std::string& symname) { return nullptr;}
 
+    /// Shared library holding the compiled code, if any
+    virtual std::string library() const { return "";}
+
     /// Get a function pointer for numerical evaluation
     bool has_function(const std::string& symname) const;
 
@@ -167,6 +170,9 @@ namespace casadi {
     // Dummy type
     signal_t get_function(const std::string& symname) override;
 
+    /// Shared library
+    std::string library() const override { return name_;}
+
     /// Can meta information be read?
     bool can_have_meta() const override { return false;}
   };
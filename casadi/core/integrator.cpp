@@ -116,6 +116,8 @@ namespace casadi {
     print_stats_ = false;
     output_t0_ = false;
     print_time_ = false;
+    batch_group_ = 0;
+    nev_ = 0;
   }
 
   Integrator::~Integrator() {
@@ -176,6 +178,11 @@ namespace casadi {
     // Setup memory object
     setup(m, arg, res, iw, w);
 
+    // Clear the events of previous calls
+    m->event_t.clear();
+    m->event_i.clear();
+    m->event_x.clear();
+
     // Reset solver, take time to t0
     reset(m, grid_.front(), x0, z0, p);
 
@@ -229,7 +236,15 @@ namespace casadi {
         "Options to be passed down to the augmented integrator, if one is constructed."}},
       {"output_t0",
        {OT_BOOL,
-        "Output the state at the initial time"}}
+        "Output the state at the initial time"}},
+      {"batch_group",
+       {OT_INT,
+        "Number of trajectories that are integrated together, sharing the step size "
+        "control, by the function returned by Function::batch [0: all]"}},
+      {"event",
+       {OT_FUNCTION,
+        "Event functions e(t, x, z, p), whose zero crossings are located on the "
+        "dense output of the integrator and reported in the statistics"}}
      }
   };
 
@@ -250,6 +265,10 @@ namespace casadi {
         grid_ = op.second;
       } else if (op.first=="augmented_options") {
         augmented_options_ = op.second;
+      } else if (op.first=="batch_group") {
+        batch_group_ = op.second;
+      } else if (op.first=="event") {
+        event_ = op.second;
       } else if (op.first=="t0") {
         t0 = op.second;
       } else if (op.first=="tf") {
@@ -257,6 +276,8 @@ namespace casadi {
       }
     }
 
+    casadi_assert(batch_group_>=0, "Option 'batch_group' must be nonnegative");
+
     // Replace MX oracle with SX oracle?
     if (expand) this->expand();
 
@@ -322,6 +343,23 @@ namespace casadi {
                             + str(nrx_+nrz_));
     }
 
+    // Event functions
+    if (!event_.is_null()) {
+      casadi_assert(has_events(),
+        "Event detection not supported by '" + string(plugin_name()) + "'");
+      casadi_assert(event_.n_in()==4 && event_.n_out()==1,
+        "Event function must have the inputs (t, x, z, p) and a single output");
+      casadi_assert(event_.nnz_in(0)==1 && event_.nnz_in(1)==nx_
+        && event_.nnz_in(2)==nz_ && event_.nnz_in(3)==np_,
+        "Event function inputs (t, x, z, p) do not match the DAE");
+      casadi_assert(event_.sparsity_out(0).is_dense(), "Event function output must be dense");
+      nev_ = event_.nnz_out(0);
+      set_function(event_, "event");
+
+      // The event functions are not passed on to augmented integrators
+      opts_.erase("event");
+    }
+
     // Consistency check
 
     // Allocate sufficiently large work vectors
@@ -338,6 +376,35 @@ namespace casadi {
     return 0;
   }
 
+  Dict Integrator::get_stats(void* mem) const {
+    Dict stats = OracleFunction::get_stats(mem);
+    auto m = static_cast<IntegratorMemory*>(mem);
+
+    // Detected events, in chronological order
+    if (!event_.is_null()) {
+      stats["event_time"] = m->event_t;
+      stats["event_index"] = m->event_i;
+      stats["event_x"] = m->event_x;
+    }
+    return stats;
+  }
+
+  void Integrator::eval_event(IntegratorMemory* m, double t, const double* x, const double* z,
+                              const double* p, double* e) const {
+    m->arg[0] = &t;
+    m->arg[1] = x;
+    m->arg[2] = z;
+    m->arg[3] = p;
+    m->res[0] = e;
+    if (calc_function(m, "event")) casadi_error("'event' calculation failed");
+  }
+
+  void Integrator::add_event(IntegratorMemory* m, double t, casadi_int i, const double* x) const {
+    m->event_t.push_back(t);
+    m->event_i.push_back(i);
+    m->event_x.push_back(vector<double>(x, x+nx_));
+  }
+
   template<typename MatType>
   std::map<string, MatType> Integrator::aug_fwd(casadi_int nfwd) const {
     if (verbose_) casadi_message(name_ + "::aug_fwd");
@@ -503,6 +570,43 @@ namespace casadi {
     return ret;
   }
 
+  template<typename MatType>
+  std::map<string, MatType> Integrator::aug_batch(casadi_int n) const {
+    if (verbose_) casadi_message(name_ + "::aug_batch");
+
+    // Symbolic inputs, the trajectories share the time
+    vector<MatType> arg(DE_NUM_IN), arg_map(DE_NUM_IN);
+    for (casadi_int i=0; i<DE_NUM_IN; ++i) {
+      if (i==DE_T) {
+        arg[i] = MatType::sym(oracle_.name_in(i), t());
+        arg_map[i] = repmat(arg[i], 1, n);
+      } else {
+        arg[i] = MatType::sym(oracle_.name_in(i), oracle_.nnz_in(i)*n);
+        arg_map[i] = reshape(arg[i], oracle_.size1_in(i), oracle_.size2_in(i)*n);
+      }
+    }
+
+    // Evaluate the DAE for all trajectories
+    vector<MatType> res = oracle_.map(n)(arg_map);
+
+    // Construct return object
+    std::map<string, MatType> ret;
+    ret["t"] = arg[DE_T];
+    ret["x"] = arg[DE_X];
+    ret["z"] = arg[DE_Z];
+    ret["p"] = arg[DE_P];
+    ret["rx"] = arg[DE_RX];
+    ret["rz"] = arg[DE_RZ];
+    ret["rp"] = arg[DE_RP];
+    ret["ode"] = vec(densify(res[DE_ODE]));
+    ret["alg"] = vec(densify(res[DE_ALG]));
+    ret["quad"] = vec(densify(res[DE_QUAD]));
+    ret["rode"] = vec(densify(res[DE_RODE]));
+    ret["ralg"] = vec(densify(res[DE_RALG]));
+    ret["rquad"] = vec(densify(res[DE_RQUAD]));
+    return ret;
+  }
+
   int Integrator::
   sp_forward(const bvec_t** arg, bvec_t** res, casadi_int* iw, bvec_t* w, void* mem) const {
     if (verbose_) casadi_message(name_ + "::sp_forward");
@@ -971,6 +1075,95 @@ namespace casadi {
     return Function(name, ret_in, ret_out, inames, onames, opts);
   }
 
+  Function Integrator::get_batch(casadi_int n, const std::string& name) const {
+    if (verbose_) casadi_message(name_ + "::get_batch");
+    casadi_assert(n>=1, "Number of instances must be positive");
+    casadi_assert(q().is_dense() && rq().is_dense(),
+      "Batch integration requires dense quadratures");
+
+    // Number of trajectories integrated together
+    casadi_int ng = batch_group_>0 ? std::min(batch_group_, n) : n;
+    casadi_int nfull = n/ng, nrem = n - nfull*ng;
+
+    // Inputs, one row per trajectory
+    vector<MX> ret_in(n_in_);
+    for (casadi_int i=0; i<n_in_; ++i) ret_in[i] = MX::sym(name_in_[i], n, nnz_in(i));
+
+    // Outputs for each group
+    vector<vector<MX>> out(n_out_);
+
+    // Groups of ng trajectories, evaluated with a map
+    Function G = group_integrator(ng).map(nfull);
+    vector<MX> arg(n_in_);
+    for (casadi_int i=0; i<n_in_; ++i) {
+      if (nnz_in(i)==0) {
+        arg[i] = MX(G.size_in(i));
+      } else {
+        arg[i] = horzcat(vertsplit(ret_in[i](Slice(0, nfull*ng), Slice()), ng));
+      }
+    }
+    vector<MX> res = G(arg);
+    for (casadi_int i=0; i<n_out_; ++i) {
+      if (nnz_out(i)==0) {
+        out[i].push_back(MX(nfull*ng, 0));
+      } else {
+        out[i].push_back(vertcat(horzsplit(res[i], nnz_out(i))));
+      }
+    }
+
+    // Remaining trajectories
+    if (nrem>0) {
+      for (casadi_int i=0; i<n_in_; ++i) arg[i] = ret_in[i](Slice(nfull*ng, n), Slice());
+      res = group_integrator(nrem)(arg);
+      for (casadi_int i=0; i<n_out_; ++i) out[i].push_back(res[i]);
+    }
+
+    // Assemble outputs
+    vector<MX> ret_out(n_out_);
+    for (casadi_int i=0; i<n_out_; ++i) ret_out[i] = vertcat(out[i]);
+    return Function(name, ret_in, ret_out, name_in_, name_out_);
+  }
+
+  Function Integrator::group_integrator(casadi_int n) const {
+    // Integrator for the DAE of all trajectories
+    string prefix = "batch" + str(n) + "_";
+    Function dae;
+    if (oracle_.is_a("SXFunction")) {
+      dae = map2oracle(prefix + oracle_.name(), aug_batch<SX>(n));
+    } else {
+      dae = map2oracle(prefix + oracle_.name(), aug_batch<MX>(n));
+    }
+    Function I = integrator(prefix + name_, plugin_name(), dae, opts_);
+
+    // Inputs, one row per trajectory
+    vector<MX> ret_in(n_in_), arg(n_in_);
+    for (casadi_int i=0; i<n_in_; ++i) {
+      ret_in[i] = MX::sym(name_in_[i], n, nnz_in(i));
+      if (nnz_in(i)==0) {
+        arg[i] = MX(I.size_in(i));
+      } else {
+        // Stack the trajectories, column by column
+        vector<MX> c = horzsplit(ret_in[i], nnz_in(i)/I.size2_in(i));
+        for (auto&& e : c) e = vec(e.T());
+        arg[i] = horzcat(c);
+      }
+    }
+
+    // Integrate and split up the trajectories again
+    vector<MX> res = I(arg);
+    vector<MX> ret_out(n_out_);
+    for (casadi_int i=0; i<n_out_; ++i) {
+      if (nnz_out(i)==0) {
+        ret_out[i] = MX(n, 0);
+      } else {
+        vector<MX> c = horzsplit(res[i]);
+        for (auto&& e : c) e = reshape(e, -1, n).T();
+        ret_out[i] = horzcat(c);
+      }
+    }
+    return Function(prefix + "group_" + name_, ret_in, ret_out, name_in_, name_out_);
+  }
+
   Dict Integrator::getDerivativeOptions(bool fwd) const {
     // Copy all options
     return opts_;
@@ -1025,6 +1218,8 @@ namespace casadi {
 
     // Default options
     nk_ = 20;
+    ncp_ = 0;
+    event_tol_ = 1e-12;
   }
 
   FixedStepIntegrator::~FixedStepIntegrator() {
@@ -1035,7 +1230,15 @@ namespace casadi {
   = {{&Integrator::options_},
      {{"number_of_finite_elements",
        {OT_INT,
-        "Number of finite elements"}}
+        "Number of finite elements"}},
+      {"checkpoints",
+       {OT_INT,
+        "Number of forward states kept in memory for the backward integration. "
+        "The remaining states are recomputed from these checkpoints following "
+        "a binomial (Revolve) schedule. Default 0 stores the full trajectory."}},
+      {"event_tol",
+       {OT_DOUBLE,
+        "Tolerance on the times of the located events [1e-12]"}}
      }
   };
 
@@ -1047,11 +1250,19 @@ namespace casadi {
     for (auto&& op : opts) {
       if (op.first=="number_of_finite_elements") {
         nk_ = op.second;
+      } else if (op.first=="checkpoints") {
+        ncp_ = op.second;
+      } else if (op.first=="event_tol") {
+        event_tol_ = op.second;
       }
     }
 
     // Number of finite elements and time steps
     casadi_assert_dev(nk_>0);
+    casadi_assert(ncp_>=0, "Number of checkpoints must be nonnegative");
+
+    // Store the full trajectory if there is room for it
+    if (ncp_>=nk_) ncp_ = 0;
     h_ = static_cast<double>(grid_.back() - grid_.front())/static_cast<double>(nk_);
 
     // Setup discrete time dynamics
@@ -1060,6 +1271,15 @@ namespace casadi {
     // Get discrete time dimensions
     nZ_ = F_.nnz_in(DAE_Z);
     nRZ_ =  G_.is_null() ? 0 : G_.nnz_in(RDAE_RZ);
+
+    // Dense output is needed for events and for points of the time grid inside a step
+    casadi_assert(event_tol_>0, "Event tolerance must be positive");
+    dense_output_ = !event_.is_null();
+    for (double t : grid_) {
+      double k = (t - grid_.front())/h_;
+      if (std::fabs(k - std::round(k))>1e-9) dense_output_ = true;
+    }
+    if (dense_output_) create_function("daeF", {"x", "z", "p", "t"}, {"ode", "quad"});
   }
 
   int FixedStepIntegrator::init_mem(void* mem) const {
@@ -1072,8 +1292,18 @@ namespace casadi {
 
     // Allocate tape if backward states are present
     if (nrx_>0) {
-      m->x_tape.resize(nk_+1, vector<double>(nx_));
-      m->Z_tape.resize(nk_, vector<double>(nZ_));
+      if (ncp_>0) {
+        // Checkpoints with the state and the algebraic variables of the previous step
+        m->tape.resize(ncp_*(nx_+nZ_));
+        m->cp_k.reserve(ncp_);
+        m->x_rec.resize(nx_);
+        m->Z_rec.resize(nZ_);
+        m->x_rec_prev.resize(nx_);
+        m->Z_rec_prev.resize(nZ_);
+      } else {
+        // Full trajectory: all states followed by all algebraic variables
+        m->tape.resize((nk_+1)*nx_ + nk_*nZ_);
+      }
     }
 
     // Allocate state
@@ -1091,6 +1321,18 @@ namespace casadi {
     m->rx_prev.resize(nrx_);
     m->RZ_prev.resize(nRZ_);
     m->rq_prev.resize(nrq_);
+
+    // Dense output and event detection
+    if (dense_output_) {
+      m->x_dense.resize(nx_);
+      m->z_dense.resize(nz_);
+      m->q_dense.resize(nq_);
+      m->xdot_prev.resize(nx_+nq_);
+      m->xdot.resize(nx_+nq_);
+    }
+    m->e_prev.resize(nev_);
+    m->e.resize(nev_);
+    m->e_trial.resize(nev_);
     return 0;
   }
 
@@ -1103,48 +1345,135 @@ namespace casadi {
     k_out = std::min(k_out, nk_); //  make sure that rounding errors does not result in k_out>nk_
     casadi_assert_dev(k_out>=0);
 
-    // Explicit discrete time dynamics
-    const Function& F = getExplicit();
-
-    // Discrete dynamics function inputs ...
-    fill_n(m->arg, F.n_in(), nullptr);
-    m->arg[DAE_T] = &m->t;
-    m->arg[DAE_X] = get_ptr(m->x_prev);
-    m->arg[DAE_Z] = get_ptr(m->Z_prev);
-    m->arg[DAE_P] = get_ptr(m->p);
-
-    // ... and outputs
-    fill_n(m->res, F.n_out(), nullptr);
-    m->res[DAE_ODE] = get_ptr(m->x);
-    m->res[DAE_ALG] = get_ptr(m->Z);
-    m->res[DAE_QUAD] = get_ptr(m->q);
-
     // Take time steps until end time has been reached
     while (m->k<k_out) {
+      // Checkpoint
+      if (nrx_>0 && ncp_>0 && m->k==m->cp_next) {
+        checkpoint(m, m->k, get_ptr(m->x), get_ptr(m->Z));
+        m->cp_next = checkpoint_split(m->k, nk_, ncp_ - static_cast<casadi_int>(m->cp_k.size()));
+      }
+
       // Update the previous step
       casadi_copy(get_ptr(m->x), nx_, get_ptr(m->x_prev));
       casadi_copy(get_ptr(m->Z), nZ_, get_ptr(m->Z_prev));
       casadi_copy(get_ptr(m->q), nq_, get_ptr(m->q_prev));
 
       // Take step
-      F(m->arg, m->res, m->iw, m->w);
+      stepF(m, m->t, get_ptr(m->x_prev), get_ptr(m->Z_prev),
+            get_ptr(m->x), get_ptr(m->Z), get_ptr(m->q));
       casadi_axpy(nq_, 1., get_ptr(m->q_prev), get_ptr(m->q));
 
       // Tape
-      if (nrx_>0) {
-        casadi_copy(get_ptr(m->x), nx_, get_ptr(m->x_tape.at(m->k+1)));
-        casadi_copy(get_ptr(m->Z), m->Z.size(), get_ptr(m->Z_tape.at(m->k)));
+      if (nrx_>0 && ncp_==0) {
+        casadi_copy(get_ptr(m->x), nx_, get_ptr(m->tape) + (m->k+1)*nx_);
+        casadi_copy(get_ptr(m->Z), nZ_, get_ptr(m->tape) + (nk_+1)*nx_ + m->k*nZ_);
       }
 
       // Advance time
       m->k++;
       m->t = static_cast<double>(grid_.front()) + static_cast<double>(m->k)*h_;
+
+      // Zero crossings of the event functions in the step
+      if (nev_>0) detect_events(m);
     }
 
-    // Return to user TODO(@jaeandersson): interpolate
-    casadi_copy(get_ptr(m->x), nx_, x);
-    casadi_copy(get_ptr(m->Z)+m->Z.size()-nz_, nz_, z);
-    casadi_copy(get_ptr(m->q), nq_, q);
+    // Return to user, interpolating if t is inside the last step
+    if (dense_output_ && m->k>0 && t < m->t - 1e-9*h_) {
+      interpolate(m, (t - (m->t - h_))/h_, x, z, q);
+    } else {
+      casadi_copy(get_ptr(m->x), nx_, x);
+      casadi_copy(get_ptr(m->Z)+m->Z.size()-nz_, nz_, z);
+      casadi_copy(get_ptr(m->q), nq_, q);
+    }
+  }
+
+  void FixedStepIntegrator::interpolate(FixedStepMemory* m, double theta,
+                                        double* x, double* z, double* q) const {
+    // Algebraic variables at the start and end of the step
+    const double* z0 = m->k==1 ? get_ptr(m->z) : get_ptr(m->Z_prev)+nZ_-nz_;
+    const double* z1 = get_ptr(m->Z)+nZ_-nz_;
+
+    // Time derivatives at the start and end of the step, evaluated once per step
+    if ((x || q) && m->k_dense!=m->k) {
+      double t0 = m->t - h_;
+      m->arg[0] = get_ptr(m->x_prev);
+      m->arg[1] = z0;
+      m->arg[2] = get_ptr(m->p);
+      m->arg[3] = &t0;
+      m->res[0] = get_ptr(m->xdot_prev);
+      m->res[1] = get_ptr(m->xdot_prev) + nx_;
+      if (calc_function(m, "daeF")) casadi_error("'daeF' calculation failed");
+      m->arg[0] = get_ptr(m->x);
+      m->arg[1] = z1;
+      m->arg[3] = &m->t;
+      m->res[0] = get_ptr(m->xdot);
+      m->res[1] = get_ptr(m->xdot) + nx_;
+      if (calc_function(m, "daeF")) casadi_error("'daeF' calculation failed");
+      m->k_dense = m->k;
+    }
+
+    // Cubic Hermite basis functions
+    double theta2 = theta*theta, theta3 = theta2*theta;
+    double h00 = 2*theta3 - 3*theta2 + 1, h10 = h_*(theta3 - 2*theta2 + theta);
+    double h01 = 3*theta2 - 2*theta3, h11 = h_*(theta3 - theta2);
+
+    // Interpolate states and quadratures
+    for (casadi_int i=0; i<nx_ && x; ++i) {
+      x[i] = h00*m->x_prev[i] + h10*m->xdot_prev[i] + h01*m->x[i] + h11*m->xdot[i];
+    }
+    for (casadi_int i=0; i<nq_ && q; ++i) {
+      q[i] = h00*m->q_prev[i] + h10*m->xdot_prev[nx_+i] + h01*m->q[i] + h11*m->xdot[nx_+i];
+    }
+
+    // Linear interpolation of the algebraic variables
+    for (casadi_int i=0; i<nz_ && z; ++i) z[i] = (1-theta)*z0[i] + theta*z1[i];
+  }
+
+  void FixedStepIntegrator::detect_events(FixedStepMemory* m) const {
+    // Event functions at the end of the step
+    double* e = get_ptr(m->e);
+    double* e_prev = get_ptr(m->e_prev);
+    eval_event(m, m->t, get_ptr(m->x), get_ptr(m->Z)+nZ_-nz_, get_ptr(m->p), e);
+
+    // Locate the sign changes, in chronological order
+    vector<pair<double, casadi_int> > roots;
+    for (casadi_int i=0; i<nev_; ++i) {
+      if (e_prev[i]==0 || (e_prev[i]<0)==(e[i]<0)) continue;
+      if (e[i]==0) {
+        roots.push_back(make_pair(1., i));
+        continue;
+      }
+
+      // Illinois method on the dense output
+      double a = 0, fa = e_prev[i], b = 1, fb = e[i];
+      for (casadi_int iter=0; iter<100 && std::fabs(b-a)*h_>event_tol_; ++iter) {
+        double c = b - fb*(b-a)/(fb-fa);
+        interpolate(m, c, get_ptr(m->x_dense), get_ptr(m->z_dense), nullptr);
+        eval_event(m, m->t - (1-c)*h_, get_ptr(m->x_dense), get_ptr(m->z_dense),
+                   get_ptr(m->p), get_ptr(m->e_trial));
+        double fc = m->e_trial[i];
+        if (fc==0) {
+          a = b = c;
+          break;
+        } else if ((fc<0)!=(fb<0)) {
+          a = b;
+          fa = fb;
+        } else {
+          fa /= 2;
+        }
+        b = c;
+        fb = fc;
+      }
+      roots.push_back(make_pair(b, i));
+    }
+    std::sort(roots.begin(), roots.end());
+
+    // Record the events, with the state at the zero crossing
+    for (auto&& r : roots) {
+      interpolate(m, r.first, get_ptr(m->x_dense), nullptr, nullptr);
+      add_event(m, m->t - (1-r.first)*h_, r.second, get_ptr(m->x_dense));
+    }
+    casadi_copy(e, nev_, e_prev);
   }
 
   void FixedStepIntegrator::retreat(IntegratorMemory* mem, double t,
@@ -1160,20 +1489,6 @@ namespace casadi {
     // Explicit discrete time dynamics
     const Function& G = getExplicitB();
 
-    // Discrete dynamics function inputs ...
-    fill_n(m->arg, G.n_in(), nullptr);
-    m->arg[RDAE_T] = &m->t;
-    m->arg[RDAE_P] = get_ptr(m->p);
-    m->arg[RDAE_RX] = get_ptr(m->rx_prev);
-    m->arg[RDAE_RZ] = get_ptr(m->RZ_prev);
-    m->arg[RDAE_RP] = get_ptr(m->rp);
-
-    // ... and outputs
-    fill_n(m->res, G.n_out(), nullptr);
-    m->res[RDAE_ODE] = get_ptr(m->rx);
-    m->res[RDAE_ALG] = get_ptr(m->RZ);
-    m->res[RDAE_QUAD] = get_ptr(m->rq);
-
     // Take time steps until end time has been reached
     while (m->k>k_out) {
       // Advance time
@@ -1185,9 +1500,32 @@ namespace casadi {
       casadi_copy(get_ptr(m->RZ), nRZ_, get_ptr(m->RZ_prev));
       casadi_copy(get_ptr(m->rq), nrq_, get_ptr(m->rq_prev));
 
+      // Forward solution at the current step
+      const double *x_k, *Z_k;
+      if (ncp_>0) {
+        restore(m, m->k, &x_k, &Z_k);
+      } else {
+        x_k = get_ptr(m->tape) + m->k*nx_;
+        Z_k = get_ptr(m->tape) + (nk_+1)*nx_ + m->k*nZ_;
+      }
+
+      // Discrete dynamics function inputs ...
+      fill_n(m->arg, G.n_in(), nullptr);
+      m->arg[RDAE_T] = &m->t;
+      m->arg[RDAE_X] = x_k;
+      m->arg[RDAE_Z] = Z_k;
+      m->arg[RDAE_P] = get_ptr(m->p);
+      m->arg[RDAE_RX] = get_ptr(m->rx_prev);
+      m->arg[RDAE_RZ] = get_ptr(m->RZ_prev);
+      m->arg[RDAE_RP] = get_ptr(m->rp);
+
+      // ... and outputs
+      fill_n(m->res, G.n_out(), nullptr);
+      m->res[RDAE_ODE] = get_ptr(m->rx);
+      m->res[RDAE_ALG] = get_ptr(m->RZ);
+      m->res[RDAE_QUAD] = get_ptr(m->rq);
+
       // Take step
-      m->arg[RDAE_X] = get_ptr(m->x_tape.at(m->k));
-      m->arg[RDAE_Z] = get_ptr(m->Z_tape.at(m->k));
       G(m->arg, m->res, m->iw, m->w);
       casadi_axpy(nrq_, 1., get_ptr(m->rq_prev), get_ptr(m->rq));
     }
@@ -1218,14 +1556,103 @@ namespace casadi {
 
     // Bring discrete time to the beginning
     m->k = 0;
+    m->k_dense = -1;
+
+    // Event functions at the initial time
+    if (nev_>0) eval_event(m, t, x, z, p, get_ptr(m->e_prev));
 
     // Get consistent initial conditions
     casadi_fill(get_ptr(m->Z), m->Z.size(), numeric_limits<double>::quiet_NaN());
 
     // Add the first element in the tape
     if (nrx_>0) {
-      casadi_copy(x, nx_, get_ptr(m->x_tape.at(0)));
+      if (ncp_>0) {
+        // Checkpoints are stored during the integration, starting with the initial state
+        m->cp_k.clear();
+        m->cp_next = 0;
+      } else {
+        casadi_copy(x, nx_, get_ptr(m->tape));
+      }
+    }
+  }
+
+  casadi_int FixedStepIntegrator::
+  checkpoint_split(casadi_int a, casadi_int b, casadi_int nfree) {
+    // Number of steps to be reversed
+    casadi_int l = b - a;
+    if (nfree<=0 || l<=1) return b;
+
+    // Smallest number of recomputations r such that beta(s, r) = binomial(s+r, s) >= l
+    casadi_int r = 0;
+    double beta = 1;
+    while (beta<l) {
+      r++;
+      beta = std::round(beta*static_cast<double>(nfree+r)/static_cast<double>(r));
+    }
+
+    // The steps after the checkpoint are reversed with one checkpoint less
+    double beta_right = std::round(beta*static_cast<double>(nfree)/static_cast<double>(nfree+r));
+    return a + std::max(l - static_cast<casadi_int>(beta_right), casadi_int(1));
+  }
+
+  void FixedStepIntegrator::checkpoint(FixedStepMemory* m, casadi_int k,
+                                       const double* x, const double* Z) const {
+    casadi_assert_dev(static_cast<casadi_int>(m->cp_k.size())<ncp_);
+    double* cp = get_ptr(m->tape) + m->cp_k.size()*(nx_+nZ_);
+    casadi_copy(x, nx_, cp);
+    casadi_copy(Z, nZ_, cp+nx_);
+    m->cp_k.push_back(k);
+  }
+
+  void FixedStepIntegrator::stepF(FixedStepMemory* m, double t, const double* x0,
+                                  const double* Z0, double* xf, double* Zf, double* qf) const {
+    // Explicit discrete time dynamics
+    const Function& F = getExplicit();
+
+    // Discrete dynamics function inputs ...
+    fill_n(m->arg, F.n_in(), nullptr);
+    m->arg[DAE_T] = &t;
+    m->arg[DAE_X] = x0;
+    m->arg[DAE_Z] = Z0;
+    m->arg[DAE_P] = get_ptr(m->p);
+
+    // ... and outputs
+    fill_n(m->res, F.n_out(), nullptr);
+    m->res[DAE_ODE] = xf;
+    m->res[DAE_ALG] = Zf;
+    m->res[DAE_QUAD] = qf;
+    F(m->arg, m->res, m->iw, m->w);
+  }
+
+  void FixedStepIntegrator::restore(FixedStepMemory* m, casadi_int k,
+                                    const double** x, const double** Z) const {
+    // Checkpoints beyond the current step are no longer needed
+    while (m->cp_k.back()>k) m->cp_k.pop_back();
+
+    // Start from the last checkpoint
+    casadi_int j = m->cp_k.back();
+    const double* cp = get_ptr(m->tape) + (m->cp_k.size()-1)*(nx_+nZ_);
+    casadi_copy(cp, nx_, get_ptr(m->x_rec_prev));
+    casadi_copy(cp+nx_, nZ_, get_ptr(m->Z_rec_prev));
+
+    // Recompute the trajectory up to and including step k, placing new checkpoints on the way
+    casadi_int split = checkpoint_split(j, k+1, ncp_ - static_cast<casadi_int>(m->cp_k.size()));
+    while (true) {
+      double t = static_cast<double>(grid_.front()) + static_cast<double>(j)*h_;
+      stepF(m, t, get_ptr(m->x_rec_prev), get_ptr(m->Z_rec_prev),
+            get_ptr(m->x_rec), get_ptr(m->Z_rec), nullptr);
+      if (j==k) break;
+      std::swap(m->x_rec, m->x_rec_prev);
+      std::swap(m->Z_rec, m->Z_rec_prev);
+      if (++j==split) {
+        checkpoint(m, j, get_ptr(m->x_rec_prev), get_ptr(m->Z_rec_prev));
+        split = checkpoint_split(j, k+1, ncp_ - static_cast<casadi_int>(m->cp_k.size()));
+      }
     }
+
+    // State at the beginning and algebraic variables of step k
+    *x = get_ptr(m->x_rec_prev);
+    *Z = get_ptr(m->Z_rec);
   }
 
   void FixedStepIntegrator::resetB(IntegratorMemory* mem, double t, const double* rx,
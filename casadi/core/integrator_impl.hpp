@@ -36,6 +36,10 @@ namespace casadi {
 
   /** \brief Integrator memory */
   struct CASADI_EXPORT IntegratorMemory : public OracleMemory {
+    // Detected events: time, index of the event function and state
+    std::vector<double> event_t;
+    std::vector<casadi_int> event_i;
+    std::vector<std::vector<double> > event_x;
   };
 
   /** \brief Internal storage for integrator related data
@@ -105,6 +109,19 @@ namespace casadi {
     /** \brief  Print solver statistics */
     virtual void print_stats(IntegratorMemory* mem) const {}
 
+    /// Get all statistics
+    Dict get_stats(void* mem) const override;
+
+    /// Does the plugin support event detection?
+    virtual bool has_events() const { return false;}
+
+    /// Evaluate the event functions
+    void eval_event(IntegratorMemory* m, double t, const double* x, const double* z,
+                    const double* p, double* e) const;
+
+    /// Record a zero crossing of event function i at time t
+    void add_event(IntegratorMemory* m, double t, casadi_int i, const double* x) const;
+
     /** \brief  Propagate sparsity forward */
     int sp_forward(const bvec_t** arg, bvec_t** res,
       casadi_int* iw, bvec_t* w, void* mem) const override;
@@ -136,6 +153,15 @@ namespace casadi {
     bool has_reverse(casadi_int nadj) const override { return true;}
     ///@}
 
+    ///@{
+    /** \brief Generate a function that integrates \a n trajectories simultaneously */
+    Function get_batch(casadi_int n, const std::string& name) const override;
+    bool has_batch(casadi_int n) const override { return true;}
+    ///@}
+
+    /** \brief Integrator for a group of \a n trajectories, inputs and outputs as in batch(n) */
+    Function group_integrator(casadi_int n) const;
+
     /** \brief  Set stop time for the integration */
     virtual void setStopTime(IntegratorMemory* mem, double tf) const;
 
@@ -148,6 +174,9 @@ namespace casadi {
     /** \brief Generate a augmented DAE system with \a nadj adjoint sensitivities */
     template<typename MatType> std::map<std::string, MatType> aug_adj(casadi_int nadj) const;
 
+    /** \brief Generate a DAE system for \a n trajectories, stacked trajectory by trajectory */
+    template<typename MatType> std::map<std::string, MatType> aug_batch(casadi_int n) const;
+
     /// Create sparsity pattern of the extended Jacobian (forward problem)
     Sparsity sp_jac_dae();
 
@@ -189,6 +218,13 @@ namespace casadi {
     // Augmented user option
     Dict augmented_options_;
 
+    // Number of trajectories sharing the step size control in a batch, 0 for all
+    casadi_int batch_group_;
+
+    // Event functions
+    Function event_;
+    casadi_int nev_;
+
     // Copy of the options
     Dict opts_;
 
@@ -236,8 +272,29 @@ namespace casadi {
     /// Algebraic variables for the discrete time integration
     std::vector<double> Z, RZ;
 
-    // Tape
-    std::vector<std::vector<double> > x_tape, Z_tape;
+    // Tape, either the full trajectory or a set of checkpoints, stored contiguously
+    std::vector<double> tape;
+
+    // Discrete times of the stored checkpoints
+    std::vector<casadi_int> cp_k;
+
+    // Next discrete time to be checkpointed during the forward integration
+    casadi_int cp_next;
+
+    // Work vectors for recomputing the forward trajectory from a checkpoint
+    std::vector<double> x_rec, Z_rec, x_rec_prev, Z_rec_prev;
+
+    // Event function values at the start and end of the last step, and at a trial point
+    std::vector<double> e_prev, e, e_trial;
+
+    // Dense output: state, algebraic variables and quadratures
+    std::vector<double> x_dense, z_dense, q_dense;
+
+    // Time derivatives of the states and quadratures at the start and end of the last step
+    std::vector<double> xdot_prev, xdot;
+
+    // Discrete time at the end of the step for which xdot_prev and xdot are valid
+    casadi_int k_dense;
   };
 
   class CASADI_EXPORT FixedStepIntegrator : public Integrator {
@@ -286,21 +343,61 @@ namespace casadi {
     void retreat(IntegratorMemory* mem, double t,
                          double* rx, double* rz, double* rq) const override;
 
+    /// Take a step of the forward discrete time dynamics, with Z0 as a guess for Zf
+    virtual void stepF(FixedStepMemory* m, double t, const double* x0, const double* Z0,
+                       double* xf, double* Zf, double* qf) const;
+
+    /** \brief Dense output in the last step, at the fraction theta of the step
+     *
+     * Cubic Hermite interpolation of the states and quadratures, linear interpolation
+     * of the algebraic variables. Outputs can be null.
+     */
+    virtual void interpolate(FixedStepMemory* m, double theta,
+                             double* x, double* z, double* q) const;
+
+    /// Locate and record the zero crossings of the event functions in the last step
+    void detect_events(FixedStepMemory* m) const;
+
+    /// Event detection is supported
+    bool has_events() const override { return true;}
+
     /// Get explicit dynamics
     virtual const Function& getExplicit() const { return F_;}
 
     /// Get explicit dynamics (backward problem)
     virtual const Function& getExplicitB() const { return G_;}
 
+    /** \brief Discrete time of the next checkpoint in a binomial schedule
+     *
+     * Position of the next checkpoint when reversing the steps a, ..., b-1 with
+     * \a nfree checkpoints available, or b if no checkpoint should be placed
+     */
+    static casadi_int checkpoint_split(casadi_int a, casadi_int b, casadi_int nfree);
+
+    /// Store the state at discrete time k as a checkpoint
+    void checkpoint(FixedStepMemory* m, casadi_int k, const double* x, const double* Z) const;
+
+    /// Get the forward solution at discrete time k, recomputing from a checkpoint
+    void restore(FixedStepMemory* m, casadi_int k, const double** x, const double** Z) const;
+
     // Discrete time dynamics
     Function F_, G_;
 
     // Number of finite elements
     casadi_int nk_;
 
+    // Number of checkpoints for the backward integration (0 for a full tape)
+    casadi_int ncp_;
+
     // Time step size
     double h_;
 
+    // Dense output needed, for the time grid or for event detection
+    bool dense_output_;
+
+    // Tolerance on the event times
+    double event_tol_;
+
     /// Number of algebraic variables for the discrete time integration
     casadi_int nZ_, nRZ_;
   };
@@ -83,7 +83,7 @@ namespace casadi {
 
     // Solve
     DM x = densify(B);
-    if (solve(A.ptr(), x.ptr(), x.size2())) casadi_error("Linsol::solve: 'solve' failed");
+    if (solve(A.ptr(), x.ptr(), x.size2(), tr)) casadi_error("Linsol::solve: 'solve' failed");
     return x;
   }
 
@@ -100,6 +100,9 @@ namespace casadi {
     if (A==nullptr) return 1;
     auto m = static_cast<LinsolMemory*>((*this)->memory(mem));
 
+    // Keep the symbolic and numeric factorization, if it is being reused
+    if ((*this)->reuse_factorization_ && m->is_nfact) return 0;
+
     // Factorization will be needed after this step
     m->is_sfact = m->is_nfact = false;
 
@@ -125,9 +128,25 @@ namespace casadi {
       if (sfact(A, mem)) return 1;
     }
 
+    // Keep the factorization, refine against the new matrix when solving
+    if ((*this)->reuse_factorization_ && m->is_nfact) {
+      casadi_int nnz = sparsity().nnz();
+      casadi_copy(A, nnz, get_ptr(m->a));
+      m->is_stale = !std::equal(A, A+nnz, m->a_fact.begin());
+      if (m->is_stale) m->n_reuse++;
+      return 0;
+    }
+
     m->is_nfact = false;
     if ((*this)->nfact(m, A)) return 1;
     m->is_nfact = true;
+    m->n_nfact++;
+
+    // Remember the factorized matrix
+    if ((*this)->reuse_factorization_) {
+      casadi_copy(A, sparsity().nnz(), get_ptr(m->a_fact));
+      m->is_stale = false;
+    }
     return 0;
   }
 
@@ -156,9 +175,14 @@ namespace casadi {
   int Linsol::solve(const double* A, double* x, casadi_int nrhs, bool tr, casadi_int mem) const {
     auto m = static_cast<LinsolMemory*>((*this)->memory(mem));
     casadi_assert(m->is_nfact, "Linear system has not been factorized");
+    if (m->is_stale) return (*this)->solve_refine(m, x, nrhs, tr);
     return (*this)->solve(m, A, x, nrhs, tr);
   }
 
+  Dict Linsol::stats(casadi_int mem) const {
+    return (*this)->get_stats((*this)->memory(mem));
+  }
+
   casadi_int Linsol::checkout() const {
     return (*this)->checkout();
   }
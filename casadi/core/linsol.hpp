@@ -106,6 +106,12 @@ namespace casadi {
       */
     casadi_int rank(const DM& A) const;
 
+    /** \brief Get all statistics accumulated for a memory object
+      * Counts numeric factorizations and, with the option "reuse_factorization",
+      * reused factorizations and iterative refinement steps
+      */
+    Dict stats(casadi_int mem=0) const;
+
     #ifndef SWIG
     ///@{
     /// Low-level API
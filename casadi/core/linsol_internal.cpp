@@ -30,15 +30,46 @@ namespace casadi {
 
   LinsolInternal::LinsolInternal(const std::string& name, const Sparsity& sp)
    : ProtoFunction(name), sp_(sp) {
+    // Default options
+    reuse_factorization_ = false;
+    max_refine_ = 10;
+    refine_tol_ = 1e-10;
   }
 
   LinsolInternal::~LinsolInternal() {
   }
 
+  Options LinsolInternal::options_
+  = {{&ProtoFunction::options_},
+     {{"reuse_factorization",
+       {OT_BOOL,
+        "Keep the numeric factorization when the matrix changes and use it as a "
+        "preconditioner for iterative refinement against the new matrix. "
+        "The matrix is refactorized only when the refinement fails to converge."}},
+      {"max_refine",
+       {OT_INT,
+        "Maximum number of iterative refinement steps before refactorizing [10]"}},
+      {"refine_tol",
+       {OT_DOUBLE,
+        "Tolerance on the residual, relative to the right-hand side, "
+        "for iterative refinement [1e-10]"}}
+     }
+  };
+
   void LinsolInternal::init(const Dict& opts) {
     // Call the base class initializer
     ProtoFunction::init(opts);
 
+    // Read options
+    for (auto&& op : opts) {
+      if (op.first=="reuse_factorization") {
+        reuse_factorization_ = op.second;
+      } else if (op.first=="max_refine") {
+        max_refine_ = op.second;
+      } else if (op.first=="refine_tol") {
+        refine_tol_ = op.second;
+      }
+    }
   }
 
   void LinsolInternal::disp(ostream &stream, bool more) const {
@@ -51,7 +82,15 @@ namespace casadi {
 
   int LinsolInternal::init_mem(void* mem) const {
     if (!mem) return 1;
-    //auto m = static_cast<LinsolMemory*>(mem);
+    auto m = static_cast<LinsolMemory*>(mem);
+
+    // Memory for reusing factorizations
+    if (reuse_factorization_) {
+      m->a_fact.resize(nnz());
+      m->a.resize(nnz());
+      m->b.resize(nrow());
+      m->r.resize(nrow());
+    }
     return 0;
   }
 
@@ -64,6 +103,53 @@ namespace casadi {
     casadi_error("'solve' not defined for " + class_name());
   }
 
+  int LinsolInternal::solve_refine(void* mem, double* x, casadi_int nrhs, bool tr) const {
+    auto m = static_cast<LinsolMemory*>(mem);
+    casadi_int n = nrow();
+    const double* a = get_ptr(m->a);
+    double* b = get_ptr(m->b);
+    double* r = get_ptr(m->r);
+    for (casadi_int k=0; k<nrhs; ++k) {
+      double* xk = x + k*n;
+      casadi_copy(xk, n, b);
+      double tol = refine_tol_*casadi_norm_inf(n, b);
+      // Initial guess with the reused factorization
+      if (solve(mem, get_ptr(m->a_fact), xk, 1, tr)) return 1;
+      for (casadi_int iter=0; ; ++iter) {
+        // Residual r = b - A*x for the current matrix
+        casadi_fill(r, n, 0.);
+        casadi_mv(a, sp_, xk, r, tr);
+        for (casadi_int i=0; i<n; ++i) r[i] = b[i] - r[i];
+        if (casadi_norm_inf(n, r)<=tol) break;
+        if (iter==max_refine_) {
+          // Refinement does not converge: refactorize and solve the remaining systems
+          if (verbose_) casadi_message("Refinement failed, refactorizing");
+          if (sfact(mem, a)) return 1;
+          if (nfact(mem, a)) return 1;
+          casadi_copy(a, nnz(), get_ptr(m->a_fact));
+          m->is_stale = false;
+          m->n_nfact++;
+          casadi_copy(b, n, xk);
+          return solve(mem, a, xk, nrhs-k, tr);
+        }
+        // Correction with the reused factorization
+        if (solve(mem, get_ptr(m->a_fact), r, 1, tr)) return 1;
+        casadi_axpy(n, 1., r, xk);
+        m->n_refine++;
+      }
+    }
+    return 0;
+  }
+
+  Dict LinsolInternal::get_stats(void* mem) const {
+    auto m = static_cast<LinsolMemory*>(mem);
+    Dict stats;
+    stats["n_nfact"] = m->n_nfact;
+    stats["n_reuse"] = m->n_reuse;
+    stats["n_refine"] = m->n_refine;
+    return stats;
+  }
+
 #if 0
   casadi_int LinsolInternal::factorize(void* mem, const double* A) const {
     // Symbolic factorization, if needed
@@ -107,6 +193,16 @@ namespace casadi {
     g << "#error " <<  class_name() << " does not support code generation\n";
   }
 
+  void LinsolInternal::generate_nfact(CodeGenerator& g, const std::string& A,
+                                      const std::string& w) const {
+    casadi_error("'generate_nfact' not defined for " + class_name());
+  }
+
+  void LinsolInternal::generate_solve(CodeGenerator& g, const std::string& x, casadi_int nrhs,
+                                      bool tr, const std::string& w) const {
+    casadi_error("'generate_solve' not defined for " + class_name());
+  }
+
   std::map<std::string, LinsolInternal::Plugin> LinsolInternal::solvers_;
 
   const std::string LinsolInternal::infix_ = "linsol";
@@ -38,8 +38,21 @@ namespace casadi {
     // Current state of factorization
     bool is_sfact, is_nfact;
 
+    // Factorization is of an earlier matrix, solve with iterative refinement
+    bool is_stale;
+
+    // Nonzeros of the factorized and of the current matrix
+    std::vector<double> a_fact, a;
+
+    // Work vectors for iterative refinement
+    std::vector<double> b, r;
+
+    // Statistics
+    casadi_int n_nfact, n_reuse, n_refine;
+
     // Constructor
-    LinsolMemory() : is_sfact(false), is_nfact(false) {}
+    LinsolMemory() : is_sfact(false), is_nfact(false), is_stale(false),
+      n_nfact(0), n_reuse(0), n_refine(0) {}
   };
 
   /** Internal class
@@ -60,6 +73,12 @@ namespace casadi {
     /** \brief  Print more */
     virtual void disp_more(std::ostream& stream) const {}
 
+    ///@{
+    /** \brief Options */
+    static Options options_;
+    const Options& get_options() const override { return options_;}
+    ///@}
+
     /// Initialize
     void init(const Dict& opts) override;
 
@@ -97,6 +116,12 @@ namespace casadi {
     // Solve numerically
     virtual int solve(void* mem, const double* A, double* x, casadi_int nrhs, bool tr) const;
 
+    /// Solve with a factorization of an earlier matrix, using iterative refinement
+    int solve_refine(void* mem, double* x, casadi_int nrhs, bool tr) const;
+
+    /// Get all statistics
+    virtual Dict get_stats(void* mem) const;
+
     /// Number of negative eigenvalues
     virtual casadi_int neig(void* mem, const double* A) const;
 
@@ -107,6 +132,20 @@ namespace casadi {
     virtual void generate(CodeGenerator& g, const std::string& A, const std::string& x,
                           casadi_int nrhs, bool tr) const;
 
+    /// Can the factorization be generated separately from the solve?
+    virtual bool has_generate_nfact() const { return false;}
+
+    /// Work vector size for a generated factorization
+    virtual casadi_int sz_w_generate() const { return 0;}
+
+    /// Generate C code for a numeric factorization, stored in the work vector w
+    virtual void generate_nfact(CodeGenerator& g, const std::string& A,
+                                const std::string& w) const;
+
+    /// Generate C code for a solve using a factorization from generate_nfact
+    virtual void generate_solve(CodeGenerator& g, const std::string& x, casadi_int nrhs,
+                                bool tr, const std::string& w) const;
+
     // Creator function for internal class
     typedef LinsolInternal* (*Creator)(const std::string& name, const Sparsity& sp);
 
@@ -131,6 +170,13 @@ namespace casadi {
 
     // Sparsity pattern of the linear system
     Sparsity sp_;
+
+    // Keep the factorization when the matrix changes, refactorize on demand
+    bool reuse_factorization_;
+
+    // Iterative refinement with a reused factorization
+    casadi_int max_refine_;
+    double refine_tol_;
   };
 
 } // namespace casadi
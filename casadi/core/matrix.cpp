@@ -3261,9 +3261,11 @@ namespace casadi {
 
   template<>
   SX SX::jacobian(const SX &f, const SX &x, const Dict& opts) {
-    // Propagate verbose option to helper function
+    // Propagate verbose and coloring options to helper function
     Dict h_opts;
     if (opts.count("verbose")) h_opts["verbose"] = opts.at("verbose");
+    if (opts.count("coloring")) h_opts["coloring"] = opts.at("coloring");
+    if (opts.count("bicoloring")) h_opts["bicoloring"] = opts.at("bicoloring");
     Function h("jac_helper", {x}, {f}, h_opts);
     return h.get<SXFunction>()->jac(0, 0, opts);
   }
@@ -144,6 +144,43 @@ namespace casadi {
       << " *rr += ss[k*" << nrow_x << "]**tt++;\n";
   }
 
+  BlockMultiplication::BlockMultiplication(const MX& z, const MX& x, const MX& y, casadi_int bs)
+      : Multiplication(z, x, y), bs_(bs) {
+    sp_xb_ = x.sparsity().block_compress(bs);
+    sp_yb_ = y.sparsity().block_compress(bs);
+    sp_zb_ = z.sparsity().block_compress(bs);
+  }
+
+  int BlockMultiplication::eval(const double** arg, double** res, casadi_int* iw, double* w) const {
+    return eval_gen<double>(arg, res, iw, w);
+  }
+
+  int BlockMultiplication::
+  eval_sx(const SXElem** arg, SXElem** res, casadi_int* iw, SXElem* w) const {
+    return eval_gen<SXElem>(arg, res, iw, w);
+  }
+
+  template<typename T>
+  int BlockMultiplication::eval_gen(const T** arg, T** res, casadi_int* iw, T* w) const {
+    if (arg[0]!=res[0]) copy(arg[0], arg[0]+dep(0).nnz(), res[0]);
+    casadi_block_mtimes(arg[1], sp_xb_, arg[2], sp_yb_, res[0], sp_zb_, w, bs_);
+    return 0;
+  }
+
+  void BlockMultiplication::
+  generate(CodeGenerator& g,
+           const std::vector<casadi_int>& arg, const std::vector<casadi_int>& res) const {
+    // Copy first argument if not inplace
+    if (arg[0]!=res[0]) {
+      g << g.copy(g.work(arg[0], nnz()), nnz(), g.work(res[0], nnz())) << '\n';
+    }
+
+    // Perform block-sparse matrix multiplication
+    g << g.block_mtimes(g.work(arg[1], dep(1).nnz()), sp_xb_,
+                        g.work(arg[2], dep(2).nnz()), sp_yb_,
+                        g.work(res[0], nnz()), sp_zb_, "w", bs_) << '\n';
+  }
+
 } // namespace casadi
 
 #endif // CASADI_MULTIPLICATION_CPP
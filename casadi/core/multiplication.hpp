@@ -118,6 +118,46 @@ namespace casadi {
   };
 
 
+  /** \brief An MX atomic for matrix-matrix product of block-sparse matrices
+
+      All factors consist of dense, aligned bs-by-bs blocks. The product is
+      formed with dense block kernels, addressing the nonzeros via the block
+      patterns.
+  */
+  class CASADI_EXPORT BlockMultiplication : public Multiplication{
+  public:
+
+    /** \brief  Constructor */
+    BlockMultiplication(const MX& z, const MX& x, const MX& y, casadi_int bs);
+
+    /** \brief  Destructor */
+    ~BlockMultiplication() override {}
+
+    /// Evaluate the function (template)
+    template<typename T>
+    int eval_gen(const T** arg, T** res, casadi_int* iw, T* w) const;
+
+    /// Evaluate the function numerically
+    int eval(const double** arg, double** res, casadi_int* iw, double* w) const override;
+
+    /// Evaluate the function symbolically (SX)
+    int eval_sx(const SXElem** arg, SXElem** res, casadi_int* iw, SXElem* w) const override;
+
+    /** \brief Generate code for the operation */
+    void generate(CodeGenerator& g,
+                  const std::vector<casadi_int>& arg,
+                  const std::vector<casadi_int>& res) const override;
+
+    /** \brief Get required length of w field */
+    size_t sz_w() const override { return sparsity().size1()*bs_;}
+
+    /// Block size
+    casadi_int bs_;
+
+    /// Block patterns of x, y and z
+    Sparsity sp_xb_, sp_yb_, sp_zb_;
+  };
+
 } // namespace casadi
 /// \endcond
 
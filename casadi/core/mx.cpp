@@ -1595,9 +1595,11 @@ namespace casadi {
 
   MX MX::jacobian(const MX &f, const MX &x, const Dict& opts) {
     try {
-      // Propagate verbose option to helper function
+      // Propagate verbose and coloring options to helper function
       Dict h_opts;
       if (opts.count("verbose")) h_opts["verbose"] = opts.at("verbose");
+      if (opts.count("coloring")) h_opts["coloring"] = opts.at("coloring");
+      if (opts.count("bicoloring")) h_opts["bicoloring"] = opts.at("bicoloring");
       Function h("helper_jacobian_MX", {x}, {f}, h_opts);
       return h.get<MXFunction>()->jac(0, 0, opts);
     } catch (std::exception& e) {
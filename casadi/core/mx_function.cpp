@@ -327,6 +327,38 @@ namespace casadi {
     sz_w += wind;
     alloc_w(sz_w);
 
+    // Private work for calls evaluated in parallel in generated code
+    task_arg_.assign(algorithm_.size(), -1);
+    task_res_.assign(algorithm_.size(), -1);
+    task_iw_.assign(algorithm_.size(), -1);
+    task_w_.assign(algorithm_.size(), -1);
+    size_t arg_base = sz_arg(), res_base = sz_res(), iw_base = sz_iw(), w_base = sz_w;
+    for (auto&& v : task_levels()) {
+      // The first task uses the regular work vectors
+      size_t task_arg = arg_base, task_res = res_base, task_iw = iw_base, task_w = w_base;
+      bool first = true;
+      for (casadi_int k : v) {
+        if (!is_task(k)) continue;
+        if (first) {
+          first = false;
+          continue;
+        }
+        const Function& f = algorithm_[k].data->which_function();
+        task_arg_[k] = task_arg;
+        task_res_[k] = task_res;
+        task_iw_[k] = task_iw;
+        task_w_[k] = task_w;
+        task_arg += f.sz_arg();
+        task_res += f.sz_res();
+        task_iw += f.sz_iw();
+        task_w += f.sz_w();
+      }
+      alloc_arg(task_arg - n_in_);
+      alloc_res(task_res - n_out_);
+      alloc_iw(task_iw);
+      alloc_w(task_w);
+    }
+
     // Reset the temporary variables
     for (casadi_int i=0; i<nodes.size(); ++i) {
       if (nodes[i]) {
@@ -1080,9 +1112,11 @@ namespace casadi {
 
     // Declare scalar work vector elements as local variables
     bool first = true;
+    size_t frame = 0;
     for (casadi_int i=0; i<workloc_.size()-1; ++i) {
       casadi_int n=workloc_[i+1]-workloc_[i];
       if (n==0) continue;
+      frame += !g.codegen_scalars && n==1 ? sizeof(double) : sizeof(void*);
       if (first) {
         g << "casadi_real ";
         first = false;
@@ -1103,44 +1137,135 @@ namespace casadi {
       }
     }
     if (!first) g << ";\n";
+    g.frame_size_[codegen_name(g)] += frame;
+
+    // Codegen the algorithm
+    if (g.openmp) {
+      codegen_tasks(g);
+    } else {
+      for (casadi_int k=0; k<algorithm_.size(); ++k) codegen_instruction(g, k);
+    }
+  }
 
-    // Operation number (for printing)
-    casadi_int k=0;
+  void MXFunction::codegen_instruction(CodeGenerator& g, casadi_int k) const {
+    const AlgEl& e = algorithm_[k];
 
-    // Names of operation argument and results
-    vector<casadi_int> arg, res;
+    // Generate comment
+    if (g.verbose) {
+      g << "/* #" << k << ": " << print(e) << " */\n";
+    }
 
-    // Codegen the algorithm
-    for (auto&& e : algorithm_) {
-      // Generate comment
-      if (g.verbose) {
-        g << "/* #" << k++ << ": " << print(e) << " */\n";
+    // Get the names of the operation arguments
+    vector<casadi_int> arg(e.arg.size());
+    for (casadi_int i=0; i<e.arg.size(); ++i) {
+      casadi_int j=e.arg.at(i);
+      if (j>=0 && workloc_.at(j)!=workloc_.at(j+1)) {
+        arg.at(i) = j;
+      } else {
+        arg.at(i) = -1;
       }
+    }
 
-      // Get the names of the operation arguments
-      arg.resize(e.arg.size());
-      for (casadi_int i=0; i<e.arg.size(); ++i) {
-        casadi_int j=e.arg.at(i);
-        if (j>=0 && workloc_.at(j)!=workloc_.at(j+1)) {
-          arg.at(i) = j;
-        } else {
-          arg.at(i) = -1;
-        }
+    // Get the names of the operation results
+    vector<casadi_int> res(e.res.size());
+    for (casadi_int i=0; i<e.res.size(); ++i) {
+      casadi_int j=e.res.at(i);
+      if (j>=0 && workloc_.at(j)!=workloc_.at(j+1)) {
+        res.at(i) = j;
+      } else {
+        res.at(i) = -1;
       }
+    }
+
+    // Generate operation
+    e.data->generate(g, arg, res);
+  }
+
+  std::vector<std::vector<casadi_int> > MXFunction::task_levels() const {
+    // Level of each instruction, respecting reuse of work vector elements
+    casadi_int nw = workloc_.size()-1, nlevel = 0;
+    vector<casadi_int> level(algorithm_.size()), last_write(nw, -1), last_read(nw, -1);
+    for (casadi_int k=0; k<algorithm_.size(); ++k) {
+      const AlgEl& e = algorithm_[k];
+      casadi_int l = 0;
+      for (casadi_int j : e.arg) if (j>=0) l = max(l, last_write[j]+1);
+      for (casadi_int j : e.res) if (j>=0) l = max(l, max(last_write[j], last_read[j])+1);
+      for (casadi_int j : e.arg) if (j>=0) last_read[j] = max(last_read[j], l);
+      for (casadi_int j : e.res) if (j>=0) last_write[j] = l;
+      level[k] = l;
+      nlevel = max(nlevel, l+1);
+    }
+
+    // Instructions for each level
+    vector<vector<casadi_int> > instr(nlevel);
+    for (casadi_int k=0; k<algorithm_.size(); ++k) instr[level[k]].push_back(k);
+    return instr;
+  }
 
-      // Get the names of the operation results
-      res.resize(e.res.size());
-      for (casadi_int i=0; i<e.res.size(); ++i) {
-        casadi_int j=e.res.at(i);
-        if (j>=0 && workloc_.at(j)!=workloc_.at(j+1)) {
-          res.at(i) = j;
+  bool MXFunction::is_task(casadi_int k) const {
+    // Function calls without memory objects
+    const AlgEl& e = algorithm_[k];
+    return e.op==OP_CALL && !e.data->has_refcount();
+  }
+
+  void MXFunction::codegen_tasks(CodeGenerator& g) const {
+    vector<casadi_int> tasks;
+    for (auto&& v : task_levels()) {
+      // Function calls without memory objects become tasks, other instructions are serial
+      tasks.clear();
+      for (casadi_int k : v) {
+        if (is_task(k)) {
+          tasks.push_back(k);
         } else {
-          res.at(i) = -1;
+          codegen_instruction(g, k);
         }
       }
+      if (tasks.size()<2) {
+        for (casadi_int k : tasks) codegen_instruction(g, k);
+        continue;
+      }
 
-      // Generate operation
-      e.data->generate(g, arg, res);
+      // Evaluate the calls in parallel
+      g.local("flag", "casadi_int");
+      g << "flag = 0;\n"
+        << "#pragma omp parallel sections\n"
+        << "{\n";
+      for (casadi_int k : tasks) {
+        const AlgEl& e = algorithm_[k];
+        const Function& f = e.data->which_function();
+        g << "#pragma omp section\n"
+          << "{\n";
+        if (g.verbose) {
+          g << "/* #" << k << ": " << print(e) << " */\n";
+        }
+        // Work vectors private to the section, the first one uses the regular work vectors
+        casadi_int arg_t = n_in_, res_t = n_out_;
+        string iw_t = "iw", w_t = "w";
+        if (task_w_[k]>=0) {
+          arg_t = task_arg_[k];
+          res_t = task_res_[k];
+          iw_t += "+" + str(task_iw_[k]);
+          w_t += "+" + str(task_w_[k]);
+        }
+        for (casadi_int i=0; i<e.arg.size(); ++i) {
+          casadi_int j = e.arg[i];
+          bool empty = j<0 || workloc_.at(j)==workloc_.at(j+1);
+          g << "arg[" << arg_t+i << "]=" << g.work(empty ? -1 : j, f.nnz_in(i)) << ";\n";
+        }
+        for (casadi_int i=0; i<e.res.size(); ++i) {
+          casadi_int j = e.res[i];
+          bool empty = j<0 || workloc_.at(j)==workloc_.at(j+1);
+          g << "res[" << res_t+i << "]=" << g.work(empty ? -1 : j, f.nnz_out(i)) << ";\n";
+        }
+        g << "if (" << g(f, "arg+" + str(arg_t), "res+" + str(res_t), iw_t, w_t)
+          << ") {\n"
+          << "#pragma omp critical\n"
+          << "flag = 1;\n"
+          << "}\n"
+          << "}\n";
+      }
+      g << "}\n"
+        << "if (flag) return 1;\n";
     }
   }
 
@@ -71,6 +71,13 @@ namespace casadi {
     /** \brief Offsets for elements in the w_ vector */
     std::vector<casadi_int> workloc_;
 
+    /** \brief Offsets in arg, res, iw and w of the work private to each OpenMP task
+     * Calls on the same level of the task graph get disjoint regions after the
+     * regular work vectors, see codegen_tasks. -1 for the first task of a level,
+     * which uses the regular work vectors, and for other instructions.
+     */
+    std::vector<casadi_int> task_arg_, task_res_, task_iw_, task_w_;
+
     /// Free variables
     std::vector<MX> free_vars_;
 
@@ -122,6 +129,24 @@ namespace casadi {
     /** \brief Generate code for the body of the C function */
     void codegen_body(CodeGenerator& g) const override;
 
+    /** \brief Generate code for instruction k of the algorithm */
+    void codegen_instruction(CodeGenerator& g, casadi_int k) const;
+
+    /** \brief Generate code evaluating independent function calls in parallel
+     * The algorithm is divided into levels without data dependencies, calls within
+     * a level become OpenMP sections with work vectors private to each section
+     */
+    void codegen_tasks(CodeGenerator& g) const;
+
+    /** \brief Instructions on each level of the task graph
+     * Levels respect the reuse of work vector elements, instructions within a level
+     * are independent of each other
+     */
+    std::vector<std::vector<casadi_int> > task_levels() const;
+
+    /** \brief Can instruction k be evaluated as an OpenMP task? */
+    bool is_task(casadi_int k) const;
+
     /** \brief Extract the residual function G and the modified function Z out of an expression
      * (see Albersmeyer2010 paper) */
     void generate_lifted(Function& vdef_fcn, Function& vinit_fcn) const override;
@@ -384,6 +384,8 @@ namespace casadi {
       return get_reshape(sparsity().T());
     } else if (sparsity().is_dense()) {
       return MX::create(new DenseTranspose(shared_from_this<MX>()));
+    } else if (sparsity().block_size()>1) {
+      return MX::create(new BlockTranspose(shared_from_this<MX>(), sparsity().block_size()));
     } else {
       return MX::create(new Transpose(shared_from_this<MX>()));
     }
@@ -414,6 +416,18 @@ namespace casadi {
       "Dimension error x.mac(z). Got y=" + str(y.size1()) + " and x" + x.dim() + ".");
     if (x.is_dense() && y.is_dense() && z.is_dense()) {
       return MX::create(new DenseMultiplication(z, x, y));
+    }
+    // Common block size of the factors (greatest common divisor), if any
+    casadi_int bs = x.sparsity().block_size();
+    for (casadi_int b : {y.sparsity().block_size(), z.sparsity().block_size()}) {
+      while (b!=0) {
+        casadi_int t = bs%b;
+        bs = b;
+        b = t;
+      }
+    }
+    if (bs>1) {
+      return MX::create(new BlockMultiplication(z, x, y, bs));
     } else {
       return MX::create(new Multiplication(z, x, y));
     }
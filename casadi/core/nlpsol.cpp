@@ -508,30 +508,8 @@ namespace casadi {
 
   void Nlpsol::bound_consistency(casadi_int n, double* x, double* lam,
                                  const double* lbx, const double* ubx) {
-    // NOTE: Move to C runtime?
     casadi_assert(x!=nullptr && lam!=nullptr, "Need x, lam");
-    // Local variables
-    casadi_int i;
-    double lb, ub;
-    // Loop over variables
-    for (i=0; i<n; ++i) {
-      // Get bounds
-      lb = lbx ? lbx[i] : 0.;
-      ub = ubx ? ubx[i] : 0.;
-      // Make sure bounds are respected
-      x[i] = std::fmin(std::fmax(x[i], lb), ub);
-      // Adjust multipliers
-      if (std::isinf(lb) && std::isinf(ub)) {
-        // Both multipliers are infinite
-        lam[i] = 0.;
-      } else if (std::isinf(lb) || x[i] - lb > ub - x[i]) {
-        // Infinite lower bound or closer to upper bound than lower bound
-        lam[i] = std::fmax(0., lam[i]);
-      } else if (std::isinf(ub) || x[i] - lb < ub - x[i]) {
-        // Infinite upper bound or closer to lower bound than upper bound
-        lam[i] = std::fmin(0., lam[i]);
-      }
-    }
+    casadi_bound_consistency(n, x, lam, lbx, ubx, inf);
   }
 
   int Nlpsol::eval(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const {
@@ -150,6 +150,7 @@ namespace casadi {
     // Default options
     iin_ = 0;
     iout_ = 0;
+    lazy_jacobian_ = false;
     // TODO(jgillis): remove hack in new release -- need uniform default.
     error_on_fail_ = name=="kinsol" ? true : false;
   }
@@ -186,10 +187,8 @@ namespace casadi {
 
   void Rootfinder::init(const Dict& opts) {
 
-    // Default (temporary) options
-    Dict linear_solver_options;
-    string linear_solver = "qr";
-    Function jac; // Jacobian of f with respect to z
+    // Default options
+    linear_solver_ = "qr";
 
     // Read options
     for (auto&& op : opts) {
@@ -198,11 +197,11 @@ namespace casadi {
       } else if (op.first=="implicit_output") {
         iout_ = op.second;
       } else if (op.first=="jacobian_function") {
-        jac = op.second;
+        jac_ = op.second;
       } else if (op.first=="linear_solver_options") {
-        linear_solver_options = op.second;
+        linear_solver_options_ = op.second;
       } else if (op.first=="linear_solver") {
-        linear_solver = op.second.to_string();
+        linear_solver_ = op.second.to_string();
       } else if (op.first=="constraints") {
         u_c_ = op.second;
       } else if (op.first=="error_on_fail") {
@@ -229,18 +228,11 @@ namespace casadi {
     // Call the base class initializer
     OracleFunction::init(opts);
 
-    // Generate Jacobian if not provided
-    if (jac.is_null()) jac = oracle_.jacobian_old(iin_, iout_);
-    set_function(jac, "jac_f_z");
-    sp_jac_ = jac.sparsity_out(0);
-
-    // Check for structural singularity in the Jacobian
-    casadi_assert(!sp_jac_.is_singular(),
-      "Rootfinder::init: singularity - the jacobian is structurally rank-deficient. "
-      "sprank(J)=" + str(sprank(sp_jac_)) + " (instead of " + str(sp_jac_.size1()) + ")");
-
-    // Get the linear solver creator function
-    linsol_ = Linsol("linsol", linear_solver, sp_jac_, linear_solver_options);
+    // Jacobian and linear solver, unless postponed by a matrix-free method
+    if (!lazy_jacobian_) {
+      set_function(get_jac(), "jac_f_z");
+      get_linsol();
+    }
 
     // Constraints
     casadi_assert(u_c_.size()==n_ || u_c_.empty(),
@@ -249,11 +241,29 @@ namespace casadi {
 
     // Allocate sufficiently large work vectors
     alloc(oracle_);
-    size_t sz_w = oracle_.sz_w();
-    if (!jac.is_null()) {
-      sz_w = max(sz_w, jac.sz_w());
+    alloc_w(oracle_.sz_w() + 2*static_cast<size_t>(n_));
+  }
+
+  const Function& Rootfinder::get_jac() const {
+    if (sp_jac_.is_null()) {
+      // Generate Jacobian if not provided
+      if (jac_.is_null()) jac_ = oracle_.jacobian_old(iin_, iout_);
+      sp_jac_ = jac_.sparsity_out(0);
+
+      // Check for structural singularity in the Jacobian
+      casadi_assert(!sp_jac_.is_singular(),
+        "Rootfinder::init: singularity - the jacobian is structurally rank-deficient. "
+        "sprank(J)=" + str(sprank(sp_jac_)) + " (instead of " + str(sp_jac_.size1()) + ")");
+    }
+    return jac_;
+  }
+
+  const Linsol& Rootfinder::get_linsol() const {
+    if (linsol_.is_null()) {
+      linsol_ = Linsol("linsol", linear_solver_, get_jac().sparsity_out(0),
+                       linear_solver_options_);
     }
-    alloc_w(sz_w + 2*static_cast<size_t>(n_));
+    return linsol_;
   }
 
   int Rootfinder::init_mem(void* mem) const {
@@ -364,7 +374,7 @@ namespace casadi {
 
     // "Solve" in order to propagate to z
     fill_n(tmp2, n_, 0);
-    sp_jac_.spsolve(tmp2, tmp1, false);
+    get_jac().sparsity_out(0).spsolve(tmp2, tmp1, false);
     if (res[iout_]) copy(tmp2, tmp2+n_, res[iout_]);
 
     // Propagate to auxiliary outputs
@@ -403,7 +413,7 @@ namespace casadi {
 
     // "Solve" in order to get seed
     fill_n(tmp2, n_, 0);
-    sp_jac_.spsolve(tmp2, tmp1, true);
+    get_jac().sparsity_out(0).spsolve(tmp2, tmp1, true);
 
     // Propagate dependencies through the function
     for (casadi_int i=0; i<n_out_; ++i) res1[i] = nullptr;
@@ -442,13 +452,12 @@ namespace casadi {
                           always_inline, never_inline);
 
     // Get expression of Jacobian
-    Function jac = get_function("jac_f_z");
-    MX J = jac(f_arg).front();
+    MX J = get_jac()(f_arg).front();
 
     // Solve for all the forward derivatives at once
     vector<MX> rhs(nfwd);
     for (casadi_int d=0; d<nfwd; ++d) rhs[d] = vec(fsens[d][iout_]);
-    rhs = horzsplit(J->get_solve(-horzcat(rhs), false, linsol_));
+    rhs = horzsplit(J->get_solve(-horzcat(rhs), false, get_linsol()));
     for (casadi_int d=0; d<nfwd; ++d) fsens[d][iout_] = reshape(rhs[d], size_in(iin_));
 
     // Propagate to auxiliary outputs
@@ -476,8 +485,7 @@ namespace casadi {
     // Get expression of Jacobian
     vector<MX> f_arg(arg);
     f_arg[iin_] = res.at(iout_);
-    Function jac = get_function("jac_f_z");
-    MX J = jac(f_arg).front();
+    MX J = get_jac()(f_arg).front();
 
     // Get adjoint seeds for calling f
     vector<MX> f_res(res);
@@ -499,7 +507,7 @@ namespace casadi {
     }
 
     // Solve for all the adjoint seeds at once
-    rhs = horzsplit(J->get_solve(-horzcat(rhs), true, linsol_));
+    rhs = horzsplit(J->get_solve(-horzcat(rhs), true, get_linsol()));
     for (casadi_int d=0; d<nadj; ++d) {
       for (casadi_int i=0; i<n_out_; ++i) {
         if (i==iout_) {
@@ -147,12 +147,26 @@ namespace casadi {
                          std::vector<std::vector<MX> >& asens,
                          bool always_inline, bool never_inline) const;
 
+    /// Jacobian of the residual with respect to the unknown, created on first use
+    const Function& get_jac() const;
+
+    /// Linear solver for the Jacobian, created on first use
+    const Linsol& get_linsol() const;
+
     /// Number of equations
     casadi_int n_;
 
-    /// Linear solver
-    Linsol linsol_;
-    Sparsity sp_jac_;
+    /// Jacobian, linear solver and Jacobian sparsity
+    mutable Function jac_;
+    mutable Linsol linsol_;
+    mutable Sparsity sp_jac_;
+
+    /// Linear solver and its options
+    std::string linear_solver_;
+    Dict linear_solver_options_;
+
+    /// Only create the Jacobian and the linear solver when needed, e.g. for sensitivities
+    bool lazy_jacobian_;
 
     /// Constraints on decision variables
     std::vector<casadi_int> u_c_;
@@ -0,0 +1,173 @@
+// NOLINT(legal/copyright)
+// SYMBOL "block_ldl"
+// Block LDL^T factorization with dense bs-by-bs blocks. sp_lt is the pattern of the
+// strictly upper blocks of L^T, p a permutation of the blocks. The blocks of lt are
+// stored contiguously, column-major. The diagonal blocks of D are factorized further
+// as L_c*diag(d_c)*L_c^T, with the unit lower L_c stored in dl, one block after another
+// len[lt] = bs*bs*nnz(sp_lt), len[dl] = n*bs, len[d] = n, len[w] = n*bs, n = bs*ncol(sp_lt)
+template<typename T1>
+void casadi_block_ldl(const casadi_int* sp_a, const T1* a, const casadi_int* sp_lt, T1* lt,
+                      T1* dl, T1* d, const casadi_int* p, T1* w, casadi_int bs) {
+  const casadi_int *lt_colind, *lt_row, *a_colind, *a_row;
+  casadi_int nb, n, bs2, r, c, q, k, k2, i, j, m, r1;
+  T1 s;
+  T1 *u, *wr, *dc, *dd;
+  const T1 *l, *wq, *lr, *dr;
+  // Extract sparsities
+  nb=sp_lt[1];
+  n=nb*bs;
+  bs2=bs*bs;
+  lt_colind=sp_lt+2; lt_row=sp_lt+2+nb+1;
+  a_colind=sp_a+2; a_row=sp_a+2+n+1;
+  // Clear w, n-by-bs, column-major
+  for (r=0; r<n*bs; ++r) w[r] = 0;
+  // Sparse copy of A to L and D
+  for (c=0; c<nb; ++c) {
+    r1 = p[c]*bs;
+    for (j=0; j<bs; ++j) {
+      for (k=a_colind[r1+j]; k<a_colind[r1+j+1]; ++k) w[a_row[k]+j*n] = a[k];
+    }
+    for (k=lt_colind[c]; k<lt_colind[c+1]; ++k) {
+      q = p[lt_row[k]]*bs;
+      for (j=0; j<bs; ++j) {
+        for (i=0; i<bs; ++i) lt[k*bs2+i+j*bs] = w[q+i+j*n];
+      }
+    }
+    for (j=0; j<bs; ++j) {
+      for (i=0; i<bs; ++i) dl[c*bs2+i+j*bs] = w[r1+i+j*n];
+    }
+    for (j=0; j<bs; ++j) {
+      for (k=a_colind[r1+j]; k<a_colind[r1+j+1]; ++k) w[a_row[k]+j*n] = 0;
+    }
+  }
+  // Loop over block columns of L^T
+  for (c=0; c<nb; ++c) {
+    dc = dl + c*bs2;
+    for (k=lt_colind[c]; k<lt_colind[c+1]; ++k) {
+      r = lt_row[k];
+      u = lt + k*bs2;
+      // Calculate the block D_r*l(c,r)^T with r<c
+      for (k2=lt_colind[r]; k2<lt_colind[r+1]; ++k2) {
+        l = lt + k2*bs2;
+        wq = w + lt_row[k2]*bs;
+        for (j=0; j<bs; ++j) {
+          for (i=0; i<bs; ++i) {
+            s = 0;
+            for (m=0; m<bs; ++m) s += l[m+i*bs]*wq[m+j*n];
+            u[i+j*bs] -= s;
+          }
+        }
+      }
+      wr = w + r*bs;
+      for (j=0; j<bs; ++j) {
+        for (i=0; i<bs; ++i) wr[i+j*n] = u[i+j*bs];
+      }
+      // Divide by D_r = L_r*diag(d_r)*L_r^T
+      lr = dl + r*bs2;
+      dr = d + r*bs;
+      for (j=0; j<bs; ++j) {
+        for (i=0; i<bs; ++i) {
+          for (m=0; m<i; ++m) u[i+j*bs] -= lr[i+m*bs]*u[m+j*bs];
+        }
+        for (i=0; i<bs; ++i) u[i+j*bs] /= dr[i];
+        for (i=bs-1; i>=0; --i) {
+          for (m=i+1; m<bs; ++m) u[i+j*bs] -= lr[m+i*bs]*u[m+j*bs];
+        }
+      }
+      // Update D_c
+      for (j=0; j<bs; ++j) {
+        for (i=0; i<bs; ++i) {
+          s = 0;
+          for (m=0; m<bs; ++m) s += wr[m+i*n]*u[m+j*bs];
+          dc[i+j*bs] -= s;
+        }
+      }
+    }
+    // Dense LDL^T factorization of D_c, without pivoting
+    dd = d + c*bs;
+    for (j=0; j<bs; ++j) {
+      dd[j] = dc[j+j*bs];
+      for (m=0; m<j; ++m) dd[j] -= dc[j+m*bs]*dc[j+m*bs]*dd[m];
+      for (i=j+1; i<bs; ++i) {
+        s = dc[i+j*bs];
+        for (m=0; m<j; ++m) s -= dc[i+m*bs]*dc[j+m*bs]*dd[m];
+        dc[i+j*bs] = s/dd[j];
+      }
+    }
+    // Clear w
+    for (k=lt_colind[c]; k<lt_colind[c+1]; ++k) {
+      wr = w + lt_row[k]*bs;
+      for (j=0; j<bs; ++j) {
+        for (i=0; i<bs; ++i) wr[i+j*n] = 0;
+      }
+    }
+  }
+}
+
+// SYMBOL "block_ldl_solve"
+// Linear solve using a block LDL^T factorized linear system
+// len[w] >= n
+template<typename T1>
+void casadi_block_ldl_solve(T1* x, casadi_int nrhs, const casadi_int* sp_lt, const T1* lt,
+                            const T1* dl, const T1* d, const casadi_int* p, T1* w,
+                            casadi_int bs) {
+  const casadi_int *lt_colind, *lt_row;
+  casadi_int nb, n, bs2, c, r, k, kk, i, m;
+  T1 s;
+  T1 *xk, *xc;
+  const T1 *l, *lc, *dc;
+  nb = sp_lt[1];
+  n = nb*bs;
+  bs2 = bs*bs;
+  lt_colind=sp_lt+2; lt_row=sp_lt+2+nb+1;
+  for (k=0; k<nrhs; ++k) {
+    xk = x + k*n;
+    // Multiply by P
+    for (c=0; c<nb; ++c) {
+      for (i=0; i<bs; ++i) w[c*bs+i] = xk[p[c]*bs+i];
+    }
+    for (i=0; i<n; ++i) xk[i] = w[i];
+    // Solve for the block unit lower triangular L
+    for (c=0; c<nb; ++c) {
+      for (kk=lt_colind[c]; kk<lt_colind[c+1]; ++kk) {
+        l = lt + kk*bs2;
+        r = lt_row[kk];
+        for (i=0; i<bs; ++i) {
+          s = 0;
+          for (m=0; m<bs; ++m) s += l[m+i*bs]*xk[r*bs+m];
+          xk[c*bs+i] -= s;
+        }
+      }
+    }
+    // Solve for the diagonal blocks D_c = L_c*diag(d_c)*L_c^T
+    for (c=0; c<nb; ++c) {
+      xc = xk + c*bs;
+      lc = dl + c*bs2;
+      dc = d + c*bs;
+      for (i=0; i<bs; ++i) {
+        for (m=0; m<i; ++m) xc[i] -= lc[i+m*bs]*xc[m];
+      }
+      for (i=0; i<bs; ++i) xc[i] /= dc[i];
+      for (i=bs-1; i>=0; --i) {
+        for (m=i+1; m<bs; ++m) xc[i] -= lc[m+i*bs]*xc[m];
+      }
+    }
+    // Solve for L^T
+    for (c=nb-1; c>=0; --c) {
+      for (kk=lt_colind[c+1]-1; kk>=lt_colind[c]; --kk) {
+        l = lt + kk*bs2;
+        r = lt_row[kk];
+        for (i=0; i<bs; ++i) {
+          s = 0;
+          for (m=0; m<bs; ++m) s += l[i+m*bs]*xk[c*bs+m];
+          xk[r*bs+i] -= s;
+        }
+      }
+    }
+    // Multiply by P'
+    for (i=0; i<n; ++i) w[i] = xk[i];
+    for (c=0; c<nb; ++c) {
+      for (i=0; i<bs; ++i) xk[p[c]*bs+i] = w[c*bs+i];
+    }
+  }
+}
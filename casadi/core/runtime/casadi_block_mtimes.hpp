@@ -0,0 +1,61 @@
+// NOLINT(legal/copyright)
+// SYMBOL "block_mtimes"
+template<typename T1>
+void casadi_block_mtimes(const T1* x, const casadi_int* sp_x, const T1* y, const casadi_int* sp_y, T1* z, const casadi_int* sp_z, T1* w, casadi_int bs) { // NOLINT(whitespace/line_length)
+  casadi_int ncol_x, ncol_y, ncol_z, nrow, cc, kk, kk1, i, j, c;
+  casadi_int nb_x, nb_y, nb_z;
+  const casadi_int *colind_x, *row_x, *colind_y, *row_y, *colind_z, *row_z;
+  const T1 *xb, *yb;
+  T1 *zb, *wb;
+
+  // Get block sparsities
+  ncol_x = sp_x[1];
+  colind_x = sp_x+2; row_x = sp_x + 2 + ncol_x+1;
+  ncol_y = sp_y[1];
+  colind_y = sp_y+2; row_y = sp_y + 2 + ncol_y+1;
+  ncol_z = sp_z[1];
+  colind_z = sp_z+2; row_z = sp_z + 2 + ncol_z+1;
+
+  // Number of rows in a column of z
+  nrow = sp_z[0]*bs;
+
+  // Loop over the block columns of y and z
+  for (cc=0; cc<ncol_y; ++cc) {
+    // Get the dense block column of z
+    nb_z = colind_z[cc+1]-colind_z[cc];
+    for (kk=colind_z[cc]; kk<colind_z[cc+1]; ++kk) {
+      zb = z + bs*bs*colind_z[cc] + (kk-colind_z[cc])*bs;
+      wb = w + row_z[kk]*bs;
+      for (c=0; c<bs; ++c) {
+        for (i=0; i<bs; ++i) wb[c*nrow+i] = zb[c*bs*nb_z+i];
+      }
+    }
+    // Loop over the blocks of y
+    nb_y = colind_y[cc+1]-colind_y[cc];
+    for (kk=colind_y[cc]; kk<colind_y[cc+1]; ++kk) {
+      casadi_int rr = row_y[kk];
+      yb = y + bs*bs*colind_y[cc] + (kk-colind_y[cc])*bs;
+      // Loop over corresponding block column of x
+      nb_x = colind_x[rr+1]-colind_x[rr];
+      for (kk1=colind_x[rr]; kk1<colind_x[rr+1]; ++kk1) {
+        xb = x + bs*bs*colind_x[rr] + (kk1-colind_x[rr])*bs;
+        wb = w + row_x[kk1]*bs;
+        // Dense block product
+        for (c=0; c<bs; ++c) {
+          for (j=0; j<bs; ++j) {
+            T1 yy = yb[c*bs*nb_y+j];
+            for (i=0; i<bs; ++i) wb[c*nrow+i] += xb[j*bs*nb_x+i]*yy;
+          }
+        }
+      }
+    }
+    // Get the sparse block column of z
+    for (kk=colind_z[cc]; kk<colind_z[cc+1]; ++kk) {
+      zb = z + bs*bs*colind_z[cc] + (kk-colind_z[cc])*bs;
+      wb = w + row_z[kk]*bs;
+      for (c=0; c<bs; ++c) {
+        for (i=0; i<bs; ++i) zb[c*bs*nb_z+i] = wb[c*nrow+i];
+      }
+    }
+  }
+}
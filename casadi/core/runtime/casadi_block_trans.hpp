@@ -0,0 +1,31 @@
+// NOLINT(legal/copyright)
+// SYMBOL "block_trans"
+template<typename T1>
+void casadi_block_trans(const T1* x, const casadi_int* sp_x, T1* y,
+    const casadi_int* sp_y, casadi_int* tmp, casadi_int bs) {
+  casadi_int ncol_x, ncol_y, cc, rr, kk, pos, nb_x, nb_y, i, j;
+  const casadi_int *colind_x, *row_x, *colind_y;
+  const T1* xb;
+  T1* yb;
+  // Get block sparsities
+  ncol_x = sp_x[1];
+  colind_x = sp_x+2; row_x = sp_x + 2 + ncol_x+1;
+  ncol_y = sp_y[1];
+  colind_y = sp_y+2;
+  for (cc=0; cc<ncol_y; ++cc) tmp[cc] = colind_y[cc];
+  // Loop over the blocks of x
+  for (cc=0; cc<ncol_x; ++cc) {
+    nb_x = colind_x[cc+1]-colind_x[cc];
+    for (kk=colind_x[cc]; kk<colind_x[cc+1]; ++kk) {
+      rr = row_x[kk];
+      pos = tmp[rr]++;
+      nb_y = colind_y[rr+1]-colind_y[rr];
+      xb = x + bs*bs*colind_x[cc] + (kk-colind_x[cc])*bs;
+      yb = y + bs*bs*colind_y[rr] + (pos-colind_y[rr])*bs;
+      // Dense block transpose
+      for (j=0; j<bs; ++j) {
+        for (i=0; i<bs; ++i) yb[i*bs*nb_y+j] = xb[j*bs*nb_x+i];
+      }
+    }
+  }
+}
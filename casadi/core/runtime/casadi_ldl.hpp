@@ -41,26 +41,38 @@ void casadi_ldl(const casadi_int* sp_a, const T1* a,
 }
 
 // SYMBOL "ldl_trs"
-// Solve for (I+R) with R an optionally transposed strictly upper triangular matrix.
+// Solve for (I+R) with R an optionally transposed strictly upper triangular matrix,
+// nrhs right-hand sides stored column-wise. Right-hand sides are processed in
+// panels of at most 8, so that each pass over the factor serves a full panel.
 template<typename T1>
-void casadi_ldl_trs(const casadi_int* sp_r, const T1* nz_r, T1* x, casadi_int tr) {
-  casadi_int ncol, c, k;
+void casadi_ldl_trs(const casadi_int* sp_r, const T1* nz_r, T1* x, casadi_int nrhs,
+                    casadi_int tr) {
+  casadi_int ncol, c, k, r, j, j0, j1;
+  T1 a;
   const casadi_int *colind, *row;
   // Extract sparsity
   ncol=sp_r[1];
   colind=sp_r+2; row=sp_r+2+ncol+1;
-  if (tr) {
-    // Forward substitution
-    for (c=0; c<ncol; ++c) {
-      for (k=colind[c]; k<colind[c+1]; ++k) {
-        x[c] -= nz_r[k]*x[row[k]];
+  // Loop over panels of right-hand sides
+  for (j0=0; j0<nrhs; j0=j1) {
+    j1 = j0+8<nrhs ? j0+8 : nrhs;
+    if (tr) {
+      // Forward substitution
+      for (c=0; c<ncol; ++c) {
+        for (k=colind[c]; k<colind[c+1]; ++k) {
+          a = nz_r[k];
+          r = row[k];
+          for (j=j0; j<j1; ++j) x[c+j*ncol] -= a*x[r+j*ncol];
+        }
       }
-    }
-  } else {
-    // Backward substitution
-    for (c=ncol-1; c>=0; --c) {
-      for (k=colind[c+1]-1; k>=colind[c]; --k) {
-        x[row[k]] -= nz_r[k]*x[c];
+    } else {
+      // Backward substitution
+      for (c=ncol-1; c>=0; --c) {
+        for (k=colind[c+1]-1; k>=colind[c]; --k) {
+          a = nz_r[k];
+          r = row[k];
+          for (j=j0; j<j1; ++j) x[r+j*ncol] -= a*x[c+j*ncol];
+        }
       }
     }
   }
@@ -73,19 +85,23 @@ void casadi_ldl_solve(T1* x, casadi_int nrhs, const casadi_int* sp_lt, const T1*
                       const T1* d, const casadi_int* p, T1* w) {
   casadi_int i, k;
   casadi_int n = sp_lt[1];
+  // P' L D L' P x = b <=> x = P' L' \ D \ L \ P b
+  // Multiply by P
+  for (k=0; k<nrhs; ++k) {
+    for (i=0; i<n; ++i) w[i] = x[p[i]+k*n];
+    for (i=0; i<n; ++i) x[i+k*n] = w[i];
+  }
+  //  Solve for L
+  casadi_ldl_trs(sp_lt, lt, x, nrhs, 1);
+  // Divide by D
+  for (k=0; k<nrhs; ++k) {
+    for (i=0; i<n; ++i) x[i+k*n] /= d[i];
+  }
+  // Solve for L'
+  casadi_ldl_trs(sp_lt, lt, x, nrhs, 0);
+  // Multiply by P'
   for (k=0; k<nrhs; ++k) {
-    // P' L D L' P x = b <=> x = P' L' \ D \ L \ P b
-    // Multiply by P
-    for (i=0; i<n; ++i) w[i] = x[p[i]];
-    //  Solve for L
-    casadi_ldl_trs(sp_lt, lt, w, 1);
-    // Divide by D
-    for (i=0; i<n; ++i) w[i] /= d[i];
-    // Solve for L'
-    casadi_ldl_trs(sp_lt, lt, w, 0);
-    // Multiply by P'
-    for (i=0; i<n; ++i) x[p[i]] = w[i];
-    // Next rhs
-    x += n;
+    for (i=0; i<n; ++i) w[i] = x[i+k*n];
+    for (i=0; i<n; ++i) x[p[i]+k*n] = w[i];
   }
 }
@@ -136,8 +136,8 @@ int casadi_qp_reset(casadi_qp_data<T1>* d) {
   for (i=0; i<p->nz; ++i) {
     // Permitted signs for lam
     d->neverzero[i] = d->lbz[i]==d->ubz[i];
-    d->neverupper[i] = isinf(d->ubz[i]);
-    d->neverlower[i] = isinf(d->lbz[i]);
+    d->neverupper[i] = fabs(d->ubz[i])==p->inf;
+    d->neverlower[i] = fabs(d->lbz[i])==p->inf;
     if (d->neverzero[i] && d->neverupper[i] && d->neverlower[i]) return 1;
     // Correct initial active set if required
     if (d->neverzero[i] && d->lam[i]==0.) {
@@ -193,6 +193,8 @@ void casadi_qp_du(casadi_qp_data<T1>* d) {
 }
 
 // SYMBOL "qp_log"
+// Pre-C99 compatibility, the messages are shorter than the buffer
+// C-REPLACE "vsnprintf(d->msg, sizeof(d->msg), fmt, args)" "vsprintf(d->msg, fmt, args)"
 template<typename T1>
 void casadi_qp_log(casadi_qp_data<T1>* d, const char* fmt, ...) {
   va_list args;
@@ -201,21 +203,6 @@ void casadi_qp_log(casadi_qp_data<T1>* d, const char* fmt, ...) {
   va_end(args);
 }
 
-// SYMBOL "qp_pr_index"
-template<typename T1>
-casadi_int casadi_qp_pr_index(casadi_qp_data<T1>* d, casadi_int* sign) {
-  // Try to improve primal feasibility by adding a constraint
-  if (d->lam[d->ipr]==0.) {
-    // Add the most violating constraint
-    *sign = d->z[d->ipr]<d->lbz[d->ipr] ? -1 : 1;
-    casadi_qp_log(d, "Added %lld to reduce |pr|", d->ipr);
-    return d->ipr;
-  } else {
-    // Try to remove blocking constraints
-    return casadi_qp_du_index(d, sign, d->ipr);
-  }
-}
-
 // SYMBOL "qp_du_check"
 template<typename T1>
 T1 casadi_qp_du_check(casadi_qp_data<T1>* d, casadi_int i) {
@@ -305,6 +292,21 @@ casadi_int casadi_qp_du_index(casadi_qp_data<T1>* d, casadi_int* sign, casadi_in
   }
 }
 
+// SYMBOL "qp_pr_index"
+template<typename T1>
+casadi_int casadi_qp_pr_index(casadi_qp_data<T1>* d, casadi_int* sign) {
+  // Try to improve primal feasibility by adding a constraint
+  if (d->lam[d->ipr]==0.) {
+    // Add the most violating constraint
+    *sign = d->z[d->ipr]<d->lbz[d->ipr] ? -1 : 1;
+    casadi_qp_log(d, "Added %lld to reduce |pr|", d->ipr);
+    return d->ipr;
+  } else {
+    // Try to remove blocking constraints
+    return casadi_qp_du_index(d, sign, d->ipr);
+  }
+}
+
 // SYMBOL "qp_kkt"
 template<typename T1>
 void casadi_qp_kkt(casadi_qp_data<T1>* d) {
@@ -620,7 +622,7 @@ int casadi_qp_flip_check(casadi_qp_data<T1>* d, casadi_int index, casadi_int sig
   // Find best constraint we can flip, if any
   *r_index=-1;
   *r_sign=0;
-  best = inf;
+  best = p->inf;
   for (i=0; i<p->nz; ++i) {
     // Can't be the same
     if (i==index) continue;
@@ -911,6 +913,7 @@ void casadi_qp_calc_dependent(casadi_qp_data<T1>* d) {
   }
 }
 
+// SYMBOL "qp_linesearch"
 template<typename T1>
 void casadi_qp_linesearch(casadi_qp_data<T1>* d, casadi_int* index, casadi_int* sign) {
   // Start with a full step and no active set change
@@ -928,6 +931,7 @@ void casadi_qp_linesearch(casadi_qp_data<T1>* d, casadi_int* index, casadi_int*
   casadi_qp_take_step(d);
 }
 
+// SYMBOL "qp_flip"
 template<typename T1>
 void casadi_qp_flip(casadi_qp_data<T1>* d, casadi_int *index, casadi_int *sign,
                                           casadi_int r_index, casadi_int r_sign) {
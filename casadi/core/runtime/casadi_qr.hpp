@@ -81,61 +81,77 @@ void casadi_qr(const casadi_int* sp_a, const T1* nz_a, T1* x,
 // by the Householder vectors V and beta
 // x = Q*x or x = Q'*x
 // with Q = (I-beta(1)*v(:,1)*v(:,1)')*...*(I-beta(n)*v(:,n)*v(:,n)')
-// len[x] >= nrow_ext
+// nrhs vectors of length nrow_ext, stored column-wise
 template<typename T1>
 void casadi_qr_mv(const casadi_int* sp_v, const T1* v, const T1* beta, T1* x,
-                  casadi_int tr) {
+                  casadi_int nrhs, casadi_int tr) {
   // Local variables
-  casadi_int ncol, c, c1, k;
-  T1 alpha;
+  casadi_int nrow_ext, ncol, c, c1, k, j, j0, j1;
+  T1 alpha, *xj;
   const casadi_int *colind, *row;
   // Extract sparsity
-  ncol=sp_v[1];
+  nrow_ext=sp_v[0]; ncol=sp_v[1];
   colind=sp_v+2; row=sp_v+2+ncol+1;
-  // Loop over vectors
-  for (c1=0; c1<ncol; ++c1) {
-    // Forward order for transpose, otherwise backwards
-    c = tr ? c1 : ncol-1-c1;
-    // Calculate scalar factor alpha = beta(c)*dot(v(:,c), x)
-    alpha=0;
-    for (k=colind[c]; k<colind[c+1]; ++k) alpha += v[k]*x[row[k]];
-    alpha *= beta[c];
-    // x -= alpha*v(:,c)
-    for (k=colind[c]; k<colind[c+1]; ++k) x[row[k]] -= alpha*v[k];
+  // Loop over panels of at most 8 vectors
+  for (j0=0; j0<nrhs; j0=j1) {
+    j1 = j0+8<nrhs ? j0+8 : nrhs;
+    // Loop over Householder vectors
+    for (c1=0; c1<ncol; ++c1) {
+      // Forward order for transpose, otherwise backwards
+      c = tr ? c1 : ncol-1-c1;
+      for (j=j0; j<j1; ++j) {
+        xj = x + j*nrow_ext;
+        // Calculate scalar factor alpha = beta(c)*dot(v(:,c), x)
+        alpha=0;
+        for (k=colind[c]; k<colind[c+1]; ++k) alpha += v[k]*xj[row[k]];
+        alpha *= beta[c];
+        // x -= alpha*v(:,c)
+        for (k=colind[c]; k<colind[c+1]; ++k) xj[row[k]] -= alpha*v[k];
+      }
+    }
   }
 }
 
 // SYMBOL "qr_trs"
-// Solve for an (optionally transposed) upper triangular matrix R
+// Solve for an (optionally transposed) upper triangular matrix R,
+// nrhs right-hand sides stored column-wise with leading dimension ld
 template<typename T1>
-void casadi_qr_trs(const casadi_int* sp_r, const T1* nz_r, T1* x, casadi_int tr) {
+void casadi_qr_trs(const casadi_int* sp_r, const T1* nz_r, T1* x, casadi_int nrhs,
+                   casadi_int ld, casadi_int tr) {
   // Local variables
-  casadi_int ncol, r, c, k;
+  casadi_int ncol, r, c, k, j, j0, j1;
+  T1 a;
   const casadi_int *colind, *row;
   // Extract sparsity
   ncol=sp_r[1];
   colind=sp_r+2; row=sp_r+2+ncol+1;
-  if (tr) {
-    // Forward substitution
-    for (c=0; c<ncol; ++c) {
-      for (k=colind[c]; k<colind[c+1]; ++k) {
-        r = row[k];
-        if (r==c) {
-          x[c] /= nz_r[k];
-        } else {
-          x[c] -= nz_r[k]*x[r];
+  // Loop over panels of at most 8 right-hand sides
+  for (j0=0; j0<nrhs; j0=j1) {
+    j1 = j0+8<nrhs ? j0+8 : nrhs;
+    if (tr) {
+      // Forward substitution
+      for (c=0; c<ncol; ++c) {
+        for (k=colind[c]; k<colind[c+1]; ++k) {
+          r = row[k];
+          a = nz_r[k];
+          if (r==c) {
+            for (j=j0; j<j1; ++j) x[c+j*ld] /= a;
+          } else {
+            for (j=j0; j<j1; ++j) x[c+j*ld] -= a*x[r+j*ld];
+          }
         }
       }
-    }
-  } else {
-    // Backward substitution
-    for (c=ncol-1; c>=0; --c) {
-      for (k=colind[c+1]-1; k>=colind[c]; --k) {
-        r=row[k];
-        if (r==c) {
-          x[r] /= nz_r[k];
-        } else {
-          x[r] -= nz_r[k]*x[c];
+    } else {
+      // Backward substitution
+      for (c=ncol-1; c>=0; --c) {
+        for (k=colind[c+1]-1; k>=colind[c]; --k) {
+          r = row[k];
+          a = nz_r[k];
+          if (r==c) {
+            for (j=j0; j<j1; ++j) x[r+j*ld] /= a;
+          } else {
+            for (j=j0; j<j1; ++j) x[r+j*ld] -= a*x[c+j*ld];
+          }
         }
       }
     }
@@ -151,15 +167,53 @@ void casadi_qr_solve(T1* x, casadi_int nrhs, casadi_int tr,
                      const T1* beta, const casadi_int* prinv, const casadi_int* pc, T1* w) {
   casadi_int k, c, nrow_ext, ncol;
   nrow_ext = sp_v[0]; ncol = sp_v[1];
+  if (nrow_ext==ncol) {
+    // All right-hand sides at once, permutations in-place
+    if (tr) {
+      // (PR' Q R PC)' x = PC' R' Q' PR x = b <-> x = PR' Q R' \ PC b
+      // Multiply by PC
+      for (k=0; k<nrhs; ++k) {
+        for (c=0; c<ncol; ++c) w[c] = x[pc[c]+k*ncol];
+        for (c=0; c<ncol; ++c) x[c+k*ncol] = w[c];
+      }
+      //  Solve for R'
+      casadi_qr_trs(sp_r, r, x, nrhs, ncol, 1);
+      // Multiply by Q
+      casadi_qr_mv(sp_v, v, beta, x, nrhs, 0);
+      // Multiply by PR'
+      for (k=0; k<nrhs; ++k) {
+        for (c=0; c<ncol; ++c) w[c] = x[prinv[c]+k*ncol];
+        for (c=0; c<ncol; ++c) x[c+k*ncol] = w[c];
+      }
+    } else {
+      //PR' Q R PC x = b <-> x = PC' R \ Q' PR b
+      // Multiply with PR
+      for (k=0; k<nrhs; ++k) {
+        for (c=0; c<ncol; ++c) w[prinv[c]] = x[c+k*ncol];
+        for (c=0; c<ncol; ++c) x[c+k*ncol] = w[c];
+      }
+      // Multiply with Q'
+      casadi_qr_mv(sp_v, v, beta, x, nrhs, 1);
+      //  Solve for R
+      casadi_qr_trs(sp_r, r, x, nrhs, ncol, 0);
+      // Multiply with PC'
+      for (k=0; k<nrhs; ++k) {
+        for (c=0; c<ncol; ++c) w[pc[c]] = x[c+k*ncol];
+        for (c=0; c<ncol; ++c) x[c+k*ncol] = w[c];
+      }
+    }
+    return;
+  }
+  // Structurally rank-deficient: one right-hand side at a time in w
   for (k=0; k<nrhs; ++k) {
     if (tr) {
       // (PR' Q R PC)' x = PC' R' Q' PR x = b <-> x = PR' Q R' \ PC b
       // Multiply by PC
       for (c=0; c<ncol; ++c) w[c] = x[pc[c]];
       //  Solve for R'
-      casadi_qr_trs(sp_r, r, w, 1);
+      casadi_qr_trs(sp_r, r, w, 1, ncol, 1);
       // Multiply by Q
-      casadi_qr_mv(sp_v, v, beta, w, 0);
+      casadi_qr_mv(sp_v, v, beta, w, 1, 0);
       // Multiply by PR'
       for (c=0; c<ncol; ++c) x[c] = w[prinv[c]];
     } else {
@@ -168,9 +222,9 @@ void casadi_qr_solve(T1* x, casadi_int nrhs, casadi_int tr,
       for (c=0; c<nrow_ext; ++c) w[c] = 0;
       for (c=0; c<ncol; ++c) w[prinv[c]] = x[c];
       // Multiply with Q'
-      casadi_qr_mv(sp_v, v, beta, w, 1);
+      casadi_qr_mv(sp_v, v, beta, w, 1, 1);
       //  Solve for R
-      casadi_qr_trs(sp_r, r, w, 0);
+      casadi_qr_trs(sp_r, r, w, 1, ncol, 0);
       // Multiply with PC'
       for (c=0; c<ncol; ++c) x[pc[c]] = w[c];
     }
@@ -1,4 +1,6 @@
 // NOLINT(legal/copyright)
+// C-REPLACE "std::fabs" "fabs"
+// C-REPLACE "std::fmin" "casadi_fmin"
 // SYMBOL "lb_eig"
 // Use Gershgorin to finds upper and lower bounds on the eigenvalues
 template<typename T1>
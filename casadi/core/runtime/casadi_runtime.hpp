@@ -86,10 +86,21 @@ namespace casadi {
   void casadi_mtimes(const T1* x, const casadi_int* sp_x, const T1* y, const casadi_int* sp_y,
                              T1* z, const casadi_int* sp_z, T1* w, casadi_int tr);
 
+  /// Block-sparse matrix-matrix multiplication: z <- z + x*y, sparsities of the blocks
+  template<typename T1>
+  void casadi_block_mtimes(const T1* x, const casadi_int* sp_x, const T1* y,
+                           const casadi_int* sp_y, T1* z, const casadi_int* sp_z,
+                           T1* w, casadi_int bs);
+
   /// Sparse matrix-vector multiplication: z <- z + x*y
   template<typename T1>
   void casadi_mv(const T1* x, const casadi_int* sp_x, const T1* y, T1* z, casadi_int tr);
 
+  /// Block-sparse transpose: y <- trans(x), sparsities of the blocks, tmp of length >= rows x
+  template<typename T1>
+  void casadi_block_trans(const T1* x, const casadi_int* sp_x, T1* y,
+                          const casadi_int* sp_y, casadi_int* tmp, casadi_int bs);
+
   /// TRANS: y <- trans(x) , w work vector (length >= rows x)
   template<typename T1>
   void casadi_trans(const T1* x, const casadi_int* sp_x, T1* y, const casadi_int* sp_y,
@@ -179,6 +190,11 @@ namespace casadi {
   template<typename T1>
   T1 casadi_mmax(const T1* x, casadi_int n, casadi_int is_dense);
 
+  // Make an optimal solution consistent with the bounds
+  template<typename T1>
+  void casadi_bound_consistency(casadi_int n, T1* x, T1* lam,
+                                const T1* lbx, const T1* ubx, T1 inf);
+
   template<typename T1>
   T1 casadi_mmin(const T1* x, casadi_int n, casadi_int is_dense);
 
@@ -216,8 +232,10 @@ namespace casadi {
   #include "casadi_minmax.hpp"
   #include "casadi_sum_viol.hpp"
   #include "casadi_mtimes.hpp"
+  #include "casadi_block_mtimes.hpp"
   #include "casadi_mv.hpp"
   #include "casadi_trans.hpp"
+  #include "casadi_block_trans.hpp"
   #include "casadi_norm_1.hpp"
   #include "casadi_norm_2.hpp"
   #include "casadi_norm_inf.hpp"
@@ -236,10 +254,12 @@ namespace casadi {
   #include "casadi_mv_dense.hpp"
   #include "casadi_finite_diff.hpp"
   #include "casadi_ldl.hpp"
+  #include "casadi_block_ldl.hpp"
   #include "casadi_qr.hpp"
   #include "casadi_bfgs.hpp"
   #include "casadi_regularize.hpp"
   #include "casadi_newton.hpp"
+  #include "casadi_bound_consistency.hpp"
 } // namespace casadi
 
 /// \endcond
@@ -277,6 +277,22 @@ namespace casadi {
     return (*this)->is_diag();
   }
 
+  bool Sparsity::is_blocked(casadi_int bs) const {
+    return (*this)->is_blocked(bs);
+  }
+
+  casadi_int Sparsity::block_size() const {
+    return (*this)->block_size();
+  }
+
+  Sparsity Sparsity::block_compress(casadi_int bs) const {
+    return (*this)->block_compress(bs);
+  }
+
+  Sparsity Sparsity::block_expand(casadi_int bs) const {
+    return kron(*this, dense(bs, bs));
+  }
+
   bool Sparsity::is_row() const {
     return (*this)->is_row();
   }
@@ -721,14 +737,20 @@ namespace casadi {
     (*this)->get_nz(indices);
   }
 
-  Sparsity Sparsity::uni_coloring(const Sparsity& AT, casadi_int cutoff) const {
+  Sparsity Sparsity::uni_coloring(const Sparsity& AT, casadi_int cutoff,
+                                  casadi_int ordering) const {
     if (AT.is_null()) {
-      return (*this)->uni_coloring(T(), cutoff);
+      return (*this)->uni_coloring(T(), cutoff, ordering);
     } else {
-      return (*this)->uni_coloring(AT, cutoff);
+      return (*this)->uni_coloring(AT, cutoff, ordering);
     }
   }
 
+  void Sparsity::bi_coloring(Sparsity& D1, Sparsity& D2, double w, double cutoff,
+                             casadi_int ordering) const {
+    (*this)->bi_coloring(D1, D2, w, cutoff, ordering);
+  }
+
   Sparsity Sparsity::star_coloring(casadi_int ordering, casadi_int cutoff) const {
     return (*this)->star_coloring(ordering, cutoff);
   }
@@ -741,6 +763,26 @@ namespace casadi {
     return (*this)->largest_first();
   }
 
+  std::vector<casadi_int> Sparsity::smallest_last() const {
+    return (*this)->dynamic_ordering(2);
+  }
+
+  std::vector<casadi_int> Sparsity::incidence_degree() const {
+    return (*this)->dynamic_ordering(3);
+  }
+
+  std::vector<casadi_int> Sparsity::dynamic_largest_first() const {
+    return (*this)->dynamic_ordering(4);
+  }
+
+  std::vector<casadi_int> Sparsity::coloring_ordering(casadi_int ordering) const {
+    return (*this)->coloring_ordering(ordering);
+  }
+
+  casadi_int Sparsity::coloring_lower_bound(bool symmetric) const {
+    return (*this)->coloring_lower_bound(symmetric);
+  }
+
   Sparsity Sparsity::pmult(const std::vector<casadi_int>& p, bool permute_rows,
                             bool permute_columns, bool invert_permutation) const {
     return (*this)->pmult(p, permute_rows, permute_columns, invert_permutation);
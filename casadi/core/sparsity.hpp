@@ -620,6 +620,24 @@ namespace casadi {
     /// Is square?
     bool is_square() const;
 
+    /// Does the pattern consist of dense, aligned bs-by-bs blocks?
+    bool is_blocked(casadi_int bs) const;
+
+    /** \brief Largest size bs such that the pattern consists of dense, aligned
+        bs-by-bs blocks, 1 if there is no such blocking
+        Calculated on first call, then cached. */
+    casadi_int block_size() const;
+
+    /** \brief Pattern of the blocks of a blocked pattern
+        The nonzeros of a blocked pattern can be addressed with the block pattern:
+        block k in block column cb occupies, for each of its columns j, bs consecutive
+        nonzeros starting at bs*bs*colind_b[cb] + j*bs*nb + (k-colind_b[cb])*bs,
+        with nb the number of blocks in the block column. */
+    Sparsity block_compress(casadi_int bs) const;
+
+    /// Replace each nonzero with a dense bs-by-bs block, inverse of block_compress
+    Sparsity block_expand(casadi_int bs) const;
+
     /// Is symmetric?
     bool is_symmetric() const;
 
@@ -788,7 +806,22 @@ namespace casadi {
     /** \brief Perform a unidirectional coloring: A greedy distance-2 coloring algorithm
         (Algorithm 3.1 in A. H. GEBREMEDHIN, F. MANNE, A. POTHEN) */
     Sparsity uni_coloring(const Sparsity& AT=Sparsity(),
-                          casadi_int cutoff = std::numeric_limits<casadi_int>::max()) const;
+                          casadi_int cutoff = std::numeric_limits<casadi_int>::max(),
+                          casadi_int ordering = 0) const;
+
+#ifndef SWIG
+    /** \brief Perform a bidirectional coloring (bicoloring) of a Jacobian pattern
+
+        Rows with many nonzeros are determined by adjoint sweeps, D2 being a coloring
+        of these rows. All other rows are determined by forward sweeps, D1 being a
+        coloring of the columns of the pattern without the adjoint rows.
+        The number of rows treated in adjoint mode is chosen to minimize
+        w*size2(D1) + (1-w)*size2(D2). If no partition with a lower cost than
+        cutoff is found, D1 and D2 are null. */
+    void bi_coloring(Sparsity& D1, Sparsity& D2, double w=0.5,
+                     double cutoff=std::numeric_limits<double>::infinity(),
+                     casadi_int ordering=0) const;
+#endif // SWIG
 
     /** \brief Perform a star coloring of a symmetric matrix:
         A greedy distance-2 coloring algorithm
@@ -797,7 +830,8 @@ namespace casadi {
           A. H. GEBREMEDHIN, F. MANNE, A. POTHEN
           SIAM Rev., 47(4), 629–705 (2006)
 
-        Ordering options: None (0), largest first (1)
+        Ordering options: None (0), largest first (1), smallest last (2),
+        incidence degree (3), dynamic largest first (4), best of all (-1)
     */
     Sparsity star_coloring(casadi_int ordering = 1,
                             casadi_int cutoff = std::numeric_limits<casadi_int>::max()) const;
@@ -809,7 +843,8 @@ namespace casadi {
           A. H. GEBREMEDHIN, A. TARAFDAR, F. MANNE, A. POTHEN
           SIAM J. SCI. COMPUT. Vol. 29, No. 3, pp. 1042–1072 (2007)
 
-        Ordering options: None (0), largest first (1)
+        Ordering options: None (0), largest first (1), smallest last (2),
+        incidence degree (3), dynamic largest first (4), best of all (-1)
     */
     Sparsity star_coloring2(casadi_int ordering = 1,
                             casadi_int cutoff = std::numeric_limits<casadi_int>::max()) const;
@@ -817,6 +852,31 @@ namespace casadi {
     /** \brief Order the columns by decreasing degree */
     std::vector<casadi_int> largest_first() const;
 
+    /** \brief Smallest last ordering of a symmetric matrix:
+        Repeatedly remove the column with the smallest degree in the remaining graph,
+        the columns are ordered in the reverse order of removal */
+    std::vector<casadi_int> smallest_last() const;
+
+    /** \brief Incidence degree ordering of a symmetric matrix:
+        Next column is the one with the largest number of already ordered neighbors */
+    std::vector<casadi_int> incidence_degree() const;
+
+    /** \brief Dynamic largest first ordering of a symmetric matrix:
+        Next column is the one with the largest degree among the columns not yet ordered */
+    std::vector<casadi_int> dynamic_largest_first() const;
+
+    /** \brief Get a column ordering for coloring
+        Ordering options: None (0), largest first (1), smallest last (2),
+        incidence degree (3), dynamic largest first (4)
+    */
+    std::vector<casadi_int> coloring_ordering(casadi_int ordering) const;
+
+    /** \brief Lower bound on the number of colors in a coloring
+        Unidirectional: the maximum number of nonzeros in a row,
+        symmetric (star coloring): the size of the largest dense principal block
+        with consecutive indices */
+    casadi_int coloring_lower_bound(bool symmetric=false) const;
+
     /** \brief Permute rows and/or columns
         Multiply the sparsity with a permutation matrix from the left and/or from the right
         P * A * trans(P), A * trans(P) or A * trans(P) with P defined by an index vector
@@ -452,7 +452,7 @@ namespace casadi {
   SparsityInternal::
   SparsityInternal(casadi_int nrow, casadi_int ncol,
       const casadi_int* colind, const casadi_int* row) :
-    sp_(2 + ncol+1 + colind[ncol]), btf_(nullptr) {
+    sp_(2 + ncol+1 + colind[ncol]), btf_(nullptr), block_size_(-1) {
     sp_[0] = nrow;
     sp_[1] = ncol;
     std::copy(colind, colind+ncol+1, sp_.begin()+2);
@@ -1800,6 +1800,75 @@ namespace casadi {
     return both ? size2()==0 && size1()==0 : size2()==0 || size1()==0;
   }
 
+  bool SparsityInternal::is_blocked(casadi_int bs) const {
+    // Check dimensions
+    if (bs<1 || size1()%bs!=0 || size2()%bs!=0 || nnz()%(bs*bs)!=0) return false;
+    const casadi_int* colind = this->colind();
+    const casadi_int* row = this->row();
+
+    // Loop over columns
+    for (casadi_int c=0; c<size2(); ++c) {
+      // First column in the block column
+      casadi_int c0 = c - c%bs;
+      if (c==c0) {
+        // Rows must come in complete, aligned groups
+        if ((colind[c+1]-colind[c])%bs!=0) return false;
+        for (casadi_int k=colind[c]; k<colind[c+1]; k+=bs) {
+          if (row[k]%bs!=0) return false;
+          for (casadi_int j=1; j<bs; ++j) {
+            if (row[k+j]!=row[k]+j) return false;
+          }
+        }
+      } else {
+        // Same rows as the first column in the block column
+        if (colind[c+1]-colind[c]!=colind[c0+1]-colind[c0]) return false;
+        for (casadi_int k=0; k<colind[c+1]-colind[c]; ++k) {
+          if (row[colind[c]+k]!=row[colind[c0]+k]) return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  casadi_int SparsityInternal::block_size() const {
+    if (block_size_<0) {
+      block_size_ = 1;
+      if (nnz()>0) {
+        // Greatest common divisor of the dimensions
+        casadi_int a = size1(), b = size2();
+        while (b!=0) {
+          casadi_int t = a%b;
+          a = b;
+          b = t;
+        }
+        // Largest admissible block size first
+        for (casadi_int bs=a; bs>1; --bs) {
+          if (a%bs==0 && is_blocked(bs)) {
+            block_size_ = bs;
+            break;
+          }
+        }
+      }
+    }
+    return block_size_;
+  }
+
+  Sparsity SparsityInternal::block_compress(casadi_int bs) const {
+    casadi_assert(is_blocked(bs), "Pattern " + dim() + " does not consist of dense, aligned "
+                  + str(bs) + "-by-" + str(bs) + " blocks");
+    const casadi_int* colind = this->colind();
+    const casadi_int* row = this->row();
+    casadi_int ncol = size2()/bs;
+    vector<casadi_int> ret_colind(ncol+1, 0), ret_row;
+    ret_row.reserve(nnz()/(bs*bs));
+    for (casadi_int cb=0; cb<ncol; ++cb) {
+      casadi_int c = cb*bs;
+      for (casadi_int k=colind[c]; k<colind[c+1]; k+=bs) ret_row.push_back(row[k]/bs);
+      ret_colind[cb+1] = ret_row.size();
+    }
+    return Sparsity(size1()/bs, ncol, ret_colind, ret_row);
+  }
+
   bool SparsityInternal::is_diag() const {
     const casadi_int* colind = this->colind();
     const casadi_int* row = this->row();
@@ -2887,7 +2956,42 @@ namespace casadi {
     fill(it, indices.end(), -1);
   }
 
-  Sparsity SparsityInternal::uni_coloring(const Sparsity& AT, casadi_int cutoff) const {
+  Sparsity SparsityInternal::uni_coloring(const Sparsity& AT, casadi_int cutoff,
+                                          casadi_int ordering) const {
+    // Try all orderings and keep the coloring with the fewest colors
+    if (ordering<0) {
+      casadi_int lb = coloring_lower_bound(false);
+      Sparsity best;
+      for (casadi_int ord=0; ord<=4; ++ord) {
+        Sparsity D = uni_coloring(AT, cutoff, ord);
+        if (D.is_null()) continue;
+        best = D;
+        // Only look for strictly better colorings from now on
+        cutoff = D.size2()-1;
+        if (D.size2()<=lb) break;
+      }
+      return best;
+    }
+
+    // Reorder, if necessary
+    if (ordering!=0) {
+      // A row with more than cutoff nonzeros needs more than cutoff colors
+      if (coloring_lower_bound(false)>cutoff) return Sparsity();
+
+      // Orderings are calculated for the column intersection graph
+      vector<casadi_int> ord = coloring_ordering(ordering, AT);
+
+      // Create new sparsity patterns with the columns permuted
+      Sparsity sp_permuted = pmult(ord, false, true, true);
+      Sparsity spT_permuted = AT.pmult(ord, true, false, true);
+
+      // Coloring for the permuted matrix
+      Sparsity ret_permuted = sp_permuted.uni_coloring(spT_permuted, cutoff, 0);
+      if (ret_permuted.is_null()) return ret_permuted;
+
+      // Permute result back
+      return ret_permuted.pmult(ord, true, false, false);
+    }
 
     // Allocate temporary vectors
     vector<casadi_int> forbiddenColors;
@@ -2976,27 +3080,122 @@ namespace casadi {
 ;
   }
 
+  void SparsityInternal::bi_coloring(Sparsity& D1, Sparsity& D2, double w, double cutoff,
+                                     casadi_int ordering) const {
+    casadi_assert(w>0 && w<1, "Bidirectional coloring requires 0 < w < 1");
+    const casadi_int* colind = this->colind();
+    const casadi_int* row = this->row();
+    D1 = D2 = Sparsity();
+
+    // Number of nonzeros in each row
+    vector<casadi_int> row_count(size1(), 0);
+    for (casadi_int k=0; k<nnz(); ++k) row_count[row[k]]++;
+
+    // Candidate thresholds for treating a row in adjoint mode, in decreasing order
+    vector<casadi_int> thresholds = row_count;
+    sort(thresholds.rbegin(), thresholds.rend());
+    thresholds.erase(unique(thresholds.begin(), thresholds.end()), thresholds.end());
+    if (!thresholds.empty() && thresholds.back()==0) thresholds.pop_back();
+
+    // Split patterns
+    vector<casadi_int> f_colind(size2()+1), f_row, a_colind(size2()+1), a_row;
+    f_row.reserve(nnz());
+    a_row.reserve(nnz());
+
+    // Best cost so far
+    double best = cutoff;
+
+    // Treat more and more rows in adjoint mode
+    for (casadi_int t : thresholds) {
+      // Split the nonzeros into adjoint rows and forward rows
+      f_row.clear();
+      a_row.clear();
+      f_colind[0] = a_colind[0] = 0;
+      for (casadi_int c=0; c<size2(); ++c) {
+        for (casadi_int el=colind[c]; el<colind[c+1]; ++el) {
+          if (row_count[row[el]]>=t) {
+            a_row.push_back(row[el]);
+          } else {
+            f_row.push_back(row[el]);
+          }
+        }
+        f_colind[c+1] = f_row.size();
+        a_colind[c+1] = a_row.size();
+      }
+      Sparsity Jf(size1(), size2(), f_colind, f_row);
+      Sparsity Ja(size1(), size2(), a_colind, a_row);
+
+      // Color the adjoint rows
+      Sparsity JaT = Ja.T();
+      Sparsity Da = JaT.uni_coloring(Ja, std::numeric_limits<casadi_int>::max(), ordering);
+
+      // Drop the forward rows, remove colors that become empty
+      vector<casadi_int> da_colind(1, 0), da_row;
+      for (casadi_int c=0; c<Da.size2(); ++c) {
+        for (casadi_int el=Da.colind(c); el<Da.colind(c+1); ++el) {
+          if (row_count[Da.row(el)]>=t) da_row.push_back(Da.row(el));
+        }
+        if (da_row.size()>da_colind.back()) da_colind.push_back(da_row.size());
+      }
+      Da = Sparsity(size1(), da_colind.size()-1, da_colind, da_row);
+
+      // Adding more adjoint rows is unlikely to pay off
+      double cost_a = (1-w)*static_cast<double>(Da.size2());
+      if (cost_a>=best) break;
+
+      // Color the columns for the remaining rows, only accept strict improvements
+      double max_f = ceil((best-cost_a)/w) - 1;
+      casadi_int cutoff_f = max_f>=static_cast<double>(size2()) ? size2()
+        : static_cast<casadi_int>(max_f);
+      if (cutoff_f<0) continue;
+      Sparsity Df = Jf.uni_coloring(Jf.T(), cutoff_f, ordering);
+      if (Df.is_null()) continue;
+
+      // Keep if better
+      double cost = cost_a + w*static_cast<double>(Df.size2());
+      if (cost<best) {
+        best = cost;
+        D1 = Df;
+        D2 = Da;
+      }
+    }
+  }
+
   Sparsity SparsityInternal::star_coloring2(casadi_int ordering, casadi_int cutoff) const {
     if (!is_square()) {
       // NOTE(@jaeandersson) Why warning and not error?
       casadi_message("StarColoring requires a square matrix, got " + dim() + ".");
     }
 
+    // Try all orderings and keep the coloring with the fewest colors
+    if (ordering<0) {
+      casadi_int lb = coloring_lower_bound(true);
+      Sparsity best;
+      for (casadi_int ord=0; ord<=4; ++ord) {
+        Sparsity D = star_coloring2(ord, cutoff);
+        if (D.is_null()) continue;
+        best = D;
+        // Only look for strictly better colorings from now on
+        cutoff = D.size2()-1;
+        if (D.size2()<=lb) break;
+      }
+      return best;
+    }
+
     // TODO(Joel): What we need here, is a distance-2 smallest last ordering
     // Reorder, if necessary
     const casadi_int* colind = this->colind();
     const casadi_int* row = this->row();
     if (ordering!=0) {
-      casadi_assert_dev(ordering==1);
-
       // Ordering
-      vector<casadi_int> ord = largest_first();
+      vector<casadi_int> ord = coloring_ordering(ordering);
 
       // Create a new sparsity pattern
       Sparsity sp_permuted = pmult(ord, true, true, true);
 
       // Star coloring for the permuted matrix
-      Sparsity ret_permuted = sp_permuted.star_coloring2(0);
+      Sparsity ret_permuted = sp_permuted.star_coloring2(0, cutoff);
+      if (ret_permuted.is_null()) return ret_permuted;
 
       // Permute result back
       return ret_permuted.pmult(ord, true, false, false);
@@ -3235,18 +3434,32 @@ namespace casadi {
       casadi_message("StarColoring requires a square matrix, got " + dim() + ".");
     }
 
+    // Try all orderings and keep the coloring with the fewest colors
+    if (ordering<0) {
+      casadi_int lb = coloring_lower_bound(true);
+      Sparsity best;
+      for (casadi_int ord=0; ord<=4; ++ord) {
+        Sparsity D = star_coloring(ord, cutoff);
+        if (D.is_null()) continue;
+        best = D;
+        // Only look for strictly better colorings from now on
+        cutoff = D.size2()-1;
+        if (D.size2()<=lb) break;
+      }
+      return best;
+    }
+
     // Reorder, if necessary
     if (ordering!=0) {
-      casadi_assert_dev(ordering==1);
-
       // Ordering
-      vector<casadi_int> ord = largest_first();
+      vector<casadi_int> ord = coloring_ordering(ordering);
 
       // Create a new sparsity pattern
       Sparsity sp_permuted = pmult(ord, true, true, true);
 
       // Star coloring for the permuted matrix
-      Sparsity ret_permuted = sp_permuted.star_coloring(0);
+      Sparsity ret_permuted = sp_permuted.star_coloring(0, cutoff);
+      if (ret_permuted.is_null()) return ret_permuted;
 
       // Permute result back
       return ret_permuted.pmult(ord, true, false, false);
@@ -3342,14 +3555,46 @@ namespace casadi {
     return Sparsity::triplet(size2(), num_colors, range(color.size()), color);
   }
 
+  void SparsityInternal::graph_neighbors(casadi_int c, const SparsityInternal* AT,
+                                         std::vector<casadi_int>& nb,
+                                         std::vector<casadi_int>& mark) const {
+    const casadi_int* colind = this->colind();
+    const casadi_int* row = this->row();
+    nb.clear();
+    if (AT==nullptr) {
+      // The pattern is the adjacency matrix
+      for (casadi_int el=colind[c]; el<colind[c+1]; ++el) {
+        if (row[el]!=c) nb.push_back(row[el]);
+      }
+    } else {
+      // Columns sharing a row with column c, without forming the product
+      const casadi_int* AT_colind = AT->colind();
+      const casadi_int* AT_row = AT->row();
+      mark[c] = c;
+      for (casadi_int el=colind[c]; el<colind[c+1]; ++el) {
+        casadi_int r = row[el];
+        for (casadi_int el2=AT_colind[r]; el2<AT_colind[r+1]; ++el2) {
+          casadi_int c2 = AT_row[el2];
+          if (mark[c2]!=c) {
+            mark[c2] = c;
+            nb.push_back(c2);
+          }
+        }
+      }
+    }
+  }
+
   std::vector<casadi_int> SparsityInternal::largest_first() const {
     vector<casadi_int> degree = get_colind();
-    casadi_int max_degree = 0;
-    for (casadi_int k=0; k<size2(); ++k) {
-      degree[k] = degree[k+1]-degree[k];
-      max_degree = max(max_degree, 1+degree[k]);
-    }
+    for (casadi_int k=0; k<size2(); ++k) degree[k] = degree[k+1]-degree[k];
     degree.resize(size2());
+    return largest_first(degree);
+  }
+
+  std::vector<casadi_int> SparsityInternal::largest_first(const std::vector<casadi_int>& degree) {
+    casadi_int n = degree.size();
+    casadi_int max_degree = 0;
+    for (casadi_int k=0; k<n; ++k) max_degree = max(max_degree, 1+degree[k]);
 
     // Vector for binary sort
     vector<casadi_int> degree_count(max_degree+1, 0);
@@ -3363,8 +3608,8 @@ namespace casadi {
     }
 
     // Now a bucket sort
-    vector<casadi_int> ordering(size2());
-    for (casadi_int k=size2()-1; k>=0; --k) {
+    vector<casadi_int> ordering(n);
+    for (casadi_int k=n-1; k>=0; --k) {
       ordering[degree_count[degree[k]]++] = k;
     }
 
@@ -3377,6 +3622,158 @@ namespace casadi {
     return reverse_ordering;
   }
 
+  std::vector<casadi_int> SparsityInternal::dynamic_ordering(casadi_int ordering,
+                                                             const SparsityInternal* AT) const {
+    casadi_assert(AT!=nullptr || is_square(),
+                  "Ordering requires a square matrix, got " + dim() + ".");
+    casadi_assert(ordering>=2 && ordering<=4, "No such dynamic ordering: " + str(ordering));
+    casadi_int n = size2();
+
+    // Smallest last picks the smallest key and orders from the back,
+    // incidence degree counts ordered neighbors instead of remaining ones
+    bool smallest_last = ordering==2, incidence = ordering==3;
+
+    // Work vectors for the neighbors of a column
+    vector<casadi_int> nb, mark(n, -1);
+
+    // Key of each column: degree or number of ordered neighbors
+    vector<casadi_int> key(n, 0);
+    if (!incidence) {
+      for (casadi_int c=0; c<n; ++c) {
+        graph_neighbors(c, AT, nb, mark);
+        key[c] = nb.size();
+      }
+    }
+
+    // Buckets: doubly linked lists of columns with the same key
+    vector<casadi_int> head(n+1, -1), next(n, -1), prev(n, -1);
+    casadi_int max_key = 0;
+    for (casadi_int c=n-1; c>=0; --c) {
+      next[c] = head[key[c]];
+      if (next[c]>=0) prev[next[c]] = c;
+      head[key[c]] = c;
+      max_key = max(max_key, key[c]);
+    }
+
+    // Columns already ordered
+    vector<bool> ordered(n, false);
+
+    // Current bucket
+    casadi_int cur = smallest_last ? 0 : max_key;
+
+    // Order the columns
+    vector<casadi_int> ret(n);
+    for (casadi_int k=0; k<n; ++k) {
+      // Find the next nonempty bucket
+      if (smallest_last) {
+        while (head[cur]<0) cur++;
+      } else {
+        while (head[cur]<0) cur--;
+      }
+
+      // Remove the first column in the bucket
+      casadi_int c = head[cur];
+      head[cur] = next[c];
+      if (next[c]>=0) prev[next[c]] = -1;
+      ordered[c] = true;
+      ret[smallest_last ? n-1-k : k] = c;
+
+      // Update the keys of the neighbors
+      graph_neighbors(c, AT, nb, mark);
+      for (casadi_int r : nb) {
+        if (ordered[r]) continue;
+
+        // Remove from bucket
+        if (prev[r]>=0) {
+          next[prev[r]] = next[r];
+        } else {
+          head[key[r]] = next[r];
+        }
+        if (next[r]>=0) prev[next[r]] = prev[r];
+
+        // Update key
+        key[r] += incidence ? 1 : -1;
+
+        // Insert into new bucket
+        prev[r] = -1;
+        next[r] = head[key[r]];
+        if (next[r]>=0) prev[next[r]] = r;
+        head[key[r]] = r;
+
+        // Keys may have moved past the current bucket
+        if (smallest_last) {
+          cur = min(cur, key[r]);
+        } else if (incidence) {
+          cur = max(cur, key[r]);
+        }
+      }
+    }
+
+    return ret;
+  }
+
+  std::vector<casadi_int> SparsityInternal::coloring_ordering(casadi_int ordering) const {
+    switch (ordering) {
+    case 0: return range(size2());
+    case 1: return largest_first();
+    case 2:
+    case 3:
+    case 4: return dynamic_ordering(ordering);
+    }
+    casadi_error("No such ordering: " + str(ordering));
+  }
+
+  std::vector<casadi_int> SparsityInternal::coloring_ordering(casadi_int ordering,
+                                                              const Sparsity& AT) const {
+    switch (ordering) {
+    case 0: return range(size2());
+    case 1:
+      {
+        // Degrees in the column intersection graph
+        vector<casadi_int> degree(size2()), nb, mark(size2(), -1);
+        for (casadi_int c=0; c<size2(); ++c) {
+          graph_neighbors(c, AT.operator->(), nb, mark);
+          degree[c] = nb.size();
+        }
+        return largest_first(degree);
+      }
+    case 2:
+    case 3:
+    case 4: return dynamic_ordering(ordering, AT.operator->());
+    }
+    casadi_error("No such ordering: " + str(ordering));
+  }
+
+  casadi_int SparsityInternal::coloring_lower_bound(bool symmetric) const {
+    const casadi_int* colind = this->colind();
+    const casadi_int* row = this->row();
+    casadi_int ret = 0;
+    if (symmetric) {
+      // Largest dense principal block with consecutive indices (a clique)
+      casadi_assert(is_square(), "Symmetric lower bound requires a square matrix");
+      casadi_int n = size2();
+      // Length of the run of consecutive rows starting at the diagonal
+      vector<casadi_int> run(n, 0);
+      for (casadi_int c=0; c<n; ++c) {
+        for (casadi_int el=colind[c]; el<colind[c+1]; ++el) {
+          if (row[el]==c+run[c]) run[c]++;
+        }
+      }
+      for (casadi_int c=0; c<n; ++c) {
+        casadi_int k = run[c];
+        for (casadi_int j=c+1; j<c+k; ++j) k = min(k, j-c+run[j]);
+        ret = max(ret, k);
+      }
+    } else {
+      // Maximum number of nonzeros in a row
+      vector<casadi_int> row_count(size1(), 0);
+      for (casadi_int k=0; k<nnz(); ++k) {
+        ret = max(ret, ++row_count[row[k]]);
+      }
+    }
+    return ret;
+  }
+
   Sparsity SparsityInternal::pmult(const std::vector<casadi_int>& p, bool permute_rows,
                                    bool permute_columns, bool invert_permutation) const {
     // Invert p, possibly
@@ -56,6 +56,11 @@ namespace casadi {
     */
     mutable Btf* btf_;
 
+    /* \brief Size of the dense, aligned square blocks of the pattern
+      Calculated on first call, then cached
+    */
+    mutable casadi_int block_size_;
+
   public:
     /// Construct a sparsity pattern from arrays
     SparsityInternal(casadi_int nrow, casadi_int ncol,
@@ -449,6 +454,15 @@ namespace casadi {
     /// Is square?
     bool is_square() const;
 
+    /// Does the pattern consist of dense, aligned bs-by-bs blocks?
+    bool is_blocked(casadi_int bs) const;
+
+    /// Largest size of dense, aligned square blocks
+    casadi_int block_size() const;
+
+    /// Pattern of the blocks of a blocked pattern
+    Sparsity block_compress(casadi_int bs) const;
+
     /// Is symmetric?
     bool is_symmetric() const;
 
@@ -584,7 +598,13 @@ namespace casadi {
      * A greedy distance-2 coloring algorithm
      * (Algorithm 3.1 in A. H. GEBREMEDHIN, F. MANNE, A. POTHEN)
      */
-    Sparsity uni_coloring(const Sparsity& AT, casadi_int cutoff) const;
+    Sparsity uni_coloring(const Sparsity& AT, casadi_int cutoff, casadi_int ordering=0) const;
+
+    /** \brief Perform a bidirectional coloring
+     * See description in public class.
+     */
+    void bi_coloring(Sparsity& D1, Sparsity& D2, double w, double cutoff,
+                     casadi_int ordering) const;
 
     /** \brief A greedy distance-2 coloring algorithm
      * See description in public class.
@@ -596,9 +616,38 @@ namespace casadi {
      */
     Sparsity star_coloring2(casadi_int ordering, casadi_int cutoff) const;
 
+    /** \brief Neighbors of a column in the graph used for ordering
+     * The pattern itself is the adjacency matrix if AT is null. Otherwise the
+     * graph is the column intersection graph, with AT the transpose of the pattern.
+     * \a mark is a work vector of length size2(), initialized to -1.
+     */
+    void graph_neighbors(casadi_int c, const SparsityInternal* AT,
+                         std::vector<casadi_int>& nb, std::vector<casadi_int>& mark) const;
+
     /// Order the columns by decreasing degree
     std::vector<casadi_int> largest_first() const;
 
+    /// Order by decreasing degree, given the degrees
+    static std::vector<casadi_int> largest_first(const std::vector<casadi_int>& degree);
+
+    /** \brief Degree based orderings with dynamic degree updates
+     * Smallest last (2), incidence degree (3) or dynamic largest first (4).
+     * See description in public class.
+     */
+    std::vector<casadi_int> dynamic_ordering(casadi_int ordering,
+                                             const SparsityInternal* AT=nullptr) const;
+
+    /// Get a column ordering for coloring
+    std::vector<casadi_int> coloring_ordering(casadi_int ordering) const;
+
+    /** \brief Column ordering for the column intersection graph, AT being the transpose
+     * The graph is traversed through the rows, without forming AT*A.
+     */
+    std::vector<casadi_int> coloring_ordering(casadi_int ordering, const Sparsity& AT) const;
+
+    /// Lower bound on the number of colors
+    casadi_int coloring_lower_bound(bool symmetric) const;
+
     /// Permute rows and/or columns
     Sparsity pmult(const std::vector<casadi_int>& p, bool permute_rows=true, bool permute_cols=true,
                    bool invert_permutation=false) const;
@@ -30,6 +30,7 @@
 #include <fstream>
 #include <sstream>
 #include <iomanip>
+#include <cmath>
 #include "casadi_misc.hpp"
 #include "sx_node.hpp"
 #include "casadi_common.hpp"
@@ -148,17 +149,282 @@ namespace casadi {
     }
   }
 
+  /// Enclosure [lo, hi] of a value and a bound on its absolute error
+  struct ErrorBound {
+    double lo, hi, err;
+  };
+
+  static double magnitude(const ErrorBound& x) {
+    return std::max(std::fabs(x.lo), std::fabs(x.hi));
+  }
+
+  /// Propagate enclosures and errors through an operation in exact arithmetic
+  static ErrorBound propagate_error(casadi_int op, const ErrorBound& x, const ErrorBound& y) {
+    const double inf = std::numeric_limits<double>::infinity();
+    ErrorBound r = {-inf, inf, inf};
+    double mx = magnitude(x), my = magnitude(y), d, m;
+    switch (op) {
+    case OP_ASSIGN:
+      r = x;
+      break;
+    case OP_ADD:
+      r.lo = x.lo + y.lo;
+      r.hi = x.hi + y.hi;
+      r.err = x.err + y.err;
+      break;
+    case OP_SUB:
+      r.lo = x.lo - y.hi;
+      r.hi = x.hi - y.lo;
+      r.err = x.err + y.err;
+      break;
+    case OP_MUL:
+      r.lo = std::min(std::min(x.lo*y.lo, x.lo*y.hi), std::min(x.hi*y.lo, x.hi*y.hi));
+      r.hi = std::max(std::max(x.lo*y.lo, x.lo*y.hi), std::max(x.hi*y.lo, x.hi*y.hi));
+      r.err = mx*y.err + my*x.err + x.err*y.err;
+      break;
+    case OP_INV:
+    case OP_DIV:
+      if (op==OP_INV) {
+        // 1/x is 1 divided by x
+        ErrorBound one = {1, 1, 0};
+        return propagate_error(OP_DIV, one, x);
+      }
+      // Denominator, also when perturbed, must be bounded away from zero
+      m = std::min(std::fabs(y.lo), std::fabs(y.hi));
+      d = m - y.err;
+      if ((y.lo>0 || y.hi<0) && d>0) {
+        r.lo = std::min(std::min(x.lo/y.lo, x.lo/y.hi), std::min(x.hi/y.lo, x.hi/y.hi));
+        r.hi = std::max(std::max(x.lo/y.lo, x.lo/y.hi), std::max(x.hi/y.lo, x.hi/y.hi));
+        r.err = x.err/d + mx*y.err/(m*d);
+      }
+      break;
+    case OP_NEG:
+      r.lo = -x.hi;
+      r.hi = -x.lo;
+      r.err = x.err;
+      break;
+    case OP_TWICE:
+      r.lo = 2*x.lo;
+      r.hi = 2*x.hi;
+      r.err = 2*x.err;
+      break;
+    case OP_SQ:
+      r.lo = x.lo>=0 ? x.lo*x.lo : x.hi<=0 ? x.hi*x.hi : 0;
+      r.hi = mx*mx;
+      r.err = 2*mx*x.err + x.err*x.err;
+      break;
+    case OP_FABS:
+      r.lo = x.lo>=0 ? x.lo : x.hi<=0 ? -x.hi : 0;
+      r.hi = mx;
+      r.err = x.err;
+      break;
+    case OP_SQRT:
+      if (x.lo>=0 && (x.err==0 || x.lo>x.err)) {
+        r.lo = std::sqrt(x.lo);
+        r.hi = std::sqrt(x.hi);
+        r.err = x.err==0 ? 0 : x.err/(std::sqrt(x.lo) + std::sqrt(x.lo - x.err));
+      }
+      break;
+    case OP_EXP:
+      r.lo = std::exp(x.lo);
+      r.hi = std::exp(x.hi);
+      r.err = std::exp(x.hi + x.err)*x.err;
+      break;
+    case OP_LOG:
+      if (x.lo>x.err) {
+        r.lo = std::log(x.lo);
+        r.hi = std::log(x.hi);
+        r.err = x.err/(x.lo - x.err);
+      }
+      break;
+    case OP_SIN:
+    case OP_COS:
+      r.lo = -1;
+      r.hi = 1;
+      r.err = x.err;
+      break;
+    case OP_TANH:
+      r.lo = std::tanh(x.lo);
+      r.hi = std::tanh(x.hi);
+      r.err = x.err;
+      break;
+    case OP_ATAN:
+      r.lo = std::atan(x.lo);
+      r.hi = std::atan(x.hi);
+      r.err = x.err;
+      break;
+    case OP_SINH:
+      r.lo = std::sinh(x.lo);
+      r.hi = std::sinh(x.hi);
+      r.err = std::cosh(mx + x.err)*x.err;
+      break;
+    case OP_COSH:
+      r.lo = 1;
+      r.hi = std::cosh(mx);
+      r.err = std::sinh(mx + x.err)*x.err;
+      break;
+    case OP_FMIN:
+      r.lo = std::min(x.lo, y.lo);
+      r.hi = std::min(x.hi, y.hi);
+      r.err = std::max(x.err, y.err);
+      break;
+    case OP_FMAX:
+      r.lo = std::max(x.lo, y.lo);
+      r.hi = std::max(x.hi, y.hi);
+      r.err = std::max(x.err, y.err);
+      break;
+    default:
+      break;
+    }
+    // Overflow or indeterminate forms give no bound
+    if (std::isnan(r.lo) || std::isnan(r.hi) || std::isnan(r.err)) {
+      r.lo = -inf;
+      r.hi = r.err = inf;
+    }
+    return r;
+  }
+
+  std::vector<bool> SXFunction::mixed_precision(double tol, double bound,
+                                                std::vector<double>& res_err) const {
+    // Unit roundoff in single and double precision
+    const double u_single = std::ldexp(1., -24), u_double = std::ldexp(1., -53);
+    std::vector<bool> in_float(algorithm_.size(), false);
+    std::vector<ErrorBound> w(worksize_);
+    std::vector<double> err_double;
+    // Largest error accepted for an operation carried out in single precision,
+    // negative for the all double reference
+    double thres = -1;
+    for (casadi_int iter=0; ; ++iter) {
+      res_err.assign(n_out_, 0);
+      for (casadi_int k=0; k<algorithm_.size(); ++k) {
+        const AlgEl& a = algorithm_[k];
+        ErrorBound r_double, r_single;
+        if (a.op==OP_OUTPUT) {
+          res_err[a.i0] = std::max(res_err[a.i0], w[a.i1].err);
+          continue;
+        } else if (a.op==OP_CONST) {
+          r_double.lo = r_double.hi = a.d;
+          r_double.err = 0;
+          r_single = r_double;
+          r_single.err = std::fabs(static_cast<double>(static_cast<float>(a.d)) - a.d);
+        } else if (a.op==OP_INPUT) {
+          r_double.lo = -bound;
+          r_double.hi = bound;
+          r_double.err = 0;
+          r_single = r_double;
+          r_single.err = bound*u_single;
+        } else {
+          r_double = r_single = propagate_error(a.op, w[a.i1], w[a.i2]);
+          // Elementary operations are correctly rounded, allow one ulp otherwise
+          casadi_int ulp = 2;
+          if (a.op==OP_ADD || a.op==OP_SUB || a.op==OP_MUL || a.op==OP_DIV || a.op==OP_INV
+              || a.op==OP_SQRT || a.op==OP_SQ || a.op==OP_TWICE || a.op==OP_NEG
+              || a.op==OP_FABS || a.op==OP_FMIN || a.op==OP_FMAX || a.op==OP_ASSIGN) ulp = 1;
+          r_double.err += ulp*u_double*magnitude(r_double);
+          r_single.err += ulp*u_single*magnitude(r_single);
+        }
+        in_float[k] = r_single.err<=thres;
+        w[a.i0] = in_float[k] ? r_single : r_double;
+      }
+      if (thres<0) {
+        // Reference bounds, then start with the tolerance
+        if (iter>0) break;
+        err_double = res_err;
+        thres = tol;
+        continue;
+      }
+      // Accept if no attainable output tolerance is violated
+      bool ok = true;
+      for (casadi_int i=0; i<n_out_; ++i) {
+        if (res_err[i]>tol && err_double[i]<=tol) ok = false;
+      }
+      if (ok) break;
+      // Tighten, fall back to double precision throughout
+      thres = iter<64 ? thres/2 : -1;
+    }
+    return in_float;
+  }
+
   void SXFunction::codegen_body(CodeGenerator& g) const {
+    // Operations to be carried out in single precision
+    std::vector<bool> in_float(algorithm_.size(), false), slot_float(worksize_, false);
+    if (g.mixed_precision>0) {
+      std::vector<double> res_err;
+      in_float = mixed_precision(g.mixed_precision, g.mixed_precision_bound, res_err);
+      casadi_int n_float = 0;
+      for (bool e : in_float) if (e) n_float++;
+      g << "/* Mixed precision: " << n_float << " of " << algorithm_.size()
+        << " operations in single precision */\n";
+      for (casadi_int i=0; i<n_out_; ++i) {
+        g << "/* Forward error bound, output " << i << ": " << str(res_err[i]) << " */\n";
+      }
+    }
+
+    // Divide a large algorithm into chunks, continued in functions that can be placed in
+    // different source files. Values are passed between the chunks in the work vector.
+    casadi_int n = algorithm_.size(), chunk = codegen_chunk(g);
+    if (chunk>0) {
+      bool avoid_stack = g.avoid_stack_;
+      g.avoid_stack_ = true;
+      for (casadi_int k=0; k<n; ) {
+        std::string cname = g.begin_chunk(codegen_name(g));
+        k = codegen_range(g, k, std::min(k+chunk, n), in_float, slot_float);
+        g.end_chunk();
+        g << cname << "(arg, res, w);\n";
+      }
+      g.avoid_stack_ = avoid_stack;
+      return;
+    }
 
     // Run the algorithm
-    for (auto&& a : algorithm_) {
+    codegen_range(g, 0, n, in_float, slot_float);
+  }
+
+  casadi_int SXFunction::codegen_chunk(const CodeGenerator& g) const {
+    // Least number of instructions in a chunk
+    const casadi_int min_chunk = 1000;
+    casadi_int n = algorithm_.size();
+    if (g.split==1 || g.mixed_precision>0 || n<2*min_chunk) return 0;
+    return std::max(min_chunk, (n + g.split - 1)/g.split);
+  }
+
+  size_t SXFunction::codegen_sz_w(const CodeGenerator& g) const {
+    // Local variables are used instead, unless the work vector must be addressable
+    if (g.avoid_stack_ || codegen_chunk(g)>0) return sz_w();
+    return 0;
+  }
+
+  casadi_int SXFunction::codegen_range(CodeGenerator& g, casadi_int k, casadi_int stop,
+                                       const std::vector<bool>& in_float,
+                                       std::vector<bool>& slot_float) const {
+    for (; k<stop; ++k) {
+      // Roll repeated blocks of instructions into loops
+      if (g.reroll) {
+        casadi_int len, nrep = find_repetition(k, len);
+        if (nrep>1) {
+          codegen_loop(g, k, len, nrep);
+          k += len*nrep - 1;
+          continue;
+        }
+      }
+      const AlgEl& a = algorithm_[k];
       if (a.op==OP_OUTPUT) {
         g << "if (res[" << a.i0 << "]!=0) "
-          << "res["<< a.i0 << "][" << a.i2 << "]=" << g.sx_work(a.i1);
+          << "res["<< a.i0 << "][" << a.i2 << "]="
+          << (slot_float[a.i1] ? g.sx_work_float(a.i1) : g.sx_work(a.i1));
       } else {
+        // Operands, in the precision they were stored with
+        std::string w1, w2;
+        if (a.op!=OP_CONST && a.op!=OP_INPUT) {
+          w1 = slot_float[a.i1] ? g.sx_work_float(a.i1) : g.sx_work(a.i1);
+          if (casadi_math<double>::ndeps(a.op)==2) {
+            w2 = slot_float[a.i2] ? g.sx_work_float(a.i2) : g.sx_work(a.i2);
+          }
+        }
 
         // Where to store the result
-        g << g.sx_work(a.i0) << "=";
+        slot_float[a.i0] = in_float[k];
+        g << (in_float[k] ? g.sx_work_float(a.i0) : g.sx_work(a.i0)) << "=";
 
         // What to store
         if (a.op==OP_CONST) {
@@ -168,12 +434,135 @@ namespace casadi {
         } else {
           casadi_int ndep = casadi_math<double>::ndeps(a.op);
           casadi_assert_dev(ndep>0);
-          if (ndep==1) g << g.print_op(a.op, g.sx_work(a.i1));
-          if (ndep==2) g << g.print_op(a.op, g.sx_work(a.i1), g.sx_work(a.i2));
+          if (ndep==1) g << g.print_op(a.op, w1);
+          if (ndep==2) g << g.print_op(a.op, w1, w2);
         }
       }
       g  << ";\n";
     }
+    return k;
+  }
+
+  void SXFunction::codegen_batch(CodeGenerator& g, casadi_int n) const {
+    // Loop over the instances for each instruction, element j of instance k is w[j*n+k]
+    g.local("k", "casadi_int");
+    string loop = "for (k=0; k<" + str(n) + "; ++k) ";
+    for (auto&& a : algorithm_) {
+      string w0 = "w[" + str(a.i0*n) + "+k]";
+      if (a.op==OP_OUTPUT) {
+        g << "if (res[" << a.i0 << "]!=0) " << loop
+          << "res[" << a.i0 << "][" << a.i2*n << "+k]=w[" << a.i1*n << "+k]";
+      } else if (a.op==OP_CONST) {
+        g << loop << w0 << "=" << g.constant(a.d);
+      } else if (a.op==OP_INPUT) {
+        g << "if (arg[" << a.i1 << "]!=0) {\n"
+          << loop << w0 << "=arg[" << a.i1 << "][" << a.i2*n << "+k];\n"
+          << "} else {\n"
+          << loop << w0 << "=0;\n"
+          << "}\n";
+        continue;
+      } else {
+        casadi_int ndep = casadi_math<double>::ndeps(a.op);
+        casadi_assert_dev(ndep>0);
+        string w1 = "w[" + str(a.i1*n) + "+k]";
+        g << loop << w0 << "=";
+        if (ndep==1) g << g.print_op(a.op, w1);
+        if (ndep==2) g << g.print_op(a.op, w1, "w[" + str(a.i2*n) + "+k]");
+      }
+      g << ";\n";
+    }
+  }
+
+  casadi_int SXFunction::find_repetition(casadi_int k, casadi_int& len) const {
+    // Longest block considered and least number of instructions saved
+    const casadi_int max_len = 256, min_saved = 16;
+    // Instructions scanned for each block length, bounds the cost of a call
+    const casadi_int max_window = 16*max_len;
+    casadi_int n = std::min(static_cast<casadi_int>(algorithm_.size()), k+max_window);
+    // Find the block length covering the most instructions
+    casadi_int best_nrep = 1;
+    len = 1;
+    for (casadi_int l=1; l<=max_len && k+2*l<=n; ++l) {
+      casadi_int nrep = 1;
+      while (k+(nrep+1)*l<=n) {
+        // Instructions must match, up to indices
+        casadi_int i;
+        for (i=0; i<l; ++i) {
+          const AlgEl& a = algorithm_[k+i];
+          const AlgEl& b = algorithm_[k+nrep*l+i];
+          if (a.op!=b.op || (a.op==OP_CONST && a.d!=b.d)) break;
+        }
+        if (i<l) break;
+        nrep++;
+      }
+      if (nrep>1 && l*(nrep-1)>=min_saved && l*nrep>len*best_nrep) {
+        len = l;
+        best_nrep = nrep;
+      }
+    }
+    return best_nrep;
+  }
+
+  void SXFunction::codegen_loop(CodeGenerator& g, casadi_int k, casadi_int len,
+                                casadi_int nrep) const {
+    // Loop counter
+    g.local("i", "casadi_int");
+    // Indices, as functions of the loop counter, for each instruction in the block
+    vector<string> ind(3*len);
+    vector<casadi_int> v(nrep);
+    for (casadi_int p=0; p<len; ++p) {
+      const AlgEl& a = algorithm_[k+p];
+      // Number of index fields used
+      casadi_int nf = 3;
+      if (a.op==OP_CONST) {
+        nf = 1;
+      } else if (a.op!=OP_INPUT && a.op!=OP_OUTPUT) {
+        nf = 1 + casadi_math<double>::ndeps(a.op);
+      }
+      for (casadi_int f=0; f<nf; ++f) {
+        for (casadi_int r=0; r<nrep; ++r) {
+          const AlgEl& e = algorithm_[k + r*len + p];
+          v[r] = f==0 ? e.i0 : f==1 ? e.i1 : e.i2;
+        }
+        // Constant or affine in the loop counter
+        casadi_int stride = v[1]-v[0];
+        bool affine = true;
+        for (casadi_int r=2; r<nrep && affine; ++r) affine = v[r]-v[r-1]==stride;
+        string& s = ind[3*p+f];
+        if (!affine) {
+          s = g.constant(v) + "[i]";
+        } else if (stride==0) {
+          s = str(v[0]);
+        } else {
+          s = str(v[0]) + (stride<0 ? "-" : "+");
+          if (std::abs(stride)!=1) s += str(std::abs(stride)) + "*";
+          s += "i";
+        }
+      }
+    }
+
+    g << "for (i=0; i<" << nrep << "; ++i) {\n";
+    for (casadi_int p=0; p<len; ++p) {
+      const AlgEl& a = algorithm_[k+p];
+      const string* i = &ind[3*p];
+      if (a.op==OP_OUTPUT) {
+        g << "if (res[" << i[0] << "]!=0) res[" << i[0] << "][" << i[2] << "]=w[" << i[1] << "]";
+      } else {
+        g << "w[" << i[0] << "]=";
+        if (a.op==OP_CONST) {
+          g << g.constant(a.d);
+        } else if (a.op==OP_INPUT) {
+          g << "arg[" << i[1] << "] ? arg[" << i[1] << "][" << i[2] << "] : 0";
+        } else {
+          casadi_int ndep = casadi_math<double>::ndeps(a.op);
+          casadi_assert_dev(ndep>0);
+          if (ndep==1) g << g.print_op(a.op, "w[" + i[1] + "]");
+          if (ndep==2) g << g.print_op(a.op, "w[" + i[1] + "]", "w[" + i[2] + "]");
+        }
+      }
+      g << ";\n";
+    }
+    g << "}\n";
   }
 
   Options SXFunction::options_
@@ -782,8 +1171,11 @@ namespace casadi {
                                        const std::vector<std::string>& inames,
                                        const std::vector<std::string>& onames,
                                        const Dict& opts) const {
-    // Jacobian expression
-    SX J = SX::jacobian(veccat(out_), veccat(in_));
+    // Jacobian expression, using the coloring option of this function
+    Function h("jac_helper", {veccat(in_)}, {veccat(out_)},
+               {{"coloring", coloring_}, {"bicoloring", bicoloring_}});
+    Dict coloring_stats;
+    SX J = h.get<SXFunction>()->jac(0, 0, Dict(), &coloring_stats);
 
     // All inputs of the return function
     std::vector<SX> ret_in(inames.size());
@@ -792,8 +1184,10 @@ namespace casadi {
       ret_in.at(n_in_+i) = SX::sym(inames[n_in_+i], Sparsity(out_.at(i).size()));
     }
 
-    // Assemble function and return
-    return Function(name, ret_in, {J}, inames, onames, opts);
+    // Assemble function, attach coloring statistics and return
+    Function ret(name, ret_in, {J}, inames, onames, opts);
+    ret->stats_ = coloring_stats;
+    return ret;
   }
 
   const SX SXFunction::sx_in(casadi_int ind) const {
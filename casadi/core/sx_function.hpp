@@ -197,6 +197,46 @@ class CASADI_EXPORT SXFunction :
   /** \brief Generate code for the body of the C function */
   void codegen_body(CodeGenerator& g) const override;
 
+  /** \brief Length of the work vector used by the generated code */
+  size_t codegen_sz_w(const CodeGenerator& g) const override;
+
+  /** \brief Number of instructions in each chunk of the generated code, 0 if not divided */
+  casadi_int codegen_chunk(const CodeGenerator& g) const;
+
+  /** \brief Generate code for the instructions starting at k, up to stop
+   * A loop over a repeated block may continue past stop. Returns the next instruction.
+   */
+  casadi_int codegen_range(CodeGenerator& g, casadi_int k, casadi_int stop,
+                           const std::vector<bool>& in_float,
+                           std::vector<bool>& slot_float) const;
+
+  /** \brief Can code be generated for several instances side by side? */
+  bool has_codegen_batch() const override { return free_vars_.empty();}
+
+  /** \brief Generate code for \a n instances stored as a structure of arrays */
+  void codegen_batch(CodeGenerator& g, casadi_int n) const override;
+
+  /** \brief Find a block of instructions, starting at k, that is repeated
+   * Blocks match if they have the same operations and constants,
+   * indices may differ. Returns the number of repetitions (1 if none).
+   * Only a window of instructions after k is scanned, so a long repeated sequence
+   * becomes several consecutive loops.
+   */
+  casadi_int find_repetition(casadi_int k, casadi_int& len) const;
+
+  /** \brief Generate code for a repeated block as a loop over index tables */
+  void codegen_loop(CodeGenerator& g, casadi_int k, casadi_int len, casadi_int nrep) const;
+
+  /** \brief Select the operations that can be evaluated in single precision
+   * Propagates an enclosure of each value and a bound on its absolute error
+   * through the algorithm, assuming inputs bounded in magnitude by \a bound.
+   * The selection is tightened until every output whose double precision bound
+   * is within \a tol also stays within \a tol. Returns the achieved bound for
+   * each output in \a res_err.
+   */
+  std::vector<bool> mixed_precision(double tol, double bound,
+                                    std::vector<double>& res_err) const;
+
   /** \brief  Propagate sparsity forward */
   int sp_forward(const bvec_t** arg, bvec_t** res,
                   casadi_int* iw, bvec_t* w, void* mem) const override;
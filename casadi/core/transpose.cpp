@@ -42,6 +42,27 @@ namespace casadi {
     return eval_gen<double>(arg, res, iw, w);
   }
 
+  BlockTranspose::BlockTranspose(const MX& x, casadi_int bs) : Transpose(x), bs_(bs) {
+    sp_xb_ = x.sparsity().block_compress(bs);
+    sp_xtb_ = sparsity().block_compress(bs);
+  }
+
+  int BlockTranspose::eval(const double** arg, double** res, casadi_int* iw, double* w) const {
+    return eval_gen<double>(arg, res, iw, w);
+  }
+
+  int BlockTranspose::
+  eval_sx(const SXElem** arg, SXElem** res, casadi_int* iw, SXElem* w) const {
+    return eval_gen<SXElem>(arg, res, iw, w);
+  }
+
+  template<typename T>
+  int BlockTranspose::eval_gen(const T* const* arg, T* const* res,
+                               casadi_int* iw, T* w) const {
+    casadi_block_trans(arg[0], sp_xb_, res[0], sp_xtb_, iw, bs_);
+    return 0;
+  }
+
   int Transpose::
   eval_sx(const SXElem** arg, SXElem** res, casadi_int* iw, SXElem* w) const {
     return eval_gen<SXElem>(arg, res, iw, w);
@@ -209,4 +230,11 @@ namespace casadi {
       << "rr[i+j*" << dep().size2() << "] = *cs++;\n";
   }
 
+  void BlockTranspose::generate(CodeGenerator& g,
+                                const std::vector<casadi_int>& arg,
+                                const std::vector<casadi_int>& res) const {
+    g << g.block_trans(g.work(arg[0], nnz()), sp_xb_,
+                       g.work(res[0], nnz()), sp_xtb_, "iw", bs_) <<  ";\n";
+  }
+
 } // namespace casadi
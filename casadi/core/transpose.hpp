@@ -138,6 +138,41 @@ namespace casadi {
     size_t sz_iw() const override { return 0;}
   };
 
+  /** \brief Matrix transpose (block-sparse)
+
+      The argument consists of dense, aligned bs-by-bs blocks, which are
+      transposed with dense inner loops.
+  */
+  class CASADI_EXPORT BlockTranspose : public Transpose {
+  public:
+
+    /// Constructor
+    BlockTranspose(const MX& x, casadi_int bs);
+
+    /// Destructor
+    ~BlockTranspose() override {}
+
+    /// Evaluate the function (template)
+    template<typename T>
+    int eval_gen(const T* const* arg, T* const* res, casadi_int* iw, T* w) const;
+
+    /// Evaluate the function numerically
+    int eval(const double** arg, double** res, casadi_int* iw, double* w) const override;
+
+    /// Evaluate the function symbolically (SX)
+    int eval_sx(const SXElem** arg, SXElem** res, casadi_int* iw, SXElem* w) const override;
+
+    /** \brief Generate code for the operation */
+    void generate(CodeGenerator& g,
+                  const std::vector<casadi_int>& arg,
+                  const std::vector<casadi_int>& res) const override;
+
+    /// Block size
+    casadi_int bs_;
+
+    /// Block patterns of the argument and the result
+    Sparsity sp_xb_, sp_xtb_;
+  };
 
 
 } // namespace casadi
@@ -77,7 +77,8 @@ namespace casadi {
     static void sort_depth_first(std::stack<NodeType*>& s, std::vector<NodeType*>& nodes);
 
     /** \brief  Construct a complete Jacobian by compression */
-    MatType jac(casadi_int iind, casadi_int oind, const Dict& opts) const;
+    MatType jac(casadi_int iind, casadi_int oind, const Dict& opts,
+                Dict* stats=nullptr) const;
 
     /** \brief Check if the function is of a particular type */
     bool is_a(const std::string& type, bool recursive) const override {
@@ -292,7 +293,7 @@ namespace casadi {
 
   template<typename DerivedType, typename MatType, typename NodeType>
   MatType XFunction<DerivedType, MatType, NodeType>
-  ::jac(casadi_int iind, casadi_int oind, const Dict& opts) const {
+  ::jac(casadi_int iind, casadi_int oind, const Dict& opts, Dict* stats) const {
     using namespace std;
     try {
       // Read options
@@ -309,7 +310,7 @@ namespace casadi {
           allow_forward = op.second;
         } else if (op.first=="allow_reverse") {
           allow_reverse = op.second;
-        } else if (op.first=="verbose") {
+        } else if (op.first=="verbose" || op.first=="coloring" || op.first=="bicoloring") {
           continue;
         } else {
           casadi_error("No such Jacobian option: " + string(op.first));
@@ -339,7 +340,8 @@ namespace casadi {
 
       // Get a bidirectional partition
       Sparsity D1, D2;
-      get_partition(iind, oind, D1, D2, true, symmetric, allow_forward, allow_reverse);
+      get_partition(iind, oind, D1, D2, true, symmetric, allow_forward, allow_reverse,
+                    stats);
       if (verbose_) casadi_message("Graph coloring completed");
 
       // Get the number of forward and adjoint sweeps
@@ -380,6 +382,13 @@ namespace casadi {
         jsp_trans = jsp.transpose(mapping);
       }
 
+      // For a bidirectional partition, rows in D2 are determined by the adjoint sweeps
+      std::vector<bool> adj_row;
+      if (nfdir>0 && nadir>0) {
+        adj_row.resize(jsp.size2(), false);
+        for (casadi_int el=0; el<D2.nnz(); ++el) adj_row[D2.row(el)] = true;
+      }
+
       // The nonzeros of the sensitivity matrix
       std::vector<casadi_int> nzmap, nzmap2;
 
@@ -502,14 +511,13 @@ namespace casadi {
           }
         }
 
-        // Evaluate symbolically
+        // Evaluate symbolically, both modes for a bidirectional partition
         if (fseed.size()>0) {
-          casadi_assert_dev(aseed.size()==0);
           if (verbose_) casadi_message("Calling 'ad_forward'");
           static_cast<const DerivedType*>(this)->ad_forward(fseed, fsens);
           if (verbose_) casadi_message("Back from 'ad_forward'");
-        } else if (aseed.size()>0) {
-          casadi_assert_dev(fseed.size()==0);
+        }
+        if (aseed.size()>0) {
           if (verbose_) casadi_message("Calling 'ad_reverse'");
           static_cast<const DerivedType*>(this)->ad_reverse(aseed, asens);
           if (verbose_) casadi_message("Back from 'ad_reverse'");
@@ -574,6 +582,9 @@ namespace casadi {
               // Get the output nonzero
               casadi_int r_out = jsp_trans.row(el_out);
 
+              // Skip if determined by the adjoint sweeps
+              if (!adj_row.empty() && adj_row[r_out]) continue;
+
               // Get the forward sensitivity nonzero
               casadi_int f_out = nzmap[r_out];
               if (f_out<0) continue; // Skip if structurally zero
@@ -759,10 +770,12 @@ namespace casadi {
     try {
       // Temporary single-input, single-output function FIXME(@jaeandersson)
       Function tmp("tmp", {veccat(in_)}, {veccat(out_)},
-                   {{"ad_weight", ad_weight()}, {"ad_weight_sp", sp_weight()}});
+                   {{"ad_weight", ad_weight()}, {"ad_weight_sp", sp_weight()},
+                    {"coloring", coloring_}, {"bicoloring", bicoloring_}});
 
-      // Jacobian expression
-      MatType J = tmp.get<DerivedType>()->jac(0, 0, Dict());
+      // Jacobian expression and coloring statistics
+      Dict coloring_stats;
+      MatType J = tmp.get<DerivedType>()->jac(0, 0, Dict(), &coloring_stats);
 
       // Split up Jacobian blocks
       std::vector<casadi_int> r_offset = {0}, c_offset = {0};
@@ -782,8 +795,10 @@ namespace casadi {
         ret_in.at(n_in_+i) = MatType::sym(inames[n_in_+i], Sparsity(out_.at(i).size()));
       }
 
-      // Assemble function and return
-      return Function(name, ret_in, ret_out, inames, onames, opts);
+      // Assemble function, attach coloring statistics and return
+      Function ret(name, ret_in, ret_out, inames, onames, opts);
+      ret->stats_ = coloring_stats;
+      return ret;
     } catch (std::exception& e) {
       CASADI_THROW_ERROR("get_jac", e.what());
     }
@@ -798,10 +813,12 @@ namespace casadi {
     try {
       // Temporary single-input, single-output function FIXME(@jaeandersson)
       Function tmp("tmp", {veccat(in_)}, {veccat(out_)},
-                   {{"ad_weight", ad_weight()}, {"ad_weight_sp", sp_weight()}});
+                   {{"ad_weight", ad_weight()}, {"ad_weight_sp", sp_weight()},
+                    {"coloring", coloring_}, {"bicoloring", bicoloring_}});
 
-      // Jacobian expression
-      MatType J = tmp.get<DerivedType>()->jac(0, 0, Dict());
+      // Jacobian expression and coloring statistics
+      Dict coloring_stats;
+      MatType J = tmp.get<DerivedType>()->jac(0, 0, Dict(), &coloring_stats);
 
       // All inputs of the return function
       std::vector<MatType> ret_in(inames.size());
@@ -810,8 +827,10 @@ namespace casadi {
         ret_in.at(n_in_+i) = MatType::sym(inames[n_in_+i], Sparsity(out_.at(i).size()));
       }
 
-      // Assemble function and return
-      return Function(name, ret_in, {J}, inames, onames, opts);
+      // Assemble function, attach coloring statistics and return
+      Function ret(name, ret_in, {J}, inames, onames, opts);
+      ret->stats_ = coloring_stats;
+      return ret;
     } catch (std::exception& e) {
       CASADI_THROW_ERROR("get_jacobian", e.what());
     }
@@ -54,7 +54,7 @@ namespace casadi {
   }
 
   Options LapackQr::options_
-  = {{&FunctionInternal::options_},
+  = {{&LinsolInternal::options_},
      {{"max_nrhs",
        {OT_INT,
         "Maximum number of right-hand-sides that get processed in a single pass [default:10]."}}
@@ -143,6 +143,9 @@ namespace casadi {
     double t0 = 0;
     THROWING(CVodeInit, m->mem, rhs, t0, m->xz);
 
+    // Zero crossings of the event functions
+    if (nev_>0) THROWING(CVodeRootInit, m->mem, nev_, rootF);
+
     // Set tolerances
     THROWING(CVodeSStolerances, m->mem, reltol_, abstol_);
 
@@ -223,6 +226,21 @@ namespace casadi {
     }
   }
 
+  int CvodesInterface::rootF(double t, N_Vector x, double *gout, void *user_data) {
+    try {
+      casadi_assert_dev(user_data);
+      auto m = to_mem(user_data);
+      auto& s = m->self;
+      s.eval_event(m, t, NV_DATA_S(x), nullptr, m->p, gout);
+      return 0;
+    } catch(int flag) { // recoverable error
+      return flag;
+    } catch(exception& e) { // non-recoverable error
+      uerr() << "rootF failed: " << e.what() << endl;
+      return -1;
+    }
+  }
+
   void CvodesInterface::reset(IntegratorMemory* mem, double t, const double* x,
                               const double* z, const double* _p) const {
     if (verbose_) casadi_message(name_ + "::reset");
@@ -269,8 +287,17 @@ namespace casadi {
         // ... with taping
         THROWING(CVodeF, m->mem, t, m->xz, &m->t, CV_NORMAL, &m->ncheck);
       } else {
-        // ... without taping
-        THROWING(CVode, m->mem, t, m->xz, &m->t, CV_NORMAL);
+        // ... without taping, recording the zero crossings of the event functions
+        while (true) {
+          int flag = CVode(m->mem, t, m->xz, &m->t, CV_NORMAL);
+          cvodes_error("CVode", flag);
+          if (flag!=CV_ROOT_RETURN) break;
+          THROWING(CVodeGetRootInfo, m->mem, get_ptr(m->rootsfound));
+          for (casadi_int i=0; i<nev_; ++i) {
+            if (m->rootsfound[i]) add_event(m, m->t, i, NV_DATA_S(m->xz));
+          }
+          if (fabs(m->t-t)<ttol) break;
+        }
       }
 
       // Get quadratures
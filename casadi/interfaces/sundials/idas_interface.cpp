@@ -184,6 +184,21 @@ namespace casadi {
     }
   }
 
+  int IdasInterface::rootF(double t, N_Vector xz, N_Vector xzdot, double *gout,
+                           void *user_data) {
+    try {
+      auto m = to_mem(user_data);
+      auto& s = m->self;
+      s.eval_event(m, t, NV_DATA_S(xz), NV_DATA_S(xz)+s.nx_, m->p, gout);
+      return 0;
+    } catch(int flag) { // recoverable error
+      return flag;
+    } catch(exception& e) { // non-recoverable error
+      uerr() << "rootF failed: " << e.what() << endl;
+      return -1;
+    }
+  }
+
   void IdasInterface::ehfun(int error_code, const char *module, const char *function,
                                    char *msg, void *eh_data) {
     try {
@@ -279,6 +294,9 @@ namespace casadi {
     IDAInit(m->mem, res, t0, m->xz, m->xzdot);
     if (verbose_) casadi_message("IDA initialized");
 
+    // Zero crossings of the event functions
+    if (nev_>0) THROWING(IDARootInit, m->mem, nev_, rootF);
+
     // Include algebraic variables in error testing
     THROWING(IDASetSuppressAlg, m->mem, suppress_algebraic_);
 
@@ -424,8 +442,17 @@ namespace casadi {
       // Integrate forward ...
       if (nrx_>0) { // ... with taping
         THROWING(IDASolveF, m->mem, t, &m->t, m->xz, m->xzdot, IDA_NORMAL, &m->ncheck);
-      } else { // ... without taping
-        THROWING(IDASolve, m->mem, t, &m->t, m->xz, m->xzdot, IDA_NORMAL);
+      } else { // ... without taping, recording the zero crossings of the event functions
+        while (true) {
+          int flag = IDASolve(m->mem, t, &m->t, m->xz, m->xzdot, IDA_NORMAL);
+          idas_error("IDASolve", flag);
+          if (flag!=IDA_ROOT_RETURN) break;
+          THROWING(IDAGetRootInfo, m->mem, get_ptr(m->rootsfound));
+          for (casadi_int i=0; i<nev_; ++i) {
+            if (m->rootsfound[i]) add_event(m, m->t, i, NV_DATA_S(m->xz));
+          }
+          if (fabs(m->t-t)<ttol) break;
+        }
       }
 
       // Get quadratures
@@ -113,6 +113,10 @@ namespace casadi {
     casadi_assert(ns_==0 || !derivative_of_.is_null(),
       "Not implemented.");
 
+    // Rootfinding is not available when the forward integration is taped
+    casadi_assert(nev_==0 || nrx_==0,
+      "Event detection not supported together with a backward problem");
+
     // Default options
     abstol_ = 1e-8;
     reltol_ = 1e-6;
@@ -244,6 +248,7 @@ namespace casadi {
     m->mem_linsolF = linsolF_.checkout();
     if (!linsolB_.is_null()) m->mem_linsolB = linsolB_.checkout();
 
+    m->rootsfound.resize(nev_);
     return 0;
   }
 
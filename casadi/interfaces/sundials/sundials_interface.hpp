@@ -79,6 +79,9 @@ namespace casadi {
     /// Linear solver memory objects
     casadi_int mem_linsolF, mem_linsolB;
 
+    /// Event functions with a zero crossing at the current time
+    std::vector<int> rootsfound;
+
     /// Constructor
     SundialsMemory();
 
@@ -121,6 +124,9 @@ namespace casadi {
     /// Get all statistics
     Dict get_stats(void* mem) const override;
 
+    /// Event detection is supported, using the rootfinding of SUNDIALS
+    bool has_events() const override { return true;}
+
     /** \brief  Print solver statistics */
     void print_stats(IntegratorMemory* mem) const override;
 
@@ -26,6 +26,7 @@
 #include "collocation.hpp"
 #include "casadi/core/polynomial.hpp"
 #include "casadi/core/casadi_misc.hpp"
+#include <complex>
 
 using namespace std;
 namespace casadi {
@@ -46,6 +47,149 @@ namespace casadi {
     Integrator::registerPlugin(casadi_register_integrator_collocation);
   }
 
+  // Largest convergence rate of the simplified Newton iterations for keeping the Jacobian
+  static const double col_max_rate = 0.1;
+
+  // Number of times the simplified Newton iterations are restarted with a new Jacobian
+  static const casadi_int col_max_restarts = 10;
+
+  // Solve a small dense linear system in place, the matrix is stored row by row
+  template<typename T1>
+  static void dense_solve(casadi_int n, vector<T1> A, vector<T1>& b) {
+    // Gaussian elimination with partial pivoting
+    for (casadi_int k=0; k<n; ++k) {
+      casadi_int p = k;
+      for (casadi_int i=k+1; i<n; ++i) if (abs(A[i*n+k])>abs(A[p*n+k])) p = i;
+      if (p!=k) {
+        for (casadi_int j=0; j<n; ++j) swap(A[k*n+j], A[p*n+j]);
+        swap(b[k], b[p]);
+      }
+      for (casadi_int i=k+1; i<n; ++i) {
+        T1 f = A[i*n+k]/A[k*n+k];
+        for (casadi_int j=k; j<n; ++j) A[i*n+j] -= f*A[k*n+j];
+        b[i] -= f*b[k];
+      }
+    }
+    // Back substitution
+    for (casadi_int k=n-1; k>=0; --k) {
+      for (casadi_int j=k+1; j<n; ++j) b[k] -= A[k*n+j]*b[j];
+      b[k] /= A[k*n+k];
+    }
+  }
+
+  /* Transform a small dense matrix M, stored row by row, to real block diagonal form
+     inv(T)*M*T, with a diagonal entry re for each real eigenvalue and a block
+     [re, im; -im, re] for each complex pair re +/- i*im */
+  static void decouple(casadi_int n, const vector<double>& M, vector<double>& T,
+                       vector<double>& Tinv, vector<double>& eig_re, vector<double>& eig_im) {
+    typedef complex<double> cplx;
+
+    // Characteristic polynomial sum_k c[k]*s^k, Faddeev-LeVerrier algorithm
+    vector<double> c(n+1, 0), Mk(n*n), MMk(n*n, 0);
+    c[n] = 1;
+    for (casadi_int k=1; k<=n; ++k) {
+      Mk = MMk;
+      for (casadi_int i=0; i<n; ++i) Mk[i*n+i] += c[n-k+1];
+      double tr = 0;
+      for (casadi_int i=0; i<n; ++i) {
+        for (casadi_int j=0; j<n; ++j) {
+          MMk[i*n+j] = 0;
+          for (casadi_int l=0; l<n; ++l) MMk[i*n+j] += M[i*n+l]*Mk[l*n+j];
+        }
+        tr += MMk[i*n+i];
+      }
+      c[n-k] = -tr/static_cast<double>(k);
+    }
+
+    // Eigenvalues, Durand-Kerner iterations
+    double R = 1;
+    for (casadi_int k=0; k<n; ++k) R = max(R, 1 + fabs(c[k]));
+    vector<cplx> lambda(n);
+    for (casadi_int i=0; i<n; ++i) lambda[i] = R*pow(cplx(0.4, 0.9), static_cast<double>(i));
+    for (casadi_int iter=0; iter<1000; ++iter) {
+      double dmax = 0;
+      for (casadi_int i=0; i<n; ++i) {
+        cplx num = c[n], den = 1;
+        for (casadi_int k=n-1; k>=0; --k) num = num*lambda[i] + c[k];
+        for (casadi_int j=0; j<n; ++j) if (j!=i) den *= lambda[i] - lambda[j];
+        cplx d = num/den;
+        lambda[i] -= d;
+        dmax = max(dmax, abs(d));
+      }
+      if (dmax <= 1e-15*R) break;
+    }
+
+    // Eigenvectors, inverse iteration
+    T.assign(n*n, 0);
+    eig_re.clear();
+    eig_im.clear();
+    casadi_int col = 0;
+    for (casadi_int i=0; i<n; ++i) {
+      // Skip the second eigenvalue of each complex pair
+      double re = lambda[i].real(), im = lambda[i].imag();
+      if (im < -1e-8*abs(lambda[i])) continue;
+      if (im <= 1e-8*abs(lambda[i])) im = 0;
+      cplx shift = cplx(re, im) + 1e-10*(1 + abs(lambda[i]));
+      vector<cplx> A(n*n), v(n, 1.);
+      for (casadi_int j=0; j<n; ++j) {
+        for (casadi_int k=0; k<n; ++k) A[j*n+k] = M[j*n+k];
+        A[j*n+j] -= shift;
+      }
+      for (casadi_int iter=0; iter<3; ++iter) {
+        dense_solve(n, A, v);
+        cplx vmax = 0;
+        for (casadi_int j=0; j<n; ++j) if (abs(v[j])>abs(vmax)) vmax = v[j];
+        for (casadi_int j=0; j<n; ++j) v[j] /= vmax;
+      }
+      casadi_assert(col + (im==0 ? 1 : 2) <= n,
+        "Eigenvalue decomposition of the collocation matrix failed");
+      for (casadi_int j=0; j<n; ++j) T[j*n+col] = v[j].real();
+      if (im!=0) {
+        for (casadi_int j=0; j<n; ++j) T[j*n+col+1] = v[j].imag();
+      }
+      col += im==0 ? 1 : 2;
+      eig_re.push_back(re);
+      eig_im.push_back(im);
+    }
+    casadi_assert(col==n, "Eigenvalue decomposition of the collocation matrix failed");
+
+    // Inverse transformation
+    Tinv.resize(n*n);
+    for (casadi_int i=0; i<n; ++i) {
+      vector<double> e(n, 0);
+      e[i] = 1;
+      dense_solve(n, T, e);
+      for (casadi_int j=0; j<n; ++j) Tinv[j*n+i] = e[j];
+    }
+
+    // Make sure that inv(T)*M*T is block diagonal, as expected
+    vector<double> MT(n*n, 0), L(n*n, 0);
+    for (casadi_int i=0; i<n; ++i) {
+      for (casadi_int j=0; j<n; ++j) {
+        for (casadi_int k=0; k<n; ++k) MT[i*n+j] += M[i*n+k]*T[k*n+j];
+      }
+    }
+    for (casadi_int i=0; i<n; ++i) {
+      for (casadi_int j=0; j<n; ++j) {
+        for (casadi_int k=0; k<n; ++k) L[i*n+j] += Tinv[i*n+k]*MT[k*n+j];
+      }
+    }
+    for (casadi_int b=0, k=0; b<static_cast<casadi_int>(eig_re.size()); ++b) {
+      L[k*n+k] -= eig_re[b];
+      if (eig_im[b]!=0) {
+        L[k*n+k+1] -= eig_im[b];
+        L[(k+1)*n+k] += eig_im[b];
+        L[(k+1)*n+k+1] -= eig_re[b];
+        k += 2;
+      } else {
+        k += 1;
+      }
+    }
+    double err = 0;
+    for (double e : L) err = max(err, fabs(e));
+    casadi_assert(err <= 1e-8*R, "Eigenvalue decomposition of the collocation matrix failed");
+  }
+
   Collocation::Collocation(const std::string& name, const Function& dae)
     : ImplicitFixedStepIntegrator(name, dae) {
   }
@@ -60,7 +204,24 @@ namespace casadi {
         "Order of the interpolating polynomials"}},
       {"collocation_scheme",
        {OT_STRING,
-        "Collocation scheme: radau|legendre"}}
+        "Collocation scheme: radau|legendre"}},
+      {"simplified_newton",
+       {OT_BOOL,
+        "Solve the collocation equations of the forward problem with simplified Newton "
+        "iterations, decoupled by the eigenvalues of the collocation matrix, "
+        "instead of with the rootfinder [false]"}},
+      {"newton_abstol",
+       {OT_DOUBLE,
+        "Tolerance on the residual of the simplified Newton iterations [1e-12]"}},
+      {"newton_max_iter",
+       {OT_INT,
+        "Maximum number of simplified Newton iterations per finite element [20]"}},
+      {"linear_solver",
+       {OT_STRING,
+        "Linear solver for the simplified Newton iterations [qr]"}},
+      {"linear_solver_options",
+       {OT_DICT,
+        "Options to be passed to the linear solver"}}
      }
   };
 
@@ -68,6 +229,10 @@ namespace casadi {
     // Default options
     deg_ = 3;
     collocation_scheme_ = "radau";
+    simplified_newton_ = false;
+    newton_abstol_ = 1e-12;
+    newton_max_iter_ = 20;
+    linear_solver_ = "qr";
 
     // Read options
     for (auto&& op : opts) {
@@ -75,11 +240,71 @@ namespace casadi {
         deg_ = op.second;
       } else if (op.first=="collocation_scheme") {
         collocation_scheme_ = op.second.to_string();
+      } else if (op.first=="simplified_newton") {
+        simplified_newton_ = op.second;
+      } else if (op.first=="newton_abstol") {
+        newton_abstol_ = op.second;
+      } else if (op.first=="newton_max_iter") {
+        newton_max_iter_ = op.second;
+      } else if (op.first=="linear_solver") {
+        linear_solver_ = op.second.to_string();
+      } else if (op.first=="linear_solver_options") {
+        linear_solver_options_ = op.second;
       }
     }
 
     // Call the base class init
     ImplicitFixedStepIntegrator::init(opts);
+    if (!simplified_newton_) return;
+    casadi_assert(newton_max_iter_>=1, "Option 'newton_max_iter' must be positive");
+
+    // Collocation matrix, derivatives of the collocation polynomial at the collocation points
+    vector<double> M(deg_*deg_);
+    for (casadi_int j=0; j<deg_; ++j) {
+      for (casadi_int r=0; r<deg_; ++r) M[j*deg_+r] = C_[r+1][j+1];
+    }
+
+    // Transform to real block diagonal form
+    decouple(deg_, M, T_, Tinv_, eig_re_, eig_im_);
+
+    // Forward sensitivity equations share the Jacobian of the nondifferentiated DAE
+    const Collocation* d = derivative_of_.is_null() ? nullptr : derivative_of_.get<Collocation>();
+    ns_shared_ = d!=nullptr && ns_>0 ? ns_ : 0;
+    Function J;
+    if (ns_shared_>0) {
+      casadi_assert_dev(d->nx_==nx1_ && d->nz_==nz1_ && d->np_==np1_);
+      J = d->getJ();
+    } else {
+      J = getJ();
+    }
+    set_function(J, "jacF", true);
+    sp_A1_ = J.sparsity_out(0);
+    nx_A_ = nx_/(1+ns_shared_);
+    nz_A_ = nz_/(1+ns_shared_);
+
+    // A complex pair of eigenvalues gives a real system of twice the size
+    Sparsity sp_E = diagcat(Sparsity::diag(nx_A_), Sparsity(nz_A_, nz_A_));
+    sp_A2_ = blockcat(sp_A1_, sp_E, sp_E, sp_A1_);
+
+    // Linear solvers
+    linsol1_ = Linsol("linsol1", linear_solver_, sp_A1_, linear_solver_options_);
+    linsol2_ = Linsol("linsol2", linear_solver_, sp_A2_, linear_solver_options_);
+  }
+
+  Function Collocation::getJ() const {
+    return oracle_.is_a("SXFunction") ? getJ<SX>() : getJ<MX>();
+  }
+
+  template<typename MatType>
+  Function Collocation::getJ() const {
+    vector<MatType> a = MatType::get_input(oracle_);
+    vector<MatType> r = const_cast<Function&>(oracle_)(a);
+
+    // The ODE is scaled by the step size, as in the collocation equations
+    MatType rhs = vertcat(vec(h_*r[DE_ODE]), vec(r[DE_ALG]));
+    MatType jac = horzcat(MatType::jacobian(rhs, a[DE_X]), MatType::jacobian(rhs, a[DE_Z]));
+    jac = project(jac, jac.sparsity() + diagcat(Sparsity::diag(nx_), Sparsity(nz_, nz_)));
+    return Function("jacF", {a[DE_X], a[DE_Z], a[DE_P], a[DE_T]}, {jac});
   }
 
   void Collocation::setupFG() {
@@ -131,6 +356,12 @@ namespace casadi {
       B[j] = ip(1.0);
     }
 
+    // Save the coefficients for the simplified Newton iterations
+    tau_root_ = tau_root;
+    C_ = C;
+    D_ = D;
+    B_ = B;
+
     // Symbolic inputs
     MX x0 = MX::sym("x0", this->x());
     MX p = MX::sym("p", this->p());
@@ -307,6 +538,11 @@ namespace casadi {
     // Reset the base classes
     ImplicitFixedStepIntegrator::reset(mem, t, x, z, p);
 
+    // Evaluate the Jacobian in the first finite element
+    auto cm = static_cast<CollocationMemory*>(mem);
+    cm->jac_valid = false;
+    cm->nniter = cm->njevals = cm->nlinsetups = 0;
+
     // Initial guess for Z
     double* Z = get_ptr(m->Z);
     for (casadi_int d=0; d<deg_; ++d) {
@@ -317,6 +553,40 @@ namespace casadi {
     }
   }
 
+  int Collocation::init_mem(void* mem) const {
+    if (ImplicitFixedStepIntegrator::init_mem(mem)) return 1;
+    auto m = static_cast<CollocationMemory*>(mem);
+    if (!simplified_newton_) return 0;
+
+    // Work vectors and one linear solver memory for each decoupled system
+    m->K.resize(sp_A1_.nnz());
+    casadi_int nA = 0;
+    for (size_t b=0; b<eig_re_.size(); ++b) {
+      if (eig_im_[b]==0) {
+        nA += sp_A1_.nnz();
+        m->mem_linsol.push_back(linsol1_.checkout());
+      } else {
+        nA += sp_A2_.nnz();
+        m->mem_linsol.push_back(linsol2_.checkout());
+      }
+    }
+    m->A.resize(nA);
+    m->eq.resize(nZ_);
+    m->y.resize(nZ_);
+    if (ns_shared_>0) m->ys.resize(2*(nx_+nz_));
+    m->quad.resize(deg_*nq_);
+    return 0;
+  }
+
+  void Collocation::free_mem(void *mem) const {
+    auto m = static_cast<CollocationMemory*>(mem);
+    for (size_t b=0; b<m->mem_linsol.size(); ++b) {
+      const Linsol& linsol = eig_im_[b]==0 ? linsol1_ : linsol2_;
+      linsol.release(m->mem_linsol[b]);
+    }
+    delete m;
+  }
+
   void Collocation::resetB(IntegratorMemory* mem, double t, const double* rx,
                                const double* rz, const double* rp) const {
     auto m = static_cast<FixedStepMemory*>(mem);
@@ -334,4 +604,231 @@ namespace casadi {
     }
   }
 
+  void Collocation::interpolate(FixedStepMemory* m, double theta,
+                                double* x, double* z, double* q) const {
+    // Quadratures are interpolated by the base class
+    if (q) FixedStepIntegrator::interpolate(m, theta, nullptr, nullptr, q);
+
+    // Lagrange polynomials through the start of the step and the collocation points
+    const double* Z = get_ptr(m->Z);
+    casadi_fill(x, nx_, 0.);
+    casadi_fill(z, nz_, 0.);
+    for (casadi_int j=0; j<=deg_; ++j) {
+      double l = 1;
+      for (casadi_int r=0; r<=deg_; ++r) {
+        if (r!=j) l *= (theta - tau_root_[r])/(tau_root_[j] - tau_root_[r]);
+      }
+      const double* xj = j==0 ? get_ptr(m->x_prev) : Z + (j-1)*(nx_+nz_);
+      if (x) casadi_axpy(nx_, l, xj, x);
+
+      // The algebraic variables are only defined at the collocation points
+      if (j==0 || !z) continue;
+      l = 1;
+      for (casadi_int r=1; r<=deg_; ++r) {
+        if (r!=j) l *= (theta - tau_root_[r])/(tau_root_[j] - tau_root_[r]);
+      }
+      casadi_axpy(nz_, l, xj + nx_, z);
+    }
+  }
+
+  void Collocation::stepF(FixedStepMemory* mem, double t, const double* x0, const double* Z0,
+                          double* xf, double* Zf, double* qf) const {
+    if (!simplified_newton_) {
+      ImplicitFixedStepIntegrator::stepF(mem, t, x0, Z0, xf, Zf, qf);
+      return;
+    }
+    auto m = static_cast<CollocationMemory*>(mem);
+    casadi_int n = nx_ + nz_;
+
+    // Solve the collocation equations, restarting with a new Jacobian at the
+    // latest iterate as long as the iterations fail to converge
+    casadi_copy(Z0, nZ_, Zf);
+    if (!m->jac_valid) jac(m, t, x0, Zf);
+    for (casadi_int njac=0; !newton(m, t, x0, Zf); ++njac) {
+      if (njac==col_max_restarts) {
+        casadi_error("Simplified Newton iterations failed to converge");
+      }
+      jac(m, t, x0, Zf);
+    }
+
+    // State at the end of the finite element
+    if (xf) {
+      casadi_copy(x0, nx_, xf);
+      casadi_scal(nx_, D_[0], xf);
+      for (casadi_int j=1; j<=deg_; ++j) casadi_axpy(nx_, D_[j], Zf + (j-1)*n, xf);
+    }
+
+    // Quadratures
+    if (qf) {
+      casadi_fill(qf, nq_, 0.);
+      for (casadi_int j=1; j<=deg_; ++j) {
+        casadi_axpy(nq_, B_[j]*h_, get_ptr(m->quad) + (j-1)*nq_, qf);
+      }
+    }
+  }
+
+  void Collocation::jac(CollocationMemory* m, double t, const double* x0,
+                        const double* Z) const {
+    // Jacobian at the beginning of the finite element
+    m->arg[0] = x0;
+    m->arg[1] = Z + nx_;
+    m->arg[2] = get_ptr(m->p);
+    m->arg[3] = &t;
+    m->res[0] = get_ptr(m->K);
+    if (calc_function(m, "jacF")) casadi_error("'jacF' calculation failed");
+    m->njevals++;
+
+    // Form and factorize the decoupled iteration matrices, E selects the differential states
+    casadi_int n = nx_A_ + nz_A_;
+    const casadi_int *colind = sp_A1_.colind(), *row = sp_A1_.row();
+    const double* K = get_ptr(m->K);
+    double* A = get_ptr(m->A);
+    for (size_t b=0; b<eig_re_.size(); ++b) {
+      double re = eig_re_[b], im = eig_im_[b];
+      double* A_b = A;
+      if (im==0) {
+        // K - re*E
+        for (casadi_int c=0; c<n; ++c) {
+          for (casadi_int k=colind[c]; k<colind[c+1]; ++k) {
+            *A++ = row[k]==c && c<nx_A_ ? K[k] - re : K[k];
+          }
+        }
+        if (linsol1_.nfact(A_b, m->mem_linsol[b])) casadi_error("Factorization failed");
+      } else {
+        // [K - re*E, -im*E; im*E, K - re*E], stored column by column
+        for (casadi_int c=0; c<n; ++c) {
+          for (casadi_int k=colind[c]; k<colind[c+1]; ++k) {
+            *A++ = row[k]==c && c<nx_A_ ? K[k] - re : K[k];
+          }
+          if (c<nx_A_) *A++ = im;
+        }
+        for (casadi_int c=0; c<n; ++c) {
+          if (c<nx_A_) *A++ = -im;
+          for (casadi_int k=colind[c]; k<colind[c+1]; ++k) {
+            *A++ = row[k]==c && c<nx_A_ ? K[k] - re : K[k];
+          }
+        }
+        if (linsol2_.nfact(A_b, m->mem_linsol[b])) casadi_error("Factorization failed");
+      }
+      m->nlinsetups++;
+    }
+    m->jac_valid = true;
+  }
+
+  void Collocation::residual(CollocationMemory* m, double t, const double* x0,
+                             const double* Z) const {
+    casadi_int n = nx_ + nz_;
+    for (casadi_int j=1; j<=deg_; ++j) {
+      double t_j = t + h_*tau_root_[j];
+      double* res_j = get_ptr(m->eq) + (j-1)*n;
+
+      // Evaluate the DAE at the collocation point
+      m->arg[0] = Z + (j-1)*n;
+      m->arg[1] = Z + (j-1)*n + nx_;
+      m->arg[2] = get_ptr(m->p);
+      m->arg[3] = &t_j;
+      m->res[0] = res_j;
+      m->res[1] = res_j + nx_;
+      m->res[2] = get_ptr(m->quad) + (j-1)*nq_;
+      if (calc_function(m, "f")) casadi_error("'f' calculation failed");
+
+      // Collocation equation
+      casadi_scal(nx_, h_, res_j);
+      casadi_axpy(nx_, -C_[0][j], x0, res_j);
+      for (casadi_int r=1; r<=deg_; ++r) casadi_axpy(nx_, -C_[r][j], Z + (r-1)*n, res_j);
+    }
+  }
+
+  bool Collocation::newton(CollocationMemory* m, double t, const double* x0, double* Z) const {
+    casadi_int n = nx_ + nz_;
+    double* res = get_ptr(m->eq);
+    double* y = get_ptr(m->y);
+    double norm_prev = 0, rate = 0;
+    for (casadi_int iter=0; ; ++iter) {
+      // Converged?
+      residual(m, t, x0, Z);
+      if (casadi_norm_inf(nZ_, res) <= newton_abstol_) {
+        // Keep the Jacobian for the next finite element if the convergence was fast
+        m->jac_valid = rate <= col_max_rate;
+        return true;
+      }
+      if (iter==newton_max_iter_) return false;
+
+      // Transform the residual
+      casadi_fill(y, nZ_, 0.);
+      for (casadi_int k=0; k<deg_; ++k) {
+        for (casadi_int j=0; j<deg_; ++j) casadi_axpy(n, -Tinv_[k*deg_+j], res + j*n, y + k*n);
+      }
+
+      // Solve the decoupled systems, one right-hand side for each sensitivity direction
+      const double* A = get_ptr(m->A);
+      double* y_b = y;
+      for (size_t b=0; b<eig_re_.size(); ++b) {
+        casadi_int nblk = eig_im_[b]==0 ? 1 : 2;
+        double* v = y_b;
+        if (ns_shared_>0) {
+          v = get_ptr(m->ys);
+          sort_directions(y_b, v, nblk, false);
+        }
+        if (nblk==1) {
+          if (linsol1_.solve(A, v, 1+ns_shared_, false, m->mem_linsol[b])) return false;
+          A += sp_A1_.nnz();
+        } else {
+          if (linsol2_.solve(A, v, 1+ns_shared_, false, m->mem_linsol[b])) return false;
+          A += sp_A2_.nnz();
+        }
+        if (ns_shared_>0) sort_directions(y_b, v, nblk, true);
+        y_b += nblk*n;
+      }
+
+      // Newton step
+      casadi_fill(res, nZ_, 0.);
+      for (casadi_int j=0; j<deg_; ++j) {
+        for (casadi_int k=0; k<deg_; ++k) casadi_axpy(n, T_[j*deg_+k], y + k*n, res + j*n);
+      }
+      casadi_axpy(nZ_, 1., res, Z);
+      m->nniter++;
+
+      // Stop if diverging, undoing the last step
+      double norm = casadi_norm_inf(nZ_, res);
+      if (iter>0 && norm_prev>0) {
+        rate = max(rate, norm/norm_prev);
+        if (rate>=1) {
+          casadi_axpy(nZ_, -1., res, Z);
+          return false;
+        }
+      }
+      norm_prev = norm;
+    }
+  }
+
+  void Collocation::sort_directions(double* v, double* w, casadi_int nblk, bool inverse) const {
+    casadi_int n = nx_ + nz_, n_A = nx_A_ + nz_A_;
+    for (casadi_int i=0; i<nblk; ++i) {
+      for (casadi_int d=0; d<=ns_shared_; ++d) {
+        double* v_x = v + i*n + d*nx_A_;
+        double* v_z = v + i*n + nx_ + d*nz_A_;
+        double* w_d = w + (d*nblk + i)*n_A;
+        if (inverse) {
+          casadi_copy(w_d, nx_A_, v_x);
+          casadi_copy(w_d + nx_A_, nz_A_, v_z);
+        } else {
+          casadi_copy(v_x, nx_A_, w_d);
+          casadi_copy(v_z, nz_A_, w_d + nx_A_);
+        }
+      }
+    }
+  }
+
+  Dict Collocation::get_stats(void* mem) const {
+    Dict stats = ImplicitFixedStepIntegrator::get_stats(mem);
+    auto m = static_cast<CollocationMemory*>(mem);
+    if (simplified_newton_) {
+      stats["nniter"] = static_cast<casadi_int>(m->nniter);
+      stats["njevals"] = static_cast<casadi_int>(m->njevals);
+      stats["nlinsetups"] = static_cast<casadi_int>(m->nlinsetups);
+    }
+    return stats;
+  }
+
 } // namespace casadi
@@ -28,6 +28,7 @@
 
 #include "casadi/core/integrator_impl.hpp"
 #include "casadi/core/integration_tools.hpp"
+#include "casadi/core/linsol.hpp"
 #include <casadi/solvers/casadi_integrator_collocation_export.h>
 
 /** \defgroup plugin_Integrator_collocation
@@ -37,6 +38,17 @@
 
      The method is still under development
 
+     With the option simplified_newton, the collocation equations of the
+     forward problem are solved with simplified Newton iterations. The
+     Jacobian of the DAE is kept over iterations and finite elements, and
+     the iteration matrix is decoupled into one (real or complex) system of
+     the size of the DAE per eigenvalue of the collocation matrix.
+
+     Forward sensitivities are then calculated with a staggered corrector:
+     the iteration matrix is formed from the Jacobian of the nondifferentiated
+     DAE only, and the Newton steps of all sensitivity directions are obtained
+     by back-substitution with the same factorization.
+
 */
 
 /** \pluginsection{Integrator,collocation} */
@@ -44,6 +56,32 @@
 /// \cond INTERNAL
 namespace casadi {
 
+  struct CASADI_INTEGRATOR_COLLOCATION_EXPORT CollocationMemory : public FixedStepMemory {
+    // Jacobian of the DAE, with the ODE scaled by the step size
+    std::vector<double> K;
+
+    // Can the Jacobian be reused in the next finite element?
+    bool jac_valid;
+
+    // Decoupled iteration matrices
+    std::vector<double> A;
+
+    // Residual of the collocation equations, transformed Newton step
+    std::vector<double> eq, y;
+
+    // Newton step of a decoupled system, sorted by sensitivity direction
+    std::vector<double> ys;
+
+    // Quadrature right-hand sides at the collocation points
+    std::vector<double> quad;
+
+    // Linear solver memory, one for each decoupled system
+    std::vector<casadi_int> mem_linsol;
+
+    // Statistics
+    long nniter, njevals, nlinsetups;
+  };
+
   /**
      \brief \pluginbrief{Integrator,collocation}
 
@@ -83,9 +121,51 @@ namespace casadi {
     /// Initialize stage
     void init(const Dict& opts) override;
 
+    /** \brief Create memory block */
+    void* alloc_mem() const override { return new CollocationMemory();}
+
+    /** \brief Initalize memory block */
+    int init_mem(void* mem) const override;
+
+    /** \brief Free memory block */
+    void free_mem(void *mem) const override;
+
     /// Setup F and G
     void setupFG() override;
 
+    /// Take a step of the forward discrete time dynamics
+    void stepF(FixedStepMemory* m, double t, const double* x0, const double* Z0,
+               double* xf, double* Zf, double* qf) const override;
+
+    /// Dense output in the last step, using the collocation polynomial for x and z
+    void interpolate(FixedStepMemory* m, double theta,
+                     double* x, double* z, double* q) const override;
+
+    /// Get all statistics
+    Dict get_stats(void* mem) const override;
+
+    ///@{
+    /// Jacobian of the DAE, projected onto the sparsity of the decoupled systems
+    Function getJ() const;
+    template<typename MatType> Function getJ() const;
+    ///@}
+
+    /// Evaluate the Jacobian and factorize the decoupled systems
+    void jac(CollocationMemory* m, double t, const double* x0, const double* Z) const;
+
+    /// Evaluate the residual of the collocation equations
+    void residual(CollocationMemory* m, double t, const double* x0, const double* Z) const;
+
+    /// Simplified Newton iterations, returns false if not converged
+    bool newton(CollocationMemory* m, double t, const double* x0, double* Z) const;
+
+    /** \brief Sort a (real or complex) vector of the decoupled systems by sensitivity direction
+     *
+     * The states and algebraic variables of each direction are made contiguous,
+     * one right-hand side for each direction, or the reverse if \a inverse is true.
+     */
+    void sort_directions(double* v, double* w, casadi_int nblk, bool inverse) const;
+
     // Return zero if smaller than machine epsilon
     static double zeroIfSmall(double x);
 
@@ -103,6 +183,40 @@ namespace casadi {
     // Collocation scheme
     std::string collocation_scheme_;
 
+    // Collocation time points, including the start of the finite element
+    std::vector<double> tau_root_;
+
+    // Coefficients of the collocation equation, continuity equation and quadratures
+    std::vector<std::vector<double> > C_;
+    std::vector<double> D_, B_;
+
+    // Solve the collocation equations with simplified Newton iterations
+    bool simplified_newton_;
+
+    // Tolerance and maximum number of iterations
+    double newton_abstol_;
+    casadi_int newton_max_iter_;
+
+    // Linear solver
+    std::string linear_solver_;
+    Dict linear_solver_options_;
+    Linsol linsol1_, linsol2_;
+
+    // Iteration matrix of a real eigenvalue and of a complex pair of eigenvalues
+    Sparsity sp_A1_, sp_A2_;
+
+    // Number of sensitivity directions sharing the iteration matrix of the nominal DAE
+    casadi_int ns_shared_;
+
+    // Number of states and algebraic variables of the iteration matrix
+    casadi_int nx_A_, nz_A_;
+
+    // Transformation of the collocation matrix to real block diagonal form, row by row
+    std::vector<double> T_, Tinv_;
+
+    // Eigenvalues of the collocation matrix, one of each complex pair
+    std::vector<double> eig_re_, eig_im_;
+
     /// A documentation string
     static const std::string meta_doc;
 
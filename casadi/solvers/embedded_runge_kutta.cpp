@@ -0,0 +1,484 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "embedded_runge_kutta.hpp"
+
+using namespace std;
+namespace casadi {
+
+  extern "C"
+  int CASADI_INTEGRATOR_ERK_EXPORT
+      casadi_register_integrator_erk(Integrator::Plugin* plugin) {
+    plugin->creator = EmbeddedRungeKutta::creator;
+    plugin->name = "erk";
+    plugin->doc = EmbeddedRungeKutta::meta_doc.c_str();
+    plugin->version = CASADI_VERSION;
+    plugin->options = &EmbeddedRungeKutta::options_;
+    return 0;
+  }
+
+  extern "C"
+  void CASADI_INTEGRATOR_ERK_EXPORT casadi_load_integrator_erk() {
+    Integrator::registerPlugin(casadi_register_integrator_erk);
+  }
+
+  EmbeddedRungeKutta::EmbeddedRungeKutta(const std::string& name, const Function& dae)
+    : Integrator(name, dae) {
+  }
+
+  EmbeddedRungeKutta::~EmbeddedRungeKutta() {
+    clear_mem();
+  }
+
+  Options EmbeddedRungeKutta::options_
+  = {{&Integrator::options_},
+     {{"scheme",
+       {OT_STRING,
+        "Embedded Runge-Kutta pair: dopri5|bs32 [dopri5]"}},
+      {"abstol",
+       {OT_DOUBLE,
+        "Absolute tolerence for the IVP solution"}},
+      {"reltol",
+       {OT_DOUBLE,
+        "Relative tolerence for the IVP solution"}},
+      {"max_num_steps",
+       {OT_INT,
+        "Maximum number of integrator steps"}},
+      {"step0",
+       {OT_DOUBLE,
+        "initial step size [default: 0/estimated]"}},
+      {"max_step_size",
+       {OT_DOUBLE,
+        "Largest step size [default: inf]"}}
+     }
+  };
+
+  void EmbeddedRungeKutta::init(const Dict& opts) {
+    // Call the base class init
+    Integrator::init(opts);
+
+    // Default options
+    string scheme = "dopri5";
+    abstol_ = 1e-8;
+    reltol_ = 1e-6;
+    max_num_steps_ = 10000;
+    step0_ = 0;
+    max_step_size_ = inf;
+
+    // Read options
+    for (auto&& op : opts) {
+      if (op.first=="scheme") {
+        scheme = op.second.to_string();
+      } else if (op.first=="abstol") {
+        abstol_ = op.second;
+      } else if (op.first=="reltol") {
+        reltol_ = op.second;
+      } else if (op.first=="max_num_steps") {
+        max_num_steps_ = op.second;
+      } else if (op.first=="step0") {
+        step0_ = op.second;
+      } else if (op.first=="max_step_size") {
+        max_step_size_ = op.second;
+      }
+    }
+
+    // Algebraic variables not supported
+    casadi_assert(nz_==0 && nrz_==0,
+                  "Explicit Runge-Kutta integrators do not support algebraic variables");
+    casadi_assert(max_step_size_>0, "Maximum step size must be positive");
+
+    // Butcher tableau. Both pairs have the first same as last property: the last stage
+    // is evaluated at the solution, so that its row in A holds the weights of the solution
+    if (scheme=="dopri5") {
+      // Dormand-Prince 5(4), dense output of order 4 (Hairer, Norsett & Wanner)
+      nstages_ = 7;
+      order_ = 4;
+      c_ = {0., 1./5, 3./10, 4./5, 8./9, 1., 1.};
+      a_ = {0., 0., 0., 0., 0., 0., 0.,
+            1./5, 0., 0., 0., 0., 0., 0.,
+            3./40, 9./40, 0., 0., 0., 0., 0.,
+            44./45, -56./15, 32./9, 0., 0., 0., 0.,
+            19372./6561, -25360./2187, 64448./6561, -212./729, 0., 0., 0.,
+            9017./3168, -355./33, 46732./5247, 49./176, -5103./18656, 0., 0.,
+            35./384, 0., 500./1113, 125./192, -2187./6784, 11./84, 0.};
+      e_ = {71./57600, 0., -71./16695, 71./1920, -17253./339200, 22./525, -1./40};
+      d_ = {-12715105075./11282082432, 0., 87487479700./32700410799,
+            -10690763975./1880347072, 701980252875./199316789632,
+            -1453857185./822651844, 69997945./29380423};
+    } else if (scheme=="bs32") {
+      // Bogacki-Shampine 3(2), cubic Hermite dense output
+      nstages_ = 4;
+      order_ = 2;
+      c_ = {0., 1./2, 3./4, 1.};
+      a_ = {0., 0., 0., 0.,
+            1./2, 0., 0., 0.,
+            0., 3./4, 0., 0.,
+            2./9, 1./3, 4./9, 0.};
+      e_ = {-5./72, 1./12, 1./9, -1./8};
+      d_.clear();
+    } else {
+      casadi_error("Unknown scheme '" + scheme + "'. Possible values: dopri5, bs32");
+    }
+
+    // Right-hand sides, forward and backward problem, including quadratures
+    create_function("daeF", {"x", "p", "t"}, {"ode", "quad"});
+    if (nrx_>0) create_function("daeB", {"rx", "rp", "x", "p", "t"}, {"rode", "rquad"});
+
+    // Size of the integrated vectors
+    ny_ = nx_ + nq_;
+    nry_ = nrx_ + nrq_;
+  }
+
+  int EmbeddedRungeKutta::init_mem(void* mem) const {
+    if (Integrator::init_mem(mem)) return 1;
+    auto m = static_cast<EmbeddedRungeKuttaMemory*>(mem);
+
+    // Allocate vectors
+    casadi_int n = max(ny_, nry_);
+    m->p.resize(np_);
+    m->rp.resize(nrp_);
+    m->y.resize(ny_);
+    m->ry.resize(nry_);
+    m->k.resize(nstages_*ny_);
+    m->rk.resize(nstages_*nry_);
+    m->y_new.resize(n);
+    m->cont.resize(5*n);
+    m->x_interp.resize(nx_);
+    return 0;
+  }
+
+  void EmbeddedRungeKutta::rhs(EmbeddedRungeKuttaMemory* m, bool backward, double t,
+                               const double* y, double* ydot) const {
+    if (backward) {
+      // Forward state at time t, from the dense output of the step containing t
+      casadi_int nsteps = m->tape_t.size()-1;
+      casadi_int j = upper_bound(m->tape_t.begin(), m->tape_t.end(), t) - m->tape_t.begin() - 1;
+      j = min(max(j, casadi_int(0)), nsteps-1);
+      double theta = (t - m->tape_t[j])/(m->tape_t[j+1] - m->tape_t[j]);
+      interpolate(theta, nx_, get_ptr(m->tape) + 5*nx_*j, get_ptr(m->x_interp));
+
+      // Evaluate backward dynamics
+      m->arg[0] = y;
+      m->arg[1] = get_ptr(m->rp);
+      m->arg[2] = get_ptr(m->x_interp);
+      m->arg[3] = get_ptr(m->p);
+      m->arg[4] = &t;
+      m->res[0] = ydot;
+      m->res[1] = ydot + nrx_;
+      if (calc_function(m, "daeB")) casadi_error("'daeB' calculation failed");
+      m->nfevalsB++;
+    } else {
+      // Evaluate forward dynamics
+      m->arg[0] = y;
+      m->arg[1] = get_ptr(m->p);
+      m->arg[2] = &t;
+      m->res[0] = ydot;
+      m->res[1] = ydot + nx_;
+      if (calc_function(m, "daeF")) casadi_error("'daeF' calculation failed");
+      m->nfevals++;
+    }
+  }
+
+  /// Weighted RMS norm, as used for the error control
+  static double wrms_norm(casadi_int n, const double* v, const double* y, const double* y_new,
+                          double abstol, double reltol) {
+    if (n==0) return 0;
+    double r = 0;
+    for (casadi_int i=0; i<n; ++i) {
+      double sc = abstol + reltol*fmax(fabs(y[i]), fabs(y_new[i]));
+      r += (v[i]/sc)*(v[i]/sc);
+    }
+    return sqrt(r/static_cast<double>(n));
+  }
+
+  double EmbeddedRungeKutta::step(EmbeddedRungeKuttaMemory* m, bool backward, double t,
+                                  double h, const double* y, double* y_new, double* k) const {
+    casadi_int n = backward ? nry_ : ny_;
+    double dir = backward ? -1 : 1;
+
+    // Stages, the first one is available from the previous step
+    for (casadi_int i=1; i<nstages_; ++i) {
+      casadi_copy(y, n, y_new);
+      for (casadi_int j=0; j<i; ++j) {
+        double a = a_[nstages_*i + j];
+        if (a!=0) casadi_axpy(n, h*a, k + n*j, y_new);
+      }
+      rhs(m, backward, t + dir*c_[i]*h, y_new, k + n*i);
+    }
+
+    // The last stage was evaluated at the solution, estimate the error of the states
+    casadi_int nerr = backward ? nrx_ : nx_;
+    double* err = get_ptr(m->cont);
+    casadi_fill(err, nerr, 0.);
+    for (casadi_int j=0; j<nstages_; ++j) {
+      if (e_[j]!=0) casadi_axpy(nerr, h*e_[j], k + n*j, err);
+    }
+    return wrms_norm(nerr, err, y, y_new, abstol_, reltol_);
+  }
+
+  double EmbeddedRungeKutta::initial_step(EmbeddedRungeKuttaMemory* m, bool backward, double t,
+                                          const double* y, double* k) const {
+    // Hairer, Norsett & Wanner, Solving Ordinary Differential Equations I, Sec. II.4
+    casadi_int n = backward ? nry_ : ny_;
+    casadi_int nerr = backward ? nrx_ : nx_;
+    double dir = backward ? -1 : 1;
+    double t_end = backward ? grid_.front() : grid_.back();
+    double d0 = wrms_norm(nerr, y, y, y, abstol_, reltol_);
+    double d1 = wrms_norm(nerr, k, y, y, abstol_, reltol_);
+    double h0 = d0<1e-5 || d1<1e-5 ? 1e-6 : 0.01*d0/d1;
+    h0 = fmin(h0, fabs(t_end - t));
+
+    // Explicit Euler step, using the second stage as work vector
+    double* y1 = get_ptr(m->y_new);
+    double* f1 = k + n;
+    casadi_copy(y, n, y1);
+    casadi_axpy(n, h0, k, y1);
+    rhs(m, backward, t + dir*h0, y1, f1);
+    casadi_axpy(nerr, -1., k, f1);
+    double d2 = wrms_norm(nerr, f1, y, y, abstol_, reltol_)/h0;
+
+    // Step size such that the local error is about 0.01
+    double dmax = fmax(d1, d2);
+    double h1 = dmax<=1e-15 ? fmax(1e-6, 1e-3*h0)
+      : pow(0.01/dmax, 1./static_cast<double>(order_+1));
+    return fmin(100*h0, h1);
+  }
+
+  void EmbeddedRungeKutta::dense_output(double h, casadi_int n, const double* y,
+                                        const double* y_new, const double* k,
+                                        double* cont) const {
+    double *r1 = cont, *r2 = cont+n, *r3 = cont+2*n, *r4 = cont+3*n, *r5 = cont+4*n;
+    const double* k_last = k + n*(nstages_-1);
+    for (casadi_int i=0; i<n; ++i) {
+      r1[i] = y[i];
+      r2[i] = y_new[i] - y[i];
+      r3[i] = h*k[i] - r2[i];
+      r4[i] = r2[i] - h*k_last[i] - r3[i];
+    }
+    // Higher order correction, if not cubic Hermite interpolation
+    casadi_fill(r5, n, 0.);
+    for (casadi_int j=0; j<d_.size(); ++j) {
+      if (d_[j]!=0) casadi_axpy(n, h*d_[j], k + n*j, r5);
+    }
+  }
+
+  void EmbeddedRungeKutta::interpolate(double theta, casadi_int n, const double* cont,
+                                       double* y) {
+    const double *r1 = cont, *r2 = cont+n, *r3 = cont+2*n, *r4 = cont+3*n, *r5 = cont+4*n;
+    double theta1 = 1 - theta;
+    for (casadi_int i=0; i<n; ++i) {
+      y[i] = r1[i] + theta*(r2[i] + theta1*(r3[i] + theta*(r4[i] + theta1*r5[i])));
+    }
+  }
+
+  void EmbeddedRungeKutta::integrate(EmbeddedRungeKuttaMemory* m, bool backward,
+                                     double t_out) const {
+    // Forward or backward problem
+    double& t = backward ? m->rt : m->t;
+    double& h = backward ? m->rh : m->h;
+    double* y = get_ptr(backward ? m->ry : m->y);
+    double* k = get_ptr(backward ? m->rk : m->k);
+    long& nsteps = backward ? m->nstepsB : m->nsteps;
+    long& netfails = backward ? m->netfailsB : m->netfails;
+    casadi_int n = backward ? nry_ : ny_;
+    double dir = backward ? -1 : 1;
+    double t_end = backward ? grid_.front() : grid_.back();
+    double* y_new = get_ptr(m->y_new);
+
+    // Exponent in the step size control
+    double expo = 1./static_cast<double>(order_+1);
+
+    // Take steps until t_out has been reached
+    while (dir*(t_out - t) > 0) {
+      casadi_assert(nsteps<max_num_steps_,
+        "Maximum number of steps (" + str(max_num_steps_) + ") reached at t=" + str(t));
+
+      // Initial step size
+      if (h==0) h = step0_>0 ? step0_ : initial_step(m, backward, t, y, k);
+      h = fmin(h, max_step_size_);
+
+      // Try steps until the error test passes
+      double fac_max = 5;
+      double err;
+      bool last;
+      while (true) {
+        // Do not step past the end of the time horizon
+        double remaining = dir*(t_end - t);
+        last = h >= remaining*(1 - 1e-12);
+        if (last) h = remaining;
+        casadi_assert(h>16*eps*fabs(t), "Step size too small at t=" + str(t));
+
+        // Take step
+        err = step(m, backward, t, h, y, y_new, k);
+        if (err<=1) break;
+
+        // Step rejected, reduce step size
+        netfails++;
+        h *= fmax(0.2, 0.9*pow(err, -expo));
+        fac_max = 1;
+      }
+
+      // Dense output of the accepted step
+      dense_output(h, n, y, y_new, k, get_ptr(m->cont));
+      m->t_old = t;
+      m->h_old = h;
+      t = last ? t_end : t + dir*h;
+      nsteps++;
+
+      // Forward state trajectory, for the backward problem
+      if (!backward && nrx_>0) {
+        for (casadi_int r=0; r<5; ++r) {
+          const double* c = get_ptr(m->cont) + n*r;
+          m->tape.insert(m->tape.end(), c, c + nx_);
+        }
+        m->tape_t.push_back(t);
+      }
+
+      // Accept step, the last stage is the first stage of the next step
+      casadi_copy(y_new, n, y);
+      casadi_copy(k + n*(nstages_-1), n, k);
+
+      // Step size for the next step
+      h *= err==0 ? fac_max : fmin(fac_max, fmax(0.2, 0.9*pow(err, -expo)));
+    }
+
+    // Interpolate the solution at t_out
+    if (m->h_old==0) {
+      casadi_copy(y, n, y_new);
+    } else {
+      interpolate(dir*(t_out - m->t_old)/m->h_old, n, get_ptr(m->cont), y_new);
+    }
+  }
+
+  void EmbeddedRungeKutta::reset(IntegratorMemory* mem, double t, const double* x,
+                                 const double* z, const double* p) const {
+    auto m = static_cast<EmbeddedRungeKuttaMemory*>(mem);
+
+    // Update time, step size to be estimated
+    m->t = t;
+    m->h = 0;
+    m->h_old = 0;
+
+    // Set parameters
+    casadi_copy(p, np_, get_ptr(m->p));
+
+    // Update the state, reset quadratures
+    casadi_copy(x, nx_, get_ptr(m->y));
+    casadi_fill(get_ptr(m->y) + nx_, nq_, 0.);
+
+    // Reset statistics
+    m->nsteps = m->nfevals = m->netfails = 0;
+
+    // Clear the tape
+    if (nrx_>0) {
+      m->tape.clear();
+      m->tape_t.clear();
+      m->tape_t.push_back(t);
+    }
+
+    // First stage
+    rhs(m, false, t, get_ptr(m->y), get_ptr(m->k));
+  }
+
+  void EmbeddedRungeKutta::advance(IntegratorMemory* mem, double t,
+                                   double* x, double* z, double* q) const {
+    auto m = static_cast<EmbeddedRungeKuttaMemory*>(mem);
+
+    // Integrate and interpolate at t
+    integrate(m, false, t);
+
+    // Return to user
+    casadi_copy(get_ptr(m->y_new), nx_, x);
+    casadi_copy(get_ptr(m->y_new) + nx_, nq_, q);
+  }
+
+  void EmbeddedRungeKutta::resetB(IntegratorMemory* mem, double t, const double* rx,
+                                  const double* rz, const double* rp) const {
+    auto m = static_cast<EmbeddedRungeKuttaMemory*>(mem);
+    casadi_assert(m->tape_t.size()>1 && m->t==grid_.back(),
+                  "Forward integration must reach the end of the time horizon");
+
+    // Update time, step size to be estimated
+    m->rt = t;
+    m->rh = 0;
+    m->h_old = 0;
+
+    // Set parameters
+    casadi_copy(rp, nrp_, get_ptr(m->rp));
+
+    // Update the state, reset quadratures
+    casadi_copy(rx, nrx_, get_ptr(m->ry));
+    casadi_fill(get_ptr(m->ry) + nrx_, nrq_, 0.);
+
+    // Reset statistics
+    m->nstepsB = m->nfevalsB = m->netfailsB = 0;
+
+    // First stage
+    rhs(m, true, t, get_ptr(m->ry), get_ptr(m->rk));
+  }
+
+  void EmbeddedRungeKutta::retreat(IntegratorMemory* mem, double t,
+                                   double* rx, double* rz, double* rq) const {
+    auto m = static_cast<EmbeddedRungeKuttaMemory*>(mem);
+
+    // Integrate backward and interpolate at t
+    integrate(m, true, t);
+
+    // Return to user
+    casadi_copy(get_ptr(m->y_new), nrx_, rx);
+    casadi_copy(get_ptr(m->y_new) + nrx_, nrq_, rq);
+  }
+
+  void EmbeddedRungeKutta::print_stats(IntegratorMemory* mem) const {
+    auto m = static_cast<EmbeddedRungeKuttaMemory*>(mem);
+    print("FORWARD INTEGRATION:\n");
+    print("Number of steps taken: %ld\n", m->nsteps);
+    print("Number of calls to the user's f function: %ld\n", m->nfevals);
+    print("Number of error test failures: %ld\n", m->netfails);
+    if (nrx_>0) {
+      print("BACKWARD INTEGRATION:\n");
+      print("Number of steps taken: %ld\n", m->nstepsB);
+      print("Number of calls to the user's f function: %ld\n", m->nfevalsB);
+      print("Number of error test failures: %ld\n", m->netfailsB);
+    }
+  }
+
+  Dict EmbeddedRungeKutta::get_stats(void* mem) const {
+    Dict stats = Integrator::get_stats(mem);
+    auto m = static_cast<EmbeddedRungeKuttaMemory*>(mem);
+
+    // Counters, forward problem
+    stats["nsteps"] = static_cast<casadi_int>(m->nsteps);
+    stats["nfevals"] = static_cast<casadi_int>(m->nfevals);
+    stats["netfails"] = static_cast<casadi_int>(m->netfails);
+
+    // Counters, backward problem
+    stats["nstepsB"] = static_cast<casadi_int>(m->nstepsB);
+    stats["nfevalsB"] = static_cast<casadi_int>(m->nfevalsB);
+    stats["netfailsB"] = static_cast<casadi_int>(m->netfailsB);
+    return stats;
+  }
+
+} // namespace casadi
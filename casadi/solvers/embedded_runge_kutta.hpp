@@ -0,0 +1,204 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_EMBEDDED_RUNGE_KUTTA_HPP
+#define CASADI_EMBEDDED_RUNGE_KUTTA_HPP
+
+#include "casadi/core/integrator_impl.hpp"
+#include <casadi/solvers/casadi_integrator_erk_export.h>
+
+/** \defgroup plugin_Integrator_erk
+      Adaptive-step explicit Runge-Kutta integrator for ODEs, using an embedded
+      error estimate for step size control. Implements the Dormand-Prince 5(4)
+      and Bogacki-Shampine 3(2) pairs, with dense output for the time grid.
+
+      Adjoint sensitivities are calculated by integrating the backward problem
+      with its own step size control, interpolating the forward solution from
+      the dense output of the accepted forward steps.
+*/
+/** \pluginsection{Integrator,erk} */
+
+/// \cond INTERNAL
+namespace casadi {
+
+  struct CASADI_INTEGRATOR_ERK_EXPORT EmbeddedRungeKuttaMemory : public IntegratorMemory {
+    // Current time, forward and backward problem
+    double t, rt;
+
+    // Step size to be attempted next, forward and backward problem
+    double h, rh;
+
+    // Parameters, forward and backward problem
+    std::vector<double> p, rp;
+
+    // Current state, including quadratures, forward and backward problem
+    std::vector<double> y, ry;
+
+    // Stage derivatives, forward and backward problem
+    std::vector<double> k, rk;
+
+    // Candidate state, or interpolated state after integration
+    std::vector<double> y_new;
+
+    // Dense output of the last accepted step
+    double t_old, h_old;
+    std::vector<double> cont;
+
+    // Start times of the accepted forward steps
+    std::vector<double> tape_t;
+
+    // Dense output of the forward state for all accepted steps, stored contiguously
+    std::vector<double> tape;
+
+    // Interpolated forward state
+    std::vector<double> x_interp;
+
+    // Statistics
+    long nsteps, nfevals, netfails, nstepsB, nfevalsB, netfailsB;
+  };
+
+  /** \brief \pluginbrief{Integrator,erk}
+
+      @copydoc DAE_doc
+      @copydoc plugin_Integrator_erk
+
+  */
+  class CASADI_INTEGRATOR_ERK_EXPORT EmbeddedRungeKutta : public Integrator {
+  public:
+
+    /// Constructor
+    explicit EmbeddedRungeKutta(const std::string& name, const Function& dae);
+
+    /** \brief  Create a new integrator */
+    static Integrator* creator(const std::string& name, const Function& dae) {
+      return new EmbeddedRungeKutta(name, dae);
+    }
+
+    /// Destructor
+    ~EmbeddedRungeKutta() override;
+
+    // Get name of the plugin
+    const char* plugin_name() const override { return "erk";}
+
+    // Get name of the class
+    std::string class_name() const override { return "EmbeddedRungeKutta";}
+
+    ///@{
+    /** \brief Options */
+    static Options options_;
+    const Options& get_options() const override { return options_;}
+    ///@}
+
+    /// Initialize stage
+    void init(const Dict& opts) override;
+
+    /** \brief Create memory block */
+    void* alloc_mem() const override { return new EmbeddedRungeKuttaMemory();}
+
+    /** \brief Initalize memory block */
+    int init_mem(void* mem) const override;
+
+    /** \brief Free memory block */
+    void free_mem(void *mem) const override {
+      delete static_cast<EmbeddedRungeKuttaMemory*>(mem);
+    }
+
+    /** \brief Reset the forward problem */
+    void reset(IntegratorMemory* mem, double t,
+               const double* x, const double* z, const double* p) const override;
+
+    /** \brief  Advance solution in time */
+    void advance(IntegratorMemory* mem, double t,
+                 double* x, double* z, double* q) const override;
+
+    /** \brief Reset the backward problem */
+    void resetB(IntegratorMemory* mem, double t,
+                const double* rx, const double* rz, const double* rp) const override;
+
+    /** \brief  Retreat solution in time */
+    void retreat(IntegratorMemory* mem, double t,
+                 double* rx, double* rz, double* rq) const override;
+
+    /** \brief  Print solver statistics */
+    void print_stats(IntegratorMemory* mem) const override;
+
+    /// Get all statistics
+    Dict get_stats(void* mem) const override;
+
+    /// Evaluate the right-hand side, forward or backward problem
+    void rhs(EmbeddedRungeKuttaMemory* m, bool backward, double t,
+             const double* y, double* ydot) const;
+
+    /// Take a step of size h, returns the weighted RMS norm of the error estimate
+    double step(EmbeddedRungeKuttaMemory* m, bool backward, double t, double h,
+                const double* y, double* y_new, double* k) const;
+
+    /// Initial step size
+    double initial_step(EmbeddedRungeKuttaMemory* m, bool backward, double t,
+                        const double* y, double* k) const;
+
+    /// Integrate until time t has been passed, the state interpolated at t is stored in y_new
+    void integrate(EmbeddedRungeKuttaMemory* m, bool backward, double t) const;
+
+    /// Dense output of a step
+    void dense_output(double h, casadi_int n, const double* y, const double* y_new,
+                      const double* k, double* cont) const;
+
+    /// Evaluate the dense output of a step
+    static void interpolate(double theta, casadi_int n, const double* cont, double* y);
+
+    /// A documentation string
+    static const std::string meta_doc;
+
+    // Butcher tableau, the weights of the solution are given by the last row of A
+    casadi_int nstages_;
+    std::vector<double> a_, c_;
+
+    // Weights of the error estimate and of the dense output
+    std::vector<double> e_, d_;
+
+    // Order of the error estimate
+    casadi_int order_;
+
+    // Tolerances
+    double abstol_, reltol_;
+
+    // Maximum number of steps
+    casadi_int max_num_steps_;
+
+    // Initial step size, 0 to estimate
+    double step0_;
+
+    // Largest step size
+    double max_step_size_;
+
+    // Size of the integrated vectors, forward and backward problem
+    casadi_int ny_, nry_;
+  };
+
+} // namespace casadi
+
+/// \endcond
+#endif // CASADI_EMBEDDED_RUNGE_KUTTA_HPP
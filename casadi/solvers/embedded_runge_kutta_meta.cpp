@@ -0,0 +1,74 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+      #include "embedded_runge_kutta.hpp"
+      #include <string>
+
+      const std::string casadi::EmbeddedRungeKutta::meta_doc=
+      "\n"
+"Adaptive-step explicit Runge-Kutta integrator for ODEs, using an\n"
+"embedded error estimate for step size control. Implements the Dormand-\n"
+"Prince 5(4) and Bogacki-Shampine 3(2) pairs, with dense output for the\n"
+"time grid.\n"
+"\n"
+"Adjoint sensitivities are calculated by integrating the backward\n"
+"problem with its own step size control, interpolating the forward\n"
+"solution from the dense output of the accepted forward steps.\n"
+"\n"
+"\n"
+">List of available options\n"
+"\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"|       Id        |      Type       |     Default     |   Description   |\n"
+"+=================+=================+=================+=================+\n"
+"| abstol          | OT_DOUBLE       | 1e-8            | Absolute        |\n"
+"|                 |                 |                 | tolerence for   |\n"
+"|                 |                 |                 | the IVP         |\n"
+"|                 |                 |                 | solution        |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| max_num_steps   | OT_INT          | 10000           | Maximum number  |\n"
+"|                 |                 |                 | of integrator   |\n"
+"|                 |                 |                 | steps           |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| max_step_size   | OT_DOUBLE       | inf             | Largest step    |\n"
+"|                 |                 |                 | size            |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| reltol          | OT_DOUBLE       | 1e-6            | Relative        |\n"
+"|                 |                 |                 | tolerence for   |\n"
+"|                 |                 |                 | the IVP         |\n"
+"|                 |                 |                 | solution        |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| scheme          | OT_STRING       | dopri5          | Embedded Runge- |\n"
+"|                 |                 |                 | Kutta pair:     |\n"
+"|                 |                 |                 | dopri5|bs32     |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| step0           | OT_DOUBLE       | 0/estimated     | initial step    |\n"
+"|                 |                 |                 | size            |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"\n"
+"\n"
+"\n"
+"\n"
+;
@@ -169,7 +169,7 @@ namespace casadi {
   void FastNewton::codegen_body(CodeGenerator& g) const {
     g.add_auxiliary(CodeGenerator::AUX_NEWTON);
 
-    g.local("m", "struct casadi_newton_mem");
+    g.local_struct<casadi_newton_mem>("m", "casadi_newton_mem");
 
     g << "m.n = " << n_ << ";\n";
     g << "m.abstol = " << abstol_ << ";\n";
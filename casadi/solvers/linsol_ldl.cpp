@@ -57,8 +57,16 @@ namespace casadi {
     // Call the init method of the base class
     LinsolInternal::init(opts);
 
+    // Patterns made of dense blocks are factorized block by block
+    bs_ = sp_.block_size();
+    if (bs_==nrow()) bs_ = 1;
+
     // Symbolic factorization
-    sp_Lt_ = sp_.ldl(p_);
+    if (bs_>1) {
+      sp_Lt_ = sp_.block_compress(bs_).ldl(p_);
+    } else {
+      sp_Lt_ = sp_.ldl(p_);
+    }
   }
 
   int LinsolLdl::init_mem(void* mem) const {
@@ -68,8 +76,9 @@ namespace casadi {
     // Work vectors
     casadi_int nrow = this->nrow();
     m->d.resize(nrow);
-    m->l.resize(sp_Lt_.nnz());
-    m->w.resize(nrow);
+    m->l.resize(sp_Lt_.nnz()*bs_*bs_);
+    m->w.resize(nrow*bs_);
+    if (bs_>1) m->dl.resize(nrow*bs_);
 
     return 0;
   }
@@ -80,7 +89,12 @@ namespace casadi {
 
   int LinsolLdl::nfact(void* mem, const double* A) const {
     auto m = static_cast<LinsolLdlMemory*>(mem);
-    casadi_ldl(sp_, A, sp_Lt_, get_ptr(m->l), get_ptr(m->d), get_ptr(p_), get_ptr(m->w));
+    if (bs_>1) {
+      casadi_block_ldl(sp_, A, sp_Lt_, get_ptr(m->l), get_ptr(m->dl), get_ptr(m->d),
+                       get_ptr(p_), get_ptr(m->w), bs_);
+    } else {
+      casadi_ldl(sp_, A, sp_Lt_, get_ptr(m->l), get_ptr(m->d), get_ptr(p_), get_ptr(m->w));
+    }
     for (double d : m->d) {
       if (d==0) casadi_warning("LDL factorization has zeros in D");
     }
@@ -89,7 +103,13 @@ namespace casadi {
 
   int LinsolLdl::solve(void* mem, const double* A, double* x, casadi_int nrhs, bool tr) const {
     auto m = static_cast<LinsolLdlMemory*>(mem);
-    casadi_ldl_solve(x, nrhs, sp_Lt_, get_ptr(m->l), get_ptr(m->d), get_ptr(p_), get_ptr(m->w));
+    if (bs_>1) {
+      casadi_block_ldl_solve(x, nrhs, sp_Lt_, get_ptr(m->l), get_ptr(m->dl), get_ptr(m->d),
+                             get_ptr(p_), get_ptr(m->w), bs_);
+    } else {
+      casadi_ldl_solve(x, nrhs, sp_Lt_, get_ptr(m->l), get_ptr(m->d), get_ptr(p_),
+                       get_ptr(m->w));
+    }
     return 0;
   }
 
@@ -121,18 +141,59 @@ namespace casadi {
     // Place in block to avoid conflicts caused by local variables
     g << "{\n";
     g.comment("FIXME(@jaeandersson): Memory allocation can be avoided");
-    g << "casadi_real lt[" << sp_Lt_.nnz() << "], "
+    g << "casadi_real lt[" << sp_Lt_.nnz()*bs_*bs_ << "], "
          "d[" << nrow() << "], "
-         "w[" << nrow() << "];\n";
-
-    // Factorize
-    g << g.ldl(sp, A, sp_Lt, "lt", "d", p, "w") << "\n";
-
-    // Solve
-    g << g.ldl_solve(x, nrhs, sp_Lt, "lt", "d", p, "w") << "\n";
+         "w[" << nrow()*bs_ << "];\n";
+
+    if (bs_>1) {
+      g << "casadi_real dl[" << nrow()*bs_ << "];\n";
+      // Factorize and solve
+      g << g.block_ldl(sp, A, sp_Lt, "lt", "dl", "d", p, "w", bs_) << "\n";
+      g << g.block_ldl_solve(x, nrhs, sp_Lt, "lt", "dl", "d", p, "w", bs_) << "\n";
+    } else {
+      // Factorize
+      g << g.ldl(sp, A, sp_Lt, "lt", "d", p, "w") << "\n";
+
+      // Solve
+      g << g.ldl_solve(x, nrhs, sp_Lt, "lt", "d", p, "w") << "\n";
+    }
 
     // End of block
     g << "}\n";
   }
 
+  casadi_int LinsolLdl::sz_w_generate() const {
+    // Factors lt, d and (block case) dl followed by work
+    casadi_int sz = sp_Lt_.nnz()*bs_*bs_ + nrow() + nrow()*bs_;
+    if (bs_>1) sz += nrow()*bs_;
+    return sz;
+  }
+
+  void LinsolLdl::generate_nfact(CodeGenerator& g, const std::string& A,
+                                 const std::string& w) const {
+    casadi_int nl = sp_Lt_.nnz()*bs_*bs_, nd = nrow(), nw = nrow()*bs_;
+    string lt = w, d = w + "+" + str(nl), wk = w + "+" + str(nl + nd);
+    if (bs_>1) {
+      string dl = w + "+" + str(nl + nd + nw);
+      g << g.block_ldl(g.sparsity(sp_), A, g.sparsity(sp_Lt_), lt, dl, d, g.constant(p_),
+                       wk, bs_) << "\n";
+    } else {
+      g << g.ldl(g.sparsity(sp_), A, g.sparsity(sp_Lt_), lt, d, g.constant(p_), wk) << "\n";
+    }
+  }
+
+  void LinsolLdl::generate_solve(CodeGenerator& g, const std::string& x, casadi_int nrhs,
+                                 bool tr, const std::string& w) const {
+    // Symmetric: the transposed solve is the same as the regular one
+    casadi_int nl = sp_Lt_.nnz()*bs_*bs_, nd = nrow(), nw = nrow()*bs_;
+    string lt = w, d = w + "+" + str(nl), wk = w + "+" + str(nl + nd);
+    if (bs_>1) {
+      string dl = w + "+" + str(nl + nd + nw);
+      g << g.block_ldl_solve(x, nrhs, g.sparsity(sp_Lt_), lt, dl, d, g.constant(p_),
+                             wk, bs_) << "\n";
+    } else {
+      g << g.ldl_solve(x, nrhs, g.sparsity(sp_Lt_), lt, d, g.constant(p_), wk) << "\n";
+    }
+  }
+
 } // namespace casadi
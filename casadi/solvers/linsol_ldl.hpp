@@ -27,7 +27,9 @@
 #define CASADI_LINSOL_LDL_HPP
 
 /** \defgroup plugin_Linsol_ldl
-  * Linear solver using sparse direct LDL factorization
+  * Linear solver using sparse direct LDL factorization.
+  * Patterns made of dense, aligned square blocks are factorized block by block,
+  * with dense inner loops.
 */
 
 /** \pluginsection{Linsol,ldl} */
@@ -39,6 +41,8 @@
 namespace casadi {
   struct CASADI_LINSOL_LDL_EXPORT LinsolLdlMemory : public LinsolMemory {
     std::vector<double> l, d, w;
+    // Factorized diagonal blocks (block factorization only)
+    std::vector<double> dl;
   };
 
   /** \brief \pluginbrief{LinsolInternal,ldl}
@@ -84,6 +88,16 @@ namespace casadi {
     void generate(CodeGenerator& g, const std::string& A, const std::string& x,
                   casadi_int nrhs, bool tr) const override;
 
+    ///@{
+    /// Generate the factorization and the solve separately
+    bool has_generate_nfact() const override { return true;}
+    casadi_int sz_w_generate() const override;
+    void generate_nfact(CodeGenerator& g, const std::string& A,
+                        const std::string& w) const override;
+    void generate_solve(CodeGenerator& g, const std::string& x, casadi_int nrhs,
+                        bool tr, const std::string& w) const override;
+    ///@}
+
     /// Number of negative eigenvalues
     casadi_int neig(void* mem, const double* A) const override;
 
@@ -99,7 +113,10 @@ namespace casadi {
     // Get name of the class
     std::string class_name() const override { return "LinsolLdl";}
 
-    // Symbolic factorization
+    // Block size, 1 if the pattern is not blocked
+    casadi_int bs_;
+
+    // Symbolic factorization, of the block pattern if bs_>1
     std::vector<casadi_int> p_;
     Sparsity sp_Lt_;
   };
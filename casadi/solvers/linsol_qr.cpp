@@ -120,4 +120,25 @@ namespace casadi {
     g << "}\n";
   }
 
+  casadi_int LinsolQr::sz_w_generate() const {
+    // Factors v, r and beta followed by work
+    return sp_v_.nnz() + sp_r_.nnz() + ncol() + nrow() + ncol();
+  }
+
+  void LinsolQr::generate_nfact(CodeGenerator& g, const std::string& A,
+                                const std::string& w) const {
+    casadi_int nv = sp_v_.nnz(), nr = sp_r_.nnz();
+    g << g.qr(g.sparsity(sp_), A, w + "+" + str(nv + nr + ncol()),
+              g.sparsity(sp_v_), w, g.sparsity(sp_r_), w + "+" + str(nv),
+              w + "+" + str(nv + nr), g.constant(prinv_), g.constant(pc_)) << "\n";
+  }
+
+  void LinsolQr::generate_solve(CodeGenerator& g, const std::string& x, casadi_int nrhs,
+                                bool tr, const std::string& w) const {
+    casadi_int nv = sp_v_.nnz(), nr = sp_r_.nnz();
+    g << g.qr_solve(x, nrhs, tr, g.sparsity(sp_v_), w, g.sparsity(sp_r_), w + "+" + str(nv),
+                    w + "+" + str(nv + nr), g.constant(prinv_), g.constant(pc_),
+                    w + "+" + str(nv + nr + ncol())) << "\n";
+  }
+
 } // namespace casadi
@@ -84,6 +84,16 @@ namespace casadi {
     void generate(CodeGenerator& g, const std::string& A, const std::string& x,
                   casadi_int nrhs, bool tr) const override;
 
+    ///@{
+    /// Generate the factorization and the solve separately
+    bool has_generate_nfact() const override { return true;}
+    casadi_int sz_w_generate() const override;
+    void generate_nfact(CodeGenerator& g, const std::string& A,
+                        const std::string& w) const override;
+    void generate_solve(CodeGenerator& g, const std::string& x, casadi_int nrhs,
+                        bool tr, const std::string& w) const override;
+    ///@}
+
     // Get name of the plugin
     const char* plugin_name() const override { return "qr";}
 
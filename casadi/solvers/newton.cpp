@@ -66,7 +66,20 @@ namespace casadi {
         "Maximum number of Newton iterations to perform before returning."}},
       {"print_iteration",
        {OT_BOOL,
-        "Print information about each iteration"}}
+        "Print information about each iteration"}},
+      {"jacobian_update",
+       {OT_STRING,
+        "Jacobian used in the iterations: exact (evaluated in every iteration), "
+        "modified (kept together with its factorization) or "
+        "broyden (corrected by sparse rank-1 updates) [exact]"}},
+      {"max_jacobian_age",
+       {OT_INT,
+        "Maximum number of iterations before the Jacobian is reevaluated, "
+        "modified and broyden only [10]"}},
+      {"max_contraction_rate",
+       {OT_DOUBLE,
+        "Reevaluate the Jacobian if the ratio between the norms of two consecutive "
+        "steps exceeds this value, modified and broyden only [0.5]"}}
      }
   };
 
@@ -80,6 +93,9 @@ namespace casadi {
     abstol_ = 1e-12;
     abstolStep_ = 1e-12;
     print_iteration_ = false;
+    string jacobian_update = "exact";
+    max_jacobian_age_ = 10;
+    max_contraction_rate_ = 0.5;
 
     // Read options
     for (auto&& op : opts) {
@@ -91,18 +107,42 @@ namespace casadi {
         abstolStep_ = op.second;
       } else if (op.first=="print_iteration") {
         print_iteration_ = op.second;
+      } else if (op.first=="jacobian_update") {
+        jacobian_update = op.second.to_string();
+      } else if (op.first=="max_jacobian_age") {
+        max_jacobian_age_ = op.second;
+      } else if (op.first=="max_contraction_rate") {
+        max_contraction_rate_ = op.second;
       }
     }
 
+    // Jacobian update
+    if (jacobian_update=="exact") {
+      jacobian_update_ = JAC_EXACT;
+    } else if (jacobian_update=="modified") {
+      jacobian_update_ = JAC_MODIFIED;
+    } else if (jacobian_update=="broyden") {
+      jacobian_update_ = JAC_BROYDEN;
+    } else {
+      casadi_error("Unknown Jacobian update: " + jacobian_update);
+    }
+    casadi_assert(max_jacobian_age_>=1, "Option 'max_jacobian_age' must be positive");
+
     casadi_assert(oracle_.n_in()>0,
                           "Newton: the supplied f must have at least one input.");
     casadi_assert(!linsol_.is_null(),
                           "Newton::init: linear_solver must be supplied");
 
+    // Residual without the Jacobian, for the iterations that keep the Jacobian
+    if (jacobian_update_!=JAC_EXACT) set_function(oracle_, "f_z");
+
     // Allocate memory
     alloc_w(n_, true); // x
     alloc_w(n_, true); // F
     alloc_w(sp_jac_.nnz(), true); // J
+    alloc_w(n_, true); // dx
+    alloc_w(n_, true); // f_prev
+    alloc_w(n_, true); // v
   }
 
  void Newton::set_work(void* mem, const double**& arg, double**& res,
@@ -112,6 +152,9 @@ namespace casadi {
      m->x = w; w += n_;
      m->f = w; w += n_;
      m->jac = w; w += sp_jac_.nnz();
+     m->dx = w; w += n_;
+     m->f_prev = w; w += n_;
+     m->v = w; w += n_;
   }
 
   int Newton::solve(void* mem) const {
@@ -124,7 +167,11 @@ namespace casadi {
 
     // Perform the Newton iterations
     m->iter=0;
+    m->jac_count = m->fact_count = m->res_count = 0;
     bool success = true;
+    bool new_jac = true;
+    casadi_int jac_age = 0;
+    double norm_step_prev = 0;
     while (true) {
       // Break if maximum number of iterations already reached
       if (m->iter >= max_iter_) {
@@ -137,13 +184,23 @@ namespace casadi {
       // Start a new iteration
       m->iter++;
 
-      // Use x to evaluate J
+      // Use x to evaluate J, or only F if the Jacobian is kept
+      if (jacobian_update_==JAC_EXACT) new_jac = true;
       copy_n(m->iarg, n_in_, m->arg);
       m->arg[iin_] = m->x;
-      m->res[0] = m->jac;
-      copy_n(m->ires, n_out_, m->res+1);
-      m->res[1+iout_] = m->f;
-      calc_function(m, "jac_f_z");
+      if (new_jac) {
+        m->res[0] = m->jac;
+        copy_n(m->ires, n_out_, m->res+1);
+        m->res[1+iout_] = m->f;
+        calc_function(m, "jac_f_z");
+        m->jac_count++;
+        jac_age = 0;
+      } else {
+        copy_n(m->ires, n_out_, m->res);
+        m->res[iout_] = m->f;
+        calc_function(m, "f_z");
+        m->res_count++;
+      }
 
       // Check convergence
       double abstol = 0;
@@ -157,8 +214,15 @@ namespace casadi {
         }
       }
 
+      // Correct the Jacobian with the secant condition J*dx = f - f_prev
+      if (jacobian_update_==JAC_BROYDEN && !new_jac) broyden(m);
+
       // Factorize the linear solver with J
-      linsol_.nfact(m->jac, mem_linsol);
+      if (new_jac || jacobian_update_==JAC_BROYDEN) {
+        linsol_.nfact(m->jac, mem_linsol);
+        m->fact_count++;
+      }
+      casadi_copy(m->f, n_, m->f_prev);
       linsol_.solve(m->jac, m->f, 1, false, mem_linsol);
 
       // Check convergence again
@@ -183,8 +247,18 @@ namespace casadi {
         printIteration(uout(), m->iter, abstol, abstolStep);
       }
 
+      // Reevaluate the Jacobian if it is too old or if the convergence is too slow
+      if (jacobian_update_!=JAC_EXACT) {
+        double norm_step = casadi_norm_inf(n_, m->f);
+        new_jac = ++jac_age >= max_jacobian_age_
+          || (jac_age>1 && norm_step > max_contraction_rate_*norm_step_prev);
+        norm_step_prev = norm_step;
+      }
+
       // Update Xk+1 = Xk - J^(-1) F
       casadi_axpy(n_, -1., m->f, m->x);
+      casadi_copy(m->f, n_, m->dx);
+      casadi_scal(n_, -1., m->dx);
     }
 
     // Get the solution
@@ -199,6 +273,27 @@ namespace casadi {
     return 0;
   }
 
+  void Newton::broyden(NewtonMemory* m) const {
+    const casadi_int* colind = sp_jac_.colind();
+    const casadi_int* row = sp_jac_.row();
+
+    // Squared norm of the step, restricted to the sparsity pattern of each row
+    casadi_fill(m->v, n_, 0.);
+    for (casadi_int c=0; c<n_; ++c) {
+      for (casadi_int k=colind[c]; k<colind[c+1]; ++k) {
+        m->v[row[k]] += m->dx[c]*m->dx[c];
+      }
+    }
+
+    // Error in the secant condition f - f_prev - J*dx, scaled row by row
+    double* r = m->f_prev;
+    casadi_mv(m->jac, sp_jac_, m->dx, r, false);
+    for (casadi_int i=0; i<n_; ++i) r[i] = m->v[i]==0 ? 0 : (m->f[i] - r[i])/m->v[i];
+
+    // Schubert's sparse Broyden update
+    casadi_rank1(m->jac, sp_jac_, 1., r, m->dx);
+  }
+
   void Newton::printIteration(std::ostream &stream) const {
     stream << setw(5) << "iter";
     stream << setw(10) << "res";
@@ -223,6 +318,7 @@ namespace casadi {
     auto m = static_cast<NewtonMemory*>(mem);
     m->return_status = nullptr;
     m->iter = 0;
+    m->jac_count = m->fact_count = m->res_count = 0;
     return 0;
   }
 
@@ -231,6 +327,9 @@ namespace casadi {
     auto m = static_cast<NewtonMemory*>(mem);
     stats["return_status"] = m->return_status;
     stats["iter_count"] = m->iter;
+    stats["jac_count"] = m->jac_count;
+    stats["fact_count"] = m->fact_count;
+    stats["res_count"] = m->res_count;
     return stats;
   }
 
@@ -31,6 +31,12 @@
 
 /** \defgroup plugin_Rootfinder_newton
      Implements simple newton iterations to solve an implicit function.
+
+     With the option jacobian_update, the Jacobian and its factorization can
+     be kept over several iterations (modified Newton), or be corrected by
+     sparse rank-1 (Schubert-Broyden) updates instead of being reevaluated.
+     A new Jacobian is evaluated when it reaches max_jacobian_age iterations
+     or when the contraction rate of the steps exceeds max_contraction_rate.
 */
 
 /** \pluginsection{Rootfinder,newton} */
@@ -47,10 +53,14 @@ namespace casadi {
     double* f;
     // Current Jacobian
     double* jac;
+    // Last step, residual before the last step and work vector for Broyden updates
+    double *dx, *f_prev, *v;
     // Return status
     const char* return_status;
     // Number of iterations
     casadi_int iter;
+    // Number of Jacobian evaluations, factorizations and residual-only evaluations
+    casadi_int jac_count, fact_count, res_count;
   };
 
   /** \brief \pluginbrief{Rootfinder,newton}
@@ -105,6 +115,9 @@ namespace casadi {
     /// Solve the system of equations and calculate derivatives
     int solve(void* mem) const override;
 
+    /// Correct the Jacobian with a sparse Broyden update after the last step
+    void broyden(NewtonMemory* m) const;
+
     /// A documentation string
     static const std::string meta_doc;
 
@@ -124,6 +137,16 @@ namespace casadi {
     /// If true, each iteration will be printed
     bool print_iteration_;
 
+    /// How the Jacobian is updated between iterations
+    enum JacobianUpdate {JAC_EXACT, JAC_MODIFIED, JAC_BROYDEN};
+    JacobianUpdate jacobian_update_;
+
+    /// Maximum number of iterations with the same Jacobian evaluation
+    casadi_int max_jacobian_age_;
+
+    /// Contraction rate of the steps above which the Jacobian is reevaluated
+    double max_contraction_rate_;
+
     bool error_on_;
 
     /// Print iteration header
@@ -0,0 +1,579 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#include "newton_krylov.hpp"
+#include <iomanip>
+
+using namespace std;
+namespace casadi {
+
+  extern "C"
+  int CASADI_ROOTFINDER_NEWTON_KRYLOV_EXPORT
+  casadi_register_rootfinder_newton_krylov(Rootfinder::Plugin* plugin) {
+    plugin->creator = NewtonKrylov::creator;
+    plugin->name = "newton_krylov";
+    plugin->doc = NewtonKrylov::meta_doc.c_str();
+    plugin->version = CASADI_VERSION;
+    plugin->options = &NewtonKrylov::options_;
+    return 0;
+  }
+
+  extern "C"
+  void CASADI_ROOTFINDER_NEWTON_KRYLOV_EXPORT casadi_load_rootfinder_newton_krylov() {
+    Rootfinder::registerPlugin(casadi_register_rootfinder_newton_krylov);
+  }
+
+  NewtonKrylov::NewtonKrylov(const std::string& name, const Function& f)
+    : Rootfinder(name, f) {
+    // Matrix-free, the Jacobian is only formed for ILU or sensitivities
+    lazy_jacobian_ = true;
+  }
+
+  NewtonKrylov::~NewtonKrylov() {
+    clear_mem();
+  }
+
+  Options NewtonKrylov::options_
+  = {{&Rootfinder::options_},
+     {{"abstol",
+       {OT_DOUBLE,
+        "Stopping criterion tolerance on max(|F|) [1e-12]"}},
+      {"abstolStep",
+       {OT_DOUBLE,
+        "Stopping criterion tolerance on step size [1e-12]"}},
+      {"max_iter",
+       {OT_INT,
+        "Maximum number of Newton iterations to perform before returning [1000]"}},
+      {"print_iteration",
+       {OT_BOOL,
+        "Print information about each iteration"}},
+      {"krylov_method",
+       {OT_STRING,
+        "Iterative linear solver for the Newton steps: gmres|bicgstab [gmres]"}},
+      {"max_krylov_iter",
+       {OT_INT,
+        "Maximum number of Krylov iterations per Newton iteration [100]"}},
+      {"gmres_restart",
+       {OT_INT,
+        "Number of GMRES iterations before a restart [30]"}},
+      {"eta_max",
+       {OT_DOUBLE,
+        "Upper bound on the relative tolerance of the linear solves [0.1]"}},
+      {"preconditioner",
+       {OT_STRING,
+        "Right preconditioner of the Krylov solver: none|ilu [none]"}},
+      {"preconditioner_function",
+       {OT_FUNCTION,
+        "Function approximating the inverse of the Jacobian. It is called with the "
+        "inputs of the residual function, where the unknown is replaced by the current "
+        "guess, followed by the vector to be preconditioned, and returns the "
+        "preconditioned vector."}}
+     }
+  };
+
+  void NewtonKrylov::init(const Dict& opts) {
+
+    // Call the base class initializer
+    Rootfinder::init(opts);
+
+    // Default options
+    max_iter_ = 1000;
+    abstol_ = 1e-12;
+    abstolStep_ = 1e-12;
+    print_iteration_ = false;
+    string krylov_method = "gmres";
+    max_krylov_iter_ = 100;
+    restart_ = 30;
+    eta_max_ = 0.1;
+    string preconditioner = "none";
+    Function preconditioner_function;
+
+    // Read options
+    for (auto&& op : opts) {
+      if (op.first=="max_iter") {
+        max_iter_ = op.second;
+      } else if (op.first=="abstol") {
+        abstol_ = op.second;
+      } else if (op.first=="abstolStep") {
+        abstolStep_ = op.second;
+      } else if (op.first=="print_iteration") {
+        print_iteration_ = op.second;
+      } else if (op.first=="krylov_method") {
+        krylov_method = op.second.to_string();
+      } else if (op.first=="max_krylov_iter") {
+        max_krylov_iter_ = op.second;
+      } else if (op.first=="gmres_restart") {
+        restart_ = op.second;
+      } else if (op.first=="eta_max") {
+        eta_max_ = op.second;
+      } else if (op.first=="preconditioner") {
+        preconditioner = op.second.to_string();
+      } else if (op.first=="preconditioner_function") {
+        preconditioner_function = op.second;
+      }
+    }
+
+    // Krylov method
+    if (krylov_method=="gmres") {
+      krylov_method_ = KRYLOV_GMRES;
+    } else if (krylov_method=="bicgstab") {
+      krylov_method_ = KRYLOV_BICGSTAB;
+    } else {
+      casadi_error("Unknown Krylov method: " + krylov_method);
+    }
+    casadi_assert(max_krylov_iter_>=1, "Option 'max_krylov_iter' must be positive");
+    casadi_assert(restart_>=1, "Option 'gmres_restart' must be positive");
+    casadi_assert(eta_max_>0 && eta_max_<1, "Option 'eta_max' must be in (0, 1)");
+    restart_ = min(restart_, max_krylov_iter_);
+
+    // Preconditioner
+    if (!preconditioner_function.is_null()) {
+      casadi_assert(preconditioner=="none",
+        "Options 'preconditioner' and 'preconditioner_function' are mutually exclusive");
+      casadi_assert(preconditioner_function.n_in()==n_in_+1
+                    && preconditioner_function.n_out()>=1,
+                    "Preconditioner function must have " + str(n_in_+1) + " inputs "
+                    "and at least one output");
+      casadi_assert(preconditioner_function.nnz_in(n_in_)==n_
+                    && preconditioner_function.nnz_out(0)==n_,
+                    "Preconditioner function must map vectors of length " + str(n_));
+      set_function(preconditioner_function, "prec");
+      preconditioner_ = PREC_FUNCTION;
+    } else if (preconditioner=="none") {
+      preconditioner_ = PREC_NONE;
+    } else if (preconditioner=="ilu") {
+      preconditioner_ = PREC_ILU;
+    } else {
+      casadi_error("Unknown preconditioner: " + preconditioner);
+    }
+
+    // Jacobian-times-vector products
+    set_function(oracle_.forward(1), "jtimes");
+
+    if (preconditioner_==PREC_ILU) {
+      set_function(get_jac(), "jac_f_z");
+
+      // The incomplete factorization is stored row by row, with all diagonal entries
+      sp_P_ = sp_jac_ + Sparsity::diag(n_);
+      sp_Pt_ = sp_P_.transpose(map_Pt_);
+      const casadi_int *colind = sp_Pt_.colind(), *row = sp_Pt_.row();
+      diag_.resize(n_);
+      for (casadi_int c=0; c<n_; ++c) {
+        for (casadi_int k=colind[c]; k<colind[c+1]; ++k) {
+          if (row[k]==c) diag_[c] = k;
+        }
+      }
+      alloc_w(sp_jac_.nnz(), true); // jac
+      alloc_w(sp_P_.nnz(), true); // P
+      alloc_w(sp_Pt_.nnz(), true); // LU
+      alloc_iw(n_, true); // marker
+    } else {
+      // Only the residual is needed during the iterations
+      set_function(oracle_, "f_z");
+    }
+
+    // Allocate memory
+    alloc_w(n_, true); // x
+    alloc_w(n_, true); // f
+    alloc_w(n_, true); // dx
+    if (krylov_method_==KRYLOV_GMRES) {
+      alloc_w((restart_+3)*n_ + (restart_+1)*restart_ + 3*restart_ + 1, true); // wk
+    } else {
+      alloc_w(8*n_, true); // wk
+    }
+  }
+
+  void NewtonKrylov::set_work(void* mem, const double**& arg, double**& res,
+                              casadi_int*& iw, double*& w) const {
+    Rootfinder::set_work(mem, arg, res, iw, w);
+    auto m = static_cast<NewtonKrylovMemory*>(mem);
+    if (preconditioner_==PREC_ILU) {
+      m->jac = w; w += sp_jac_.nnz();
+      m->P = w; w += sp_P_.nnz();
+      m->LU = w; w += sp_Pt_.nnz();
+      m->marker = iw; iw += n_;
+    }
+    m->x = w; w += n_;
+    m->f = w; w += n_;
+    m->dx = w; w += n_;
+    m->wk = w;
+    if (krylov_method_==KRYLOV_GMRES) {
+      w += (restart_+3)*n_ + (restart_+1)*restart_ + 3*restart_ + 1;
+    } else {
+      w += 8*n_;
+    }
+  }
+
+  int NewtonKrylov::solve(void* mem) const {
+    auto m = static_cast<NewtonKrylovMemory*>(mem);
+
+    // Get the initial guess
+    casadi_copy(m->iarg[iin_], n_, m->x);
+
+    // Perform the Newton iterations
+    m->iter = 0;
+    m->krylov_iter = 0;
+    bool success = true;
+    double eta = eta_max_, norm_f_prev = 0;
+    while (true) {
+      // Break if maximum number of iterations already reached
+      if (m->iter >= max_iter_) {
+        if (verbose_) casadi_message("Max iterations reached.");
+        m->return_status = "max_iteration_reached";
+        success = false;
+        break;
+      }
+
+      // Start a new iteration
+      m->iter++;
+
+      // Use x to evaluate F
+      eval_f(m);
+
+      // Check convergence
+      double abstol = casadi_norm_inf(n_, m->f);
+      if (abstol <= abstol_) {
+        if (verbose_) casadi_message("Converged to acceptable tolerance: " + str(abstol_));
+        break;
+      }
+
+      // Relative tolerance of the linear solve, choice 2 of Eisenstat and Walker
+      double norm_f = casadi_norm_2(n_, m->f);
+      if (m->iter>1) {
+        double eta_new = 0.9*(norm_f/norm_f_prev)*(norm_f/norm_f_prev);
+        if (0.9*eta*eta>0.1) eta_new = max(eta_new, 0.9*eta*eta);
+        eta = min(eta_new, eta_max_);
+      }
+      norm_f_prev = norm_f;
+
+      // Avoid solving more accurately than needed for the termination
+      double eta_k = max(eta, 0.5*abstol_/norm_f);
+
+      // Preconditioner
+      if (preconditioner_==PREC_ILU && !ilu(m)) {
+        if (verbose_) casadi_message("Incomplete factorization failed.");
+        m->return_status = "preconditioner_failed";
+        success = false;
+        break;
+      }
+
+      // Newton step, accepted even if the Krylov solver did not reach the tolerance
+      bool converged;
+      if (krylov_method_==KRYLOV_GMRES) {
+        converged = gmres(m, m->f, m->dx, eta_k);
+      } else {
+        converged = bicgstab(m, m->f, m->dx, eta_k);
+      }
+      if (!converged && verbose_) casadi_message("Krylov solver did not converge.");
+
+      // Check convergence again
+      double abstolStep = casadi_norm_inf(n_, m->dx);
+      if (abstolStep <= abstolStep_) {
+        if (verbose_) casadi_message("Converged to acceptable tolerance: " + str(abstolStep_));
+        break;
+      }
+
+      if (print_iteration_) {
+        // Only print iteration header once in a while
+        if (m->iter % 10==1) {
+          uout() << setw(5) << "iter" << setw(10) << "res" << setw(10) << "step"
+                 << setw(10) << "eta" << setw(8) << "lin" << endl;
+        }
+
+        // Print iteration information
+        uout() << setw(5) << m->iter << scientific << setprecision(2)
+               << setw(10) << abstol << setw(10) << abstolStep << setw(10) << eta_k
+               << setw(8) << m->krylov_iter << endl;
+        uout().unsetf(std::ios::floatfield);
+      }
+
+      // Update Xk+1 = Xk - J^(-1) F
+      casadi_axpy(n_, -1., m->dx, m->x);
+    }
+
+    // Get the solution
+    casadi_copy(m->x, n_, m->ires[iout_]);
+
+    // Store the iteration count
+    if (success) m->return_status = "success";
+    if (verbose_) casadi_message("Newton-Krylov algorithm took " + str(m->iter) + " steps and "
+                                 + str(m->krylov_iter) + " Krylov iterations");
+
+    m->success = success;
+
+    return 0;
+  }
+
+  void NewtonKrylov::eval_f(NewtonKrylovMemory* m) const {
+    copy_n(m->iarg, n_in_, m->arg);
+    m->arg[iin_] = m->x;
+    if (preconditioner_==PREC_ILU) {
+      // The Jacobian is needed for the incomplete factorization
+      m->res[0] = m->jac;
+      copy_n(m->ires, n_out_, m->res+1);
+      m->res[1+iout_] = m->f;
+      if (calc_function(m, "jac_f_z")) casadi_error("'jac_f_z' calculation failed");
+    } else {
+      copy_n(m->ires, n_out_, m->res);
+      m->res[iout_] = m->f;
+      if (calc_function(m, "f_z")) casadi_error("'f_z' calculation failed");
+    }
+  }
+
+  void NewtonKrylov::jtimes(NewtonKrylovMemory* m, const double* v, double* jv) const {
+    // Nondifferentiated inputs and outputs
+    copy_n(m->iarg, n_in_, m->arg);
+    m->arg[iin_] = m->x;
+    copy_n(m->ires, n_out_, m->arg + n_in_);
+    m->arg[n_in_ + iout_] = m->f;
+
+    // Seed in the direction v
+    fill_n(m->arg + n_in_ + n_out_, n_in_, nullptr);
+    m->arg[n_in_ + n_out_ + iin_] = v;
+
+    // Only the sensitivity of the residual is needed
+    fill_n(m->res, n_out_, nullptr);
+    m->res[iout_] = jv;
+    if (calc_function(m, "jtimes")) casadi_error("'jtimes' calculation failed");
+  }
+
+  void NewtonKrylov::precondition(NewtonKrylovMemory* m, const double* v, double* z) const {
+    if (preconditioner_==PREC_FUNCTION) {
+      copy_n(m->iarg, n_in_, m->arg);
+      m->arg[iin_] = m->x;
+      m->arg[n_in_] = v;
+      m->res[0] = z;
+      fill_n(m->res + 1, get_function("prec").n_out() - 1, nullptr);
+      if (calc_function(m, "prec")) casadi_error("'prec' calculation failed");
+      return;
+    }
+    casadi_copy(v, n_, z);
+    if (preconditioner_==PREC_NONE) return;
+
+    // Forward substitution with the unit lower triangular factor, row by row
+    const casadi_int *rowptr = sp_Pt_.colind(), *col = sp_Pt_.row();
+    for (casadi_int i=0; i<n_; ++i) {
+      for (casadi_int k=rowptr[i]; k<diag_[i]; ++k) z[i] -= m->LU[k]*z[col[k]];
+    }
+
+    // Backward substitution with the upper triangular factor
+    for (casadi_int i=n_-1; i>=0; --i) {
+      for (casadi_int k=diag_[i]+1; k<rowptr[i+1]; ++k) z[i] -= m->LU[k]*z[col[k]];
+      z[i] /= m->LU[diag_[i]];
+    }
+  }
+
+  bool NewtonKrylov::ilu(NewtonKrylovMemory* m) const {
+    // Jacobian with all diagonal entries, stored row by row
+    casadi_project(m->jac, sp_jac_, m->P, sp_P_, m->wk);
+    for (casadi_int k=0; k<sp_Pt_.nnz(); ++k) m->LU[k] = m->P[map_Pt_[k]];
+
+    // Incomplete LU factorization without fill-in, IKJ variant
+    const casadi_int *rowptr = sp_Pt_.colind(), *col = sp_Pt_.row();
+    fill_n(m->marker, n_, -1);
+    for (casadi_int i=0; i<n_; ++i) {
+      for (casadi_int k=rowptr[i]; k<rowptr[i+1]; ++k) m->marker[col[k]] = k;
+      for (casadi_int k=rowptr[i]; k<diag_[i]; ++k) {
+        // Multiplier for row j
+        casadi_int j = col[k];
+        m->LU[k] /= m->LU[diag_[j]];
+
+        // Eliminate, dropping entries outside of the sparsity pattern
+        for (casadi_int kk=diag_[j]+1; kk<rowptr[j+1]; ++kk) {
+          casadi_int e = m->marker[col[kk]];
+          if (e>=0) m->LU[e] -= m->LU[k]*m->LU[kk];
+        }
+      }
+      for (casadi_int k=rowptr[i]; k<rowptr[i+1]; ++k) m->marker[col[k]] = -1;
+      if (m->LU[diag_[i]]==0) return false;
+    }
+    return true;
+  }
+
+  bool NewtonKrylov::gmres(NewtonKrylovMemory* m, const double* b, double* d,
+                           double tol) const {
+    // Work vectors: Krylov basis, two vectors, Hessenberg matrix, Givens rotations, rhs
+    casadi_int n = n_, mr = restart_;
+    double* V = m->wk;
+    double* z = V + (mr+1)*n;
+    double* u = z + n;
+    double* H = u + n;
+    double* cs = H + (mr+1)*mr;
+    double* sn = cs + mr;
+    double* g = sn + mr;
+
+    // Start from zero
+    casadi_fill(d, n, 0.);
+    double norm_b = casadi_norm_2(n, b);
+    if (norm_b==0) return true;
+    casadi_int nit = 0;
+    while (true) {
+      // Residual of the current solution
+      casadi_copy(b, n, V);
+      if (nit>0) {
+        jtimes(m, d, u);
+        casadi_axpy(n, -1., u, V);
+      }
+      double beta = casadi_norm_2(n, V);
+      if (beta <= tol*norm_b) return true;
+      if (nit>=max_krylov_iter_) return false;
+      casadi_scal(n, 1./beta, V);
+      casadi_fill(g, mr+1, 0.);
+      g[0] = beta;
+
+      // Arnoldi process
+      casadi_int k = 0;
+      while (k<mr && nit<max_krylov_iter_) {
+        double* h = H + k*(mr+1);
+        double* w = V + (k+1)*n;
+        precondition(m, V + k*n, z);
+        jtimes(m, z, w);
+        nit++;
+        m->krylov_iter++;
+
+        // Modified Gram-Schmidt
+        for (casadi_int i=0; i<=k; ++i) {
+          h[i] = casadi_dot(n, w, V + i*n);
+          casadi_axpy(n, -h[i], V + i*n, w);
+        }
+        h[k+1] = casadi_norm_2(n, w);
+        if (h[k+1]>0) casadi_scal(n, 1./h[k+1], w);
+
+        // Apply the previous Givens rotations to the new column
+        for (casadi_int i=0; i<k; ++i) {
+          double t = cs[i]*h[i] + sn[i]*h[i+1];
+          h[i+1] = -sn[i]*h[i] + cs[i]*h[i+1];
+          h[i] = t;
+        }
+
+        // New rotation, eliminating the subdiagonal
+        double r = sqrt(h[k]*h[k] + h[k+1]*h[k+1]);
+        if (r==0) return false;
+        cs[k] = h[k]/r;
+        sn[k] = h[k+1]/r;
+        h[k] = r;
+        h[k+1] = 0;
+        g[k+1] = -sn[k]*g[k];
+        g[k] *= cs[k];
+        k++;
+
+        // Estimated residual
+        if (fabs(g[k]) <= tol*norm_b) break;
+      }
+
+      // Solve the upper triangular system, overwriting g
+      for (casadi_int i=k-1; i>=0; --i) {
+        for (casadi_int j=i+1; j<k; ++j) g[i] -= H[i + j*(mr+1)]*g[j];
+        g[i] /= H[i + i*(mr+1)];
+      }
+
+      // Update the solution
+      casadi_fill(u, n, 0.);
+      for (casadi_int i=0; i<k; ++i) casadi_axpy(n, g[i], V + i*n, u);
+      precondition(m, u, z);
+      casadi_axpy(n, 1., z, d);
+    }
+  }
+
+  bool NewtonKrylov::bicgstab(NewtonKrylovMemory* m, const double* b, double* d,
+                              double tol) const {
+    // Work vectors
+    casadi_int n = n_;
+    double* r = m->wk;
+    double* r0 = r + n;
+    double* p = r0 + n;
+    double* v = p + n;
+    double* s = v + n;
+    double* t = s + n;
+    double* ph = t + n;
+    double* sh = ph + n;
+
+    // Start from zero
+    casadi_fill(d, n, 0.);
+    double norm_b = casadi_norm_2(n, b);
+    if (norm_b==0) return true;
+    casadi_copy(b, n, r);
+    casadi_copy(b, n, r0);
+    casadi_fill(p, n, 0.);
+    casadi_fill(v, n, 0.);
+    double rho = 1, alpha = 1, omega = 1;
+    for (casadi_int nit=0; nit<max_krylov_iter_; ++nit) {
+      m->krylov_iter++;
+
+      // New search direction
+      double rho_new = casadi_dot(n, r0, r);
+      if (rho_new==0) return false;
+      double beta = (rho_new/rho)*(alpha/omega);
+      rho = rho_new;
+      casadi_axpy(n, -omega, v, p);
+      casadi_scal(n, beta, p);
+      casadi_axpy(n, 1., r, p);
+
+      // Half step
+      precondition(m, p, ph);
+      jtimes(m, ph, v);
+      double r0v = casadi_dot(n, r0, v);
+      if (r0v==0) return false;
+      alpha = rho/r0v;
+      casadi_copy(r, n, s);
+      casadi_axpy(n, -alpha, v, s);
+      casadi_axpy(n, alpha, ph, d);
+      if (casadi_norm_2(n, s) <= tol*norm_b) return true;
+
+      // Stabilizing step
+      precondition(m, s, sh);
+      jtimes(m, sh, t);
+      double tt = casadi_dot(n, t, t);
+      if (tt==0) return false;
+      omega = casadi_dot(n, t, s)/tt;
+      casadi_axpy(n, omega, sh, d);
+      casadi_copy(s, n, r);
+      casadi_axpy(n, -omega, t, r);
+      if (casadi_norm_2(n, r) <= tol*norm_b) return true;
+      if (omega==0) return false;
+    }
+    return false;
+  }
+
+  int NewtonKrylov::init_mem(void* mem) const {
+    if (Rootfinder::init_mem(mem)) return 1;
+    auto m = static_cast<NewtonKrylovMemory*>(mem);
+    m->return_status = nullptr;
+    m->iter = 0;
+    m->krylov_iter = 0;
+    return 0;
+  }
+
+  Dict NewtonKrylov::get_stats(void* mem) const {
+    Dict stats = Rootfinder::get_stats(mem);
+    auto m = static_cast<NewtonKrylovMemory*>(mem);
+    stats["return_status"] = m->return_status;
+    stats["iter_count"] = m->iter;
+    stats["krylov_iter_count"] = m->krylov_iter;
+    return stats;
+  }
+
+} // namespace casadi
@@ -0,0 +1,185 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#ifndef CASADI_NEWTON_KRYLOV_HPP
+#define CASADI_NEWTON_KRYLOV_HPP
+
+#include "casadi/core/rootfinder_impl.hpp"
+#include <casadi/solvers/casadi_rootfinder_newton_krylov_export.h>
+
+/** \defgroup plugin_Rootfinder_newton_krylov
+     Inexact Newton method with a matrix-free Krylov solver for the Newton steps.
+
+     The linear systems are solved with restarted GMRES or with BiCGStab, using
+     Jacobian-times-vector products from forward mode algorithmic differentiation
+     of the residual, so that the Jacobian is never formed during the iterations.
+     The relative tolerance of the linear solves is chosen by the second rule of
+     Eisenstat and Walker, bounded by eta_max.
+
+     The Krylov solver can be preconditioned from the right, either by an
+     incomplete LU factorization without fill-in of the Jacobian, which then needs
+     to be evaluated in each iteration, or by a user supplied Function.
+     The Jacobian is still needed for calculating sensitivities.
+*/
+
+/** \pluginsection{Rootfinder,newton_krylov} */
+
+/// \cond INTERNAL
+namespace casadi {
+
+  // Memory
+  struct CASADI_ROOTFINDER_NEWTON_KRYLOV_EXPORT NewtonKrylovMemory
+    : public RootfinderMemory {
+    // Current guess, residual and Newton step
+    double *x, *f, *dx;
+    // Jacobian, projected Jacobian and incomplete LU factors (preconditioner ilu only)
+    double *jac, *P, *LU;
+    // Work vectors of the Krylov solver
+    double *wk;
+    // Marker for the incomplete factorization
+    casadi_int* marker;
+    // Return status
+    const char* return_status;
+    // Number of Newton and Krylov iterations
+    casadi_int iter, krylov_iter;
+  };
+
+  /** \brief \pluginbrief{Rootfinder,newton_krylov}
+
+      @copydoc Rootfinder_doc
+      @copydoc plugin_Rootfinder_newton_krylov
+  */
+  class CASADI_ROOTFINDER_NEWTON_KRYLOV_EXPORT NewtonKrylov : public Rootfinder {
+  public:
+    /** \brief  Constructor */
+    explicit NewtonKrylov(const std::string& name, const Function& f);
+
+    /** \brief  Destructor */
+    ~NewtonKrylov() override;
+
+    // Get name of the plugin
+    const char* plugin_name() const override { return "newton_krylov";}
+
+    // Name of the class
+    std::string class_name() const override { return "NewtonKrylov";}
+
+    /** \brief  Create a new Rootfinder */
+    static Rootfinder* creator(const std::string& name, const Function& f) {
+      return new NewtonKrylov(name, f);
+    }
+
+    ///@{
+    /** \brief Options */
+    static Options options_;
+    const Options& get_options() const override { return options_;}
+    ///@}
+
+    /** \brief  Initialize */
+    void init(const Dict& opts) override;
+
+    /** \brief Create memory block */
+    void* alloc_mem() const override { return new NewtonKrylovMemory();}
+
+    /** \brief Initalize memory block */
+    int init_mem(void* mem) const override;
+
+    /** \brief Free memory block */
+    void free_mem(void *mem) const override { delete static_cast<NewtonKrylovMemory*>(mem);}
+
+    /** \brief Set the (persistent) work vectors */
+    void set_work(void* mem, const double**& arg, double**& res,
+                          casadi_int*& iw, double*& w) const override;
+
+    /// Solve the system of equations
+    int solve(void* mem) const override;
+
+    /// Evaluate the residual at the current guess, and the preconditioner if needed
+    void eval_f(NewtonKrylovMemory* m) const;
+
+    /// Jacobian-times-vector product at the current guess
+    void jtimes(NewtonKrylovMemory* m, const double* v, double* jv) const;
+
+    /// Apply the preconditioner to v, z must not overlap with v
+    void precondition(NewtonKrylovMemory* m, const double* v, double* z) const;
+
+    /// Incomplete LU factorization of the Jacobian, returns false if a pivot is zero
+    bool ilu(NewtonKrylovMemory* m) const;
+
+    /// Solve J*d = b with restarted GMRES, returns false if not converged
+    bool gmres(NewtonKrylovMemory* m, const double* b, double* d, double tol) const;
+
+    /// Solve J*d = b with BiCGStab, returns false if not converged
+    bool bicgstab(NewtonKrylovMemory* m, const double* b, double* d, double tol) const;
+
+    /// A documentation string
+    static const std::string meta_doc;
+
+    /// Get all statistics
+    Dict get_stats(void* mem) const override;
+
+  protected:
+    /// Maximum number of Newton iterations
+    casadi_int max_iter_;
+
+    /// Absolute tolerance that should be met on residual
+    double abstol_;
+
+    /// Absolute tolerance that should be met on step
+    double abstolStep_;
+
+    /// If true, each iteration will be printed
+    bool print_iteration_;
+
+    /// Krylov method
+    enum KrylovMethod {KRYLOV_GMRES, KRYLOV_BICGSTAB};
+    KrylovMethod krylov_method_;
+
+    /// Maximum number of Krylov iterations per Newton iteration
+    casadi_int max_krylov_iter_;
+
+    /// Number of GMRES iterations before a restart
+    casadi_int restart_;
+
+    /// Largest relative tolerance of the linear solves
+    double eta_max_;
+
+    /// Preconditioner
+    enum Preconditioner {PREC_NONE, PREC_ILU, PREC_FUNCTION};
+    Preconditioner preconditioner_;
+
+    /// Sparsity of the Jacobian with the diagonal added, and of its transpose
+    Sparsity sp_P_, sp_Pt_;
+
+    /// Nonzeros of the Jacobian for the nonzeros of the transpose
+    std::vector<casadi_int> map_Pt_;
+
+    /// Nonzero index of the diagonal in each column of the transpose
+    std::vector<casadi_int> diag_;
+  };
+
+} // namespace casadi
+/// \endcond
+#endif // CASADI_NEWTON_KRYLOV_HPP
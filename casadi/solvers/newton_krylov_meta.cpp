@@ -0,0 +1,112 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+
+      #include "newton_krylov.hpp"
+      #include <string>
+
+      const std::string casadi::NewtonKrylov::meta_doc=
+      "\n"
+"Inexact Newton method with a matrix-free Krylov solver for the Newton\n"
+"steps.\n"
+"\n"
+"The linear systems are solved with restarted GMRES or with BiCGStab,\n"
+"using Jacobian-times-vector products from forward mode algorithmic\n"
+"differentiation of the residual, so that the Jacobian is never formed\n"
+"during the iterations. The relative tolerance of the linear solves is\n"
+"chosen by the second rule of Eisenstat and Walker, bounded by eta_max.\n"
+"\n"
+"The Krylov solver can be preconditioned from the right, either by an\n"
+"incomplete LU factorization without fill-in of the Jacobian, which then\n"
+"needs to be evaluated in each iteration, or by a user supplied\n"
+"Function. The Jacobian is still needed for calculating sensitivities.\n"
+"\n"
+"\n"
+">List of available options\n"
+"\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"|       Id        |      Type       |     Default     |   Description   |\n"
+"+=================+=================+=================+=================+\n"
+"| abstol          | OT_DOUBLE       | 1e-12           | Stopping        |\n"
+"|                 |                 |                 | criterion       |\n"
+"|                 |                 |                 | tolerance on    |\n"
+"|                 |                 |                 | max(|F|)        |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| abstolStep      | OT_DOUBLE       | 1e-12           | Stopping        |\n"
+"|                 |                 |                 | criterion       |\n"
+"|                 |                 |                 | tolerance on    |\n"
+"|                 |                 |                 | step size       |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| eta_max         | OT_DOUBLE       | 0.1             | Upper bound on  |\n"
+"|                 |                 |                 | the relative    |\n"
+"|                 |                 |                 | tolerance of    |\n"
+"|                 |                 |                 | the linear      |\n"
+"|                 |                 |                 | solves          |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| gmres_restart   | OT_INT          | 30              | Number of GMRES |\n"
+"|                 |                 |                 | iterations      |\n"
+"|                 |                 |                 | before a        |\n"
+"|                 |                 |                 | restart         |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| krylov_method   | OT_STRING       | gmres           | Iterative       |\n"
+"|                 |                 |                 | linear solver   |\n"
+"|                 |                 |                 | for the Newton  |\n"
+"|                 |                 |                 | steps: gmres|bi |\n"
+"|                 |                 |                 | cgstab          |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| max_iter        | OT_INT          | 1000            | Maximum number  |\n"
+"|                 |                 |                 | of Newton       |\n"
+"|                 |                 |                 | iterations to   |\n"
+"|                 |                 |                 | perform before  |\n"
+"|                 |                 |                 | returning       |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| max_krylov_iter | OT_INT          | 100             | Maximum number  |\n"
+"|                 |                 |                 | of Krylov       |\n"
+"|                 |                 |                 | iterations per  |\n"
+"|                 |                 |                 | Newton          |\n"
+"|                 |                 |                 | iteration       |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| preconditioner  | OT_STRING       | none            | Right           |\n"
+"|                 |                 |                 | preconditioner  |\n"
+"|                 |                 |                 | of the Krylov   |\n"
+"|                 |                 |                 | solver:         |\n"
+"|                 |                 |                 | none|ilu        |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| preconditioner_ | OT_FUNCTION     |                 | Function        |\n"
+"| function        |                 |                 | approximating   |\n"
+"|                 |                 |                 | the inverse of  |\n"
+"|                 |                 |                 | the Jacobian    |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| print_iteration | OT_BOOL         | false           | Print           |\n"
+"|                 |                 |                 | information     |\n"
+"|                 |                 |                 | about each      |\n"
+"|                 |                 |                 | iteration       |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"\n"
+"\n"
+"\n"
+"\n"
+;
@@ -0,0 +1,437 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "parareal.hpp"
+
+using namespace std;
+namespace casadi {
+
+  extern "C"
+  int CASADI_INTEGRATOR_PARAREAL_EXPORT
+      casadi_register_integrator_parareal(Integrator::Plugin* plugin) {
+    plugin->creator = Parareal::creator;
+    plugin->name = "parareal";
+    plugin->doc = Parareal::meta_doc.c_str();
+    plugin->version = CASADI_VERSION;
+    plugin->options = &Parareal::options_;
+    return 0;
+  }
+
+  extern "C"
+  void CASADI_INTEGRATOR_PARAREAL_EXPORT casadi_load_integrator_parareal() {
+    Integrator::registerPlugin(casadi_register_integrator_parareal);
+  }
+
+  Parareal::Parareal(const std::string& name, const Function& dae)
+    : Integrator(name, dae) {
+  }
+
+  Parareal::~Parareal() {
+    clear_mem();
+  }
+
+  Options Parareal::options_
+  = {{&Integrator::options_},
+     {{"coarse",
+       {OT_STRING,
+        "Integrator plugin for the sequential coarse propagation "
+        "[rk, or collocation for DAEs]"}},
+      {"coarse_options",
+       {OT_DICT,
+        "Options to be passed to the coarse integrator"}},
+      {"fine",
+       {OT_STRING,
+        "Integrator plugin for the parallel fine propagation [cvodes]"}},
+      {"fine_options",
+       {OT_DICT,
+        "Options to be passed to the fine integrator"}},
+      {"number_of_slices",
+       {OT_INT,
+        "Number of time slices, before splitting at the time grid [8]"}},
+      {"parallelization",
+       {OT_STRING,
+        "Parallelization of the fine integrations: serial|openmp|thread [thread]"}},
+      {"tol",
+       {OT_DOUBLE,
+        "Tolerance for the change of the states at the slice boundaries, "
+        "scaled by 1 + |x| [1e-8]"}},
+      {"max_iter",
+       {OT_INT,
+        "Maximum number of Parareal iterations [number of slices]"}}
+     }
+  };
+
+  void Parareal::init(const Dict& opts) {
+    // Call the base class init
+    Integrator::init(opts);
+
+    // Default options
+    coarse_ = nz_>0 ? "collocation" : "rk";
+    fine_ = "cvodes";
+    number_of_slices_ = 8;
+    parallelization_ = "thread";
+    tol_ = 1e-8;
+    max_iter_ = -1;
+
+    // Read options
+    for (auto&& op : opts) {
+      if (op.first=="coarse") {
+        coarse_ = op.second.to_string();
+      } else if (op.first=="coarse_options") {
+        coarse_options_ = op.second;
+      } else if (op.first=="fine") {
+        fine_ = op.second.to_string();
+      } else if (op.first=="fine_options") {
+        fine_options_ = op.second;
+      } else if (op.first=="number_of_slices") {
+        number_of_slices_ = op.second;
+      } else if (op.first=="parallelization") {
+        parallelization_ = op.second.to_string();
+      } else if (op.first=="tol") {
+        tol_ = op.second;
+      } else if (op.first=="max_iter") {
+        max_iter_ = op.second;
+      }
+    }
+
+    casadi_assert(number_of_slices_>=1, "Number of slices must be positive");
+    casadi_assert(tol_>0, "Tolerance must be positive");
+    for (casadi_int k=1; k<grid_.size(); ++k) {
+      casadi_assert(grid_[k]>grid_[k-1], "Parareal requires a strictly increasing time grid");
+    }
+
+    // Divide the time horizon uniformly, then split the slices at the time grid
+    double t0 = grid_.front(), tf = grid_.back(), eps = 1e-10*(tf-t0);
+    tslice_ = grid_;
+    for (casadi_int j=1; j<number_of_slices_; ++j) {
+      double t = t0 + static_cast<double>(j)*(tf-t0)/static_cast<double>(number_of_slices_);
+      auto it = lower_bound(grid_.begin(), grid_.end(), t);
+      if (*it-t < eps || t-*(it-1) < eps) continue;
+      tslice_.push_back(t);
+    }
+    sort(tslice_.begin(), tslice_.end());
+    nslice_ = tslice_.size()-1;
+
+    // The solution is exact after as many iterations as there are slices
+    if (max_iter_<0) max_iter_ = nslice_;
+    casadi_assert(max_iter_>=1, "Maximum number of iterations must be positive");
+
+    // Integrators for the slices, the backward problem is only included if needed
+    set_function(slice_integrator(name_ + "_coarse", coarse_, coarse_options_, false),
+                 "coarse");
+    set_function(slice_integrator(name_ + "_fine", fine_, fine_options_, false)
+                 .map(nslice_, parallelization_), "fine");
+    if (nrx_>0) {
+      set_function(slice_integrator(name_ + "_coarseB", coarse_, coarse_options_, true),
+                   "coarseB");
+      set_function(slice_integrator(name_ + "_fineB", fine_, fine_options_, true)
+                   .map(nslice_, parallelization_), "fineB");
+    }
+  }
+
+  int Parareal::init_mem(void* mem) const {
+    if (Integrator::init_mem(mem)) return 1;
+    auto m = static_cast<PararealMemory*>(mem);
+
+    // Allocate vectors
+    m->P.resize((np_+2)*nslice_);
+    m->RP.resize(nrp_*nslice_);
+    m->U.resize(nx_*(nslice_+1));
+    m->RU.resize(nrx_*(nslice_+1));
+    m->Z.resize(nz_*(nslice_+1));
+    m->RZ.resize(nrz_*(nslice_+1));
+    m->G.resize(nx_*nslice_);
+    m->RG.resize(nrx_*nslice_);
+    m->F.resize(nx_*nslice_);
+    m->RF.resize(nrx_*nslice_);
+    m->Fz.resize(nz_*nslice_);
+    m->RFz.resize(nrz_*nslice_);
+    m->Q.resize(nq_*(nslice_+1));
+    m->RQ.resize(nrq_*nslice_);
+    m->g.resize(max(nx_, nrx_));
+
+    // Statistics
+    m->niter = m->niterB = 0;
+    return 0;
+  }
+
+  template<typename MatType>
+  std::map<std::string, MatType> Parareal::slice_dae(bool backward) const {
+    // Symbolic inputs, the start time and length of the slice are appended to p
+    std::map<std::string, MatType> ret;
+    ret["t"] = MatType::sym("t", t());
+    ret["x"] = MatType::sym("x", nx_);
+    ret["z"] = MatType::sym("z", nz_);
+    ret["p"] = MatType::sym("p", np_ + 2);
+    MatType t0 = ret["p"](np_), h = ret["p"](np_+1);
+
+    // Arguments to the DAE, with time in the slice
+    vector<MatType> arg(DE_NUM_IN);
+    arg[DE_T] = t().nnz()==0 ? ret["t"] : t0 + h*ret["t"];
+    arg[DE_X] = reshape(ret["x"], x().size());
+    arg[DE_Z] = reshape(ret["z"], z().size());
+    arg[DE_P] = reshape(ret["p"](Slice(0, np_)), p().size());
+    if (backward) {
+      ret["rx"] = MatType::sym("rx", nrx_);
+      ret["rz"] = MatType::sym("rz", nrz_);
+      ret["rp"] = MatType::sym("rp", nrp_);
+      arg[DE_RX] = reshape(ret["rx"], rx().size());
+      arg[DE_RZ] = reshape(ret["rz"], rz().size());
+      arg[DE_RP] = reshape(ret["rp"], rp().size());
+    } else {
+      arg[DE_RX] = MatType::zeros(rx());
+      arg[DE_RZ] = MatType::zeros(rz());
+      arg[DE_RP] = MatType::zeros(rp());
+    }
+
+    // Scale the time derivatives with the length of the slice
+    vector<MatType> res = oracle_(arg);
+    ret["ode"] = h*vec(res[DE_ODE]);
+    ret["alg"] = vec(res[DE_ALG]);
+    ret["quad"] = h*vec(res[DE_QUAD]);
+    if (backward) {
+      ret["rode"] = h*vec(res[DE_RODE]);
+      ret["ralg"] = vec(res[DE_RALG]);
+      ret["rquad"] = h*vec(res[DE_RQUAD]);
+    }
+    return ret;
+  }
+
+  Function Parareal::slice_integrator(const std::string& name, const std::string& solver,
+                                      const Dict& opts, bool backward) const {
+    // DAE with the time scaled to [0, 1]
+    Function dae;
+    if (oracle_.is_a("SXFunction")) {
+      dae = map2oracle(name + "_dae", slice_dae<SX>(backward));
+    } else {
+      dae = map2oracle(name + "_dae", slice_dae<MX>(backward));
+    }
+
+    // Integrate over one slice
+    Dict slice_opts = opts;
+    slice_opts["grid"] = vector<double>{0, 1};
+    slice_opts["output_t0"] = false;
+    return integrator(name, solver, dae, slice_opts);
+  }
+
+  void Parareal::integrate(PararealMemory* m, const std::string& fcn,
+                           const double* x0, const double* z0, const double* p,
+                           const double* rx0, const double* rz0, const double* rp,
+                           double* xf, double* zf, double* qf,
+                           double* rxf, double* rzf, double* rqf) const {
+    m->arg[INTEGRATOR_X0] = x0;
+    m->arg[INTEGRATOR_Z0] = z0;
+    m->arg[INTEGRATOR_P] = p;
+    m->arg[INTEGRATOR_RX0] = rx0;
+    m->arg[INTEGRATOR_RZ0] = rz0;
+    m->arg[INTEGRATOR_RP] = rp;
+    m->res[INTEGRATOR_XF] = xf;
+    m->res[INTEGRATOR_ZF] = zf;
+    m->res[INTEGRATOR_QF] = qf;
+    m->res[INTEGRATOR_RXF] = rxf;
+    m->res[INTEGRATOR_RZF] = rzf;
+    m->res[INTEGRATOR_RQF] = rqf;
+    if (calc_function(m, fcn)) casadi_error("'" + fcn + "' calculation failed");
+  }
+
+  double Parareal::change(casadi_int n, const double* x_old, const double* x_new) {
+    double r = 0;
+    for (casadi_int i=0; i<n; ++i) {
+      r = max(r, fabs(x_new[i]-x_old[i])/(1+fabs(x_new[i])));
+    }
+    return r;
+  }
+
+  void Parareal::reset(IntegratorMemory* mem, double t,
+                       const double* x, const double* z, const double* p) const {
+    auto m = static_cast<PararealMemory*>(mem);
+    casadi_int np2 = np_+2;
+    double *U = get_ptr(m->U), *Z = get_ptr(m->Z), *P = get_ptr(m->P);
+    double *G = get_ptr(m->G), *F = get_ptr(m->F), *g = get_ptr(m->g);
+
+    // Parameters of each slice
+    for (casadi_int n=0; n<nslice_; ++n) {
+      casadi_copy(p, np_, P + n*np2);
+      P[n*np2 + np_] = tslice_[n];
+      P[n*np2 + np_ + 1] = tslice_[n+1] - tslice_[n];
+    }
+
+    // Initial conditions
+    casadi_copy(x, nx_, U);
+    casadi_copy(z, nz_, Z);
+
+    // Initial guess from a sequential coarse integration
+    for (casadi_int n=0; n<nslice_; ++n) {
+      integrate(m, "coarse", U + n*nx_, Z + n*nz_, P + n*np2, nullptr, nullptr, nullptr,
+                G + n*nx_, Z + (n+1)*nz_, nullptr, nullptr, nullptr, nullptr);
+      casadi_copy(G + n*nx_, nx_, U + (n+1)*nx_);
+    }
+
+    // Predictor-corrector iterations
+    for (m->niter=1; ; ++m->niter) {
+      // Integrate all slices in parallel with the fine integrator
+      integrate(m, "fine", U, Z, P, nullptr, nullptr, nullptr,
+                F, get_ptr(m->Fz), get_ptr(m->Q) + nq_, nullptr, nullptr, nullptr);
+      casadi_copy(get_ptr(m->Fz), nz_*nslice_, Z + nz_);
+
+      // Sequential correction, the first slices are exact
+      double du = 0;
+      for (casadi_int n=0; n<nslice_; ++n) {
+        if (n<m->niter) {
+          casadi_copy(F + n*nx_, nx_, g);
+        } else {
+          integrate(m, "coarse", U + n*nx_, Z + n*nz_, P + n*np2, nullptr, nullptr, nullptr,
+                    g, nullptr, nullptr, nullptr, nullptr, nullptr);
+          for (casadi_int i=0; i<nx_; ++i) {
+            double g_new = g[i];
+            g[i] += F[n*nx_ + i] - G[n*nx_ + i];
+            G[n*nx_ + i] = g_new;
+          }
+        }
+        du = max(du, change(nx_, U + (n+1)*nx_, g));
+        casadi_copy(g, nx_, U + (n+1)*nx_);
+      }
+
+      // Converged?
+      if (du<=tol_ || m->niter>=nslice_) break;
+      if (m->niter>=max_iter_) {
+        casadi_warning("Parareal iterations did not converge, change " + str(du));
+        break;
+      }
+    }
+
+    // Accumulate quadratures
+    double* Q = get_ptr(m->Q);
+    casadi_fill(Q, nq_, 0.);
+    for (casadi_int n=0; n<nslice_; ++n) {
+      casadi_axpy(nq_, 1., Q + n*nq_, Q + (n+1)*nq_);
+    }
+  }
+
+  void Parareal::advance(IntegratorMemory* mem, double t,
+                         double* x, double* z, double* q) const {
+    auto m = static_cast<PararealMemory*>(mem);
+
+    // Slice boundary, the time grid is included exactly
+    casadi_int n = lower_bound(tslice_.begin(), tslice_.end(), t) - tslice_.begin();
+    casadi_assert_dev(n<=nslice_ && tslice_[n]==t);
+
+    // Get the solution
+    casadi_copy(get_ptr(m->U) + n*nx_, nx_, x);
+    casadi_copy(get_ptr(m->Z) + n*nz_, nz_, z);
+    casadi_copy(get_ptr(m->Q) + n*nq_, nq_, q);
+  }
+
+  void Parareal::resetB(IntegratorMemory* mem, double t,
+                        const double* rx, const double* rz, const double* rp) const {
+    auto m = static_cast<PararealMemory*>(mem);
+    casadi_int np2 = np_+2;
+    double *U = get_ptr(m->U), *Z = get_ptr(m->Z), *P = get_ptr(m->P), *RP = get_ptr(m->RP);
+    double *RU = get_ptr(m->RU), *RZ = get_ptr(m->RZ);
+    double *RG = get_ptr(m->RG), *RF = get_ptr(m->RF), *g = get_ptr(m->g);
+
+    // Parameters of each slice
+    for (casadi_int n=0; n<nslice_; ++n) casadi_copy(rp, nrp_, RP + n*nrp_);
+
+    // Terminal conditions
+    casadi_copy(rx, nrx_, RU + nslice_*nrx_);
+    casadi_copy(rz, nrz_, RZ + nslice_*nrz_);
+
+    // Initial guess from a sequential coarse integration
+    for (casadi_int n=nslice_-1; n>=0; --n) {
+      integrate(m, "coarseB", U + n*nx_, Z + n*nz_, P + n*np2,
+                RU + (n+1)*nrx_, RZ + (n+1)*nrz_, RP + n*nrp_,
+                nullptr, nullptr, nullptr, RG + n*nrx_, RZ + n*nrz_, nullptr);
+      casadi_copy(RG + n*nrx_, nrx_, RU + n*nrx_);
+    }
+
+    // Predictor-corrector iterations
+    for (m->niterB=1; ; ++m->niterB) {
+      // Integrate all slices in parallel with the fine integrator
+      integrate(m, "fineB", U, Z, P, RU + nrx_, RZ + nrz_, RP,
+                nullptr, nullptr, nullptr, RF, get_ptr(m->RFz), get_ptr(m->RQ));
+      casadi_copy(get_ptr(m->RFz), nrz_*nslice_, RZ);
+
+      // Sequential correction, the last slices are exact
+      double du = 0;
+      for (casadi_int n=nslice_-1; n>=0; --n) {
+        if (nslice_-1-n<m->niterB) {
+          casadi_copy(RF + n*nrx_, nrx_, g);
+        } else {
+          integrate(m, "coarseB", U + n*nx_, Z + n*nz_, P + n*np2,
+                    RU + (n+1)*nrx_, RZ + (n+1)*nrz_, RP + n*nrp_,
+                    nullptr, nullptr, nullptr, g, nullptr, nullptr);
+          for (casadi_int i=0; i<nrx_; ++i) {
+            double g_new = g[i];
+            g[i] += RF[n*nrx_ + i] - RG[n*nrx_ + i];
+            RG[n*nrx_ + i] = g_new;
+          }
+        }
+        du = max(du, change(nrx_, RU + n*nrx_, g));
+        casadi_copy(g, nrx_, RU + n*nrx_);
+      }
+
+      // Converged?
+      if (du<=tol_ || m->niterB>=nslice_) break;
+      if (m->niterB>=max_iter_) {
+        casadi_warning("Parareal iterations did not converge, change " + str(du));
+        break;
+      }
+    }
+  }
+
+  void Parareal::retreat(IntegratorMemory* mem, double t,
+                         double* rx, double* rz, double* rq) const {
+    auto m = static_cast<PararealMemory*>(mem);
+
+    // Get the solution
+    casadi_copy(get_ptr(m->RU), nrx_, rx);
+    casadi_copy(get_ptr(m->RZ), nrz_, rz);
+    if (rq) {
+      casadi_fill(rq, nrq_, 0.);
+      for (casadi_int n=0; n<nslice_; ++n) casadi_axpy(nrq_, 1., get_ptr(m->RQ) + n*nrq_, rq);
+    }
+  }
+
+  void Parareal::print_stats(IntegratorMemory* mem) const {
+    auto m = static_cast<PararealMemory*>(mem);
+    print("Number of slices: %lld\n", static_cast<long long>(nslice_));
+    print("Number of Parareal iterations, forward problem: %lld\n",
+          static_cast<long long>(m->niter));
+    if (nrx_>0) {
+      print("Number of Parareal iterations, backward problem: %lld\n",
+            static_cast<long long>(m->niterB));
+    }
+  }
+
+  Dict Parareal::get_stats(void* mem) const {
+    Dict stats = Integrator::get_stats(mem);
+    auto m = static_cast<PararealMemory*>(mem);
+    stats["niter"] = m->niter;
+    stats["niterB"] = m->niterB;
+    return stats;
+  }
+
+} // namespace casadi
@@ -0,0 +1,198 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#ifndef CASADI_PARAREAL_HPP
+#define CASADI_PARAREAL_HPP
+
+#include "casadi/core/integrator_impl.hpp"
+#include <casadi/solvers/casadi_integrator_parareal_export.h>
+
+/** \defgroup plugin_Integrator_parareal
+      Parallel-in-time integrator, implementing the Parareal algorithm of
+      Lions, Maday and Turinici. The time horizon is divided into slices, which
+      are integrated with an accurate (fine) integrator in parallel, starting
+      from states that are propagated sequentially with a cheap (coarse)
+      integrator. Predictor-corrector iterations are performed until the
+      states at the slice boundaries converge, which is guaranteed to happen
+      after at most as many iterations as there are slices.
+
+      The slices are obtained by dividing the time horizon uniformly, and
+      additionally splitting the slices at the points of the time grid. The
+      coarse and fine integrators can be any integrator plugins.
+
+      Adjoint sensitivities are calculated with the same algorithm applied to
+      the backward problem, integrating the forward problem of each slice from
+      the converged states at the slice boundaries.
+*/
+/** \pluginsection{Integrator,parareal} */
+
+/// \cond INTERNAL
+namespace casadi {
+
+  struct CASADI_INTEGRATOR_PARAREAL_EXPORT PararealMemory : public IntegratorMemory {
+    // Parameters of each slice, including its start time and length
+    std::vector<double> P;
+
+    // Backward parameters of each slice
+    std::vector<double> RP;
+
+    // States at the slice boundaries, forward and backward problem
+    std::vector<double> U, RU;
+
+    // Algebraic variables at the slice boundaries, forward and backward problem
+    std::vector<double> Z, RZ;
+
+    // Coarse solution of each slice, forward and backward problem
+    std::vector<double> G, RG;
+
+    // Fine solution of each slice, forward and backward problem
+    std::vector<double> F, RF;
+
+    // Algebraic variables at the end of each fine integration, forward and backward problem
+    std::vector<double> Fz, RFz;
+
+    // Quadratures at the slice boundaries (forward) and of each slice (backward)
+    std::vector<double> Q, RQ;
+
+    // Corrected solution of a slice
+    std::vector<double> g;
+
+    // Number of Parareal iterations, forward and backward problem
+    casadi_int niter, niterB;
+  };
+
+  /** \brief \pluginbrief{Integrator,parareal}
+
+      @copydoc DAE_doc
+      @copydoc plugin_Integrator_parareal
+
+  */
+  class CASADI_INTEGRATOR_PARAREAL_EXPORT Parareal : public Integrator {
+  public:
+
+    /// Constructor
+    explicit Parareal(const std::string& name, const Function& dae);
+
+    /** \brief  Create a new integrator */
+    static Integrator* creator(const std::string& name, const Function& dae) {
+      return new Parareal(name, dae);
+    }
+
+    /// Destructor
+    ~Parareal() override;
+
+    // Get name of the plugin
+    const char* plugin_name() const override { return "parareal";}
+
+    // Get name of the class
+    std::string class_name() const override { return "Parareal";}
+
+    ///@{
+    /** \brief Options */
+    static Options options_;
+    const Options& get_options() const override { return options_;}
+    ///@}
+
+    /// Initialize stage
+    void init(const Dict& opts) override;
+
+    /** \brief Create memory block */
+    void* alloc_mem() const override { return new PararealMemory();}
+
+    /** \brief Initalize memory block */
+    int init_mem(void* mem) const override;
+
+    /** \brief Free memory block */
+    void free_mem(void *mem) const override { delete static_cast<PararealMemory*>(mem);}
+
+    /** \brief Reset the forward problem */
+    void reset(IntegratorMemory* mem, double t,
+               const double* x, const double* z, const double* p) const override;
+
+    /** \brief  Advance solution in time */
+    void advance(IntegratorMemory* mem, double t,
+                 double* x, double* z, double* q) const override;
+
+    /** \brief Reset the backward problem */
+    void resetB(IntegratorMemory* mem, double t,
+                const double* rx, const double* rz, const double* rp) const override;
+
+    /** \brief  Retreat solution in time */
+    void retreat(IntegratorMemory* mem, double t,
+                 double* rx, double* rz, double* rq) const override;
+
+    /** \brief  Print solver statistics */
+    void print_stats(IntegratorMemory* mem) const override;
+
+    /// Get all statistics
+    Dict get_stats(void* mem) const override;
+
+    /// DAE of a slice, with time scaled to [0, 1] and the slice start and length as parameters
+    template<typename MatType>
+    std::map<std::string, MatType> slice_dae(bool backward) const;
+
+    /// Integrator for a slice, using the plugin \a solver
+    Function slice_integrator(const std::string& name, const std::string& solver,
+                              const Dict& opts, bool backward) const;
+
+    /// Integrate one or all slices with the function \a fcn
+    void integrate(PararealMemory* m, const std::string& fcn,
+                   const double* x0, const double* z0, const double* p,
+                   const double* rx0, const double* rz0, const double* rp,
+                   double* xf, double* zf, double* qf,
+                   double* rxf, double* rzf, double* rqf) const;
+
+    /// Largest change of a state, relative to its magnitude
+    static double change(casadi_int n, const double* x_old, const double* x_new);
+
+    /// A documentation string
+    static const std::string meta_doc;
+
+    // Coarse and fine integrators
+    std::string coarse_, fine_;
+    Dict coarse_options_, fine_options_;
+
+    // Parallelization of the fine integrations
+    std::string parallelization_;
+
+    // Number of slices, before splitting at the time grid
+    casadi_int number_of_slices_;
+
+    // Convergence tolerance
+    double tol_;
+
+    // Maximum number of iterations
+    casadi_int max_iter_;
+
+    // Slice boundaries, including the points of the time grid
+    std::vector<double> tslice_;
+    casadi_int nslice_;
+  };
+
+} // namespace casadi
+
+/// \endcond
+#endif // CASADI_PARAREAL_HPP
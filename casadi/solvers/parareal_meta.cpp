@@ -0,0 +1,101 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+      #include "parareal.hpp"
+      #include <string>
+
+      const std::string casadi::Parareal::meta_doc=
+      "\n"
+"Parallel-in-time integrator, implementing the Parareal algorithm of\n"
+"Lions, Maday and Turinici. The time horizon is divided into slices,\n"
+"which are integrated with an accurate (fine) integrator in parallel,\n"
+"starting from states that are propagated sequentially with a cheap\n"
+"(coarse) integrator. Predictor-corrector iterations are performed\n"
+"until the states at the slice boundaries converge, which is guaranteed\n"
+"to happen after at most as many iterations as there are slices.\n"
+"\n"
+"The slices are obtained by dividing the time horizon uniformly, and\n"
+"additionally splitting the slices at the points of the time grid. The\n"
+"coarse and fine integrators can be any integrator plugins.\n"
+"\n"
+"Adjoint sensitivities are calculated with the same algorithm applied\n"
+"to the backward problem, integrating the forward problem of each slice\n"
+"from the converged states at the slice boundaries.\n"
+"\n"
+"\n"
+">List of available options\n"
+"\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"|       Id        |      Type       |     Default     |   Description   |\n"
+"+=================+=================+=================+=================+\n"
+"| coarse          | OT_STRING       | rk, or          | Integrator      |\n"
+"|                 |                 | collocation for | plugin for the  |\n"
+"|                 |                 | DAEs            | sequential      |\n"
+"|                 |                 |                 | coarse          |\n"
+"|                 |                 |                 | propagation     |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| coarse_options  | OT_DICT         |                 | Options to be   |\n"
+"|                 |                 |                 | passed to the   |\n"
+"|                 |                 |                 | coarse          |\n"
+"|                 |                 |                 | integrator      |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| fine            | OT_STRING       | cvodes          | Integrator      |\n"
+"|                 |                 |                 | plugin for the  |\n"
+"|                 |                 |                 | parallel fine   |\n"
+"|                 |                 |                 | propagation     |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| fine_options    | OT_DICT         |                 | Options to be   |\n"
+"|                 |                 |                 | passed to the   |\n"
+"|                 |                 |                 | fine integrator |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| max_iter        | OT_INT          | number of       | Maximum number  |\n"
+"|                 |                 | slices          | of Parareal     |\n"
+"|                 |                 |                 | iterations      |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| number_of_slice | OT_INT          | 8               | Number of time  |\n"
+"| s               |                 |                 | slices, before  |\n"
+"|                 |                 |                 | splitting at    |\n"
+"|                 |                 |                 | the time grid   |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| parallelization | OT_STRING       | thread          | Parallelization |\n"
+"|                 |                 |                 | of the fine     |\n"
+"|                 |                 |                 | integrations: s |\n"
+"|                 |                 |                 | erial|openmp|th |\n"
+"|                 |                 |                 | read            |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| tol             | OT_DOUBLE       | 1e-8            | Tolerance for   |\n"
+"|                 |                 |                 | the change of   |\n"
+"|                 |                 |                 | the states at   |\n"
+"|                 |                 |                 | the slice       |\n"
+"|                 |                 |                 | boundaries,     |\n"
+"|                 |                 |                 | scaled by 1 +   |\n"
+"|                 |                 |                 | |x|             |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"\n"
+"\n"
+"\n"
+"\n"
+;
@@ -235,6 +235,120 @@ namespace casadi {
     return 0;
   }
 
+  void Qrqp::codegen_body(CodeGenerator& g) const {
+    g.add_auxiliary(CodeGenerator::AUX_QP);
+    g.local_struct<casadi_qp_prob>("p", "casadi_qp_prob");
+    g.local_struct<casadi_qp_data>("d", "casadi_qp_data");
+    g.local("index", "casadi_int");
+    g.local("sign", "casadi_int");
+    g.local("r_index", "casadi_int");
+    g.local("r_sign", "casadi_int");
+    g.local("iter", "casadi_int");
+    g.local("flag", "int");
+    // Setup memory structure
+    g.comment("Setup memory structure");
+    g << "p.du_to_pr = " << g.constant(du_to_pr_) << ";\n";
+    g << "p.print_iter = " << print_iter_ << ";\n";
+    g << "p.sp_a = " << g.sparsity(A_) << ";\n";
+    g << "p.sp_h = " << g.sparsity(H_) << ";\n";
+    g << "p.sp_at = " << g.sparsity(AT_) << ";\n";
+    g << "p.sp_kkt = " << g.sparsity(kkt_) << ";\n";
+    g << "p.sp_v = " << g.sparsity(sp_v_) << ";\n";
+    g << "p.sp_r = " << g.sparsity(sp_r_) << ";\n";
+    g << "p.prinv = " << g.constant(prinv_) << ";\n";
+    g << "p.pc = " << g.constant(pc_) << ";\n";
+    g << "p.dmin = " << g.constant(std::numeric_limits<double>::min()) << ";\n";
+    // INFINITY requires C99, HUGE_VAL is infinite with IEEE arithmetic
+    g << "p.inf = HUGE_VAL;\n";
+    g << "p.nx = " << nx_ << ";\n";
+    g << "p.na = " << na_ << ";\n";
+    g << "p.nz = " << nx_+na_ << ";\n";
+    // Setup data structure, missing matrices and vectors are zero
+    g.comment("Setup data structure");
+    g << "d.prob = &p;\n";
+    g << "d.nz_h = arg[" << CONIC_H << "];\n";
+    g << "d.g = arg[" << CONIC_G << "];\n";
+    g << "d.nz_a = arg[" << CONIC_A << "];\n";
+    if (H_.nnz()>0) {
+      g << "if (!d.nz_h) d.nz_h = " << g.constant(std::vector<double>(H_.nnz(), 0)) << ";\n";
+    }
+    if (nx_>0) {
+      g << "if (!d.g) d.g = " << g.constant(std::vector<double>(nx_, 0)) << ";\n";
+    }
+    if (A_.nnz()>0) {
+      g << "if (!d.nz_a) d.nz_a = " << g.constant(std::vector<double>(A_.nnz(), 0)) << ";\n";
+    }
+    g << "casadi_qp_init(&d, iw, w);\n";
+    // Pass bounds on z, missing bounds are infinite
+    g.comment("Pass bounds on z");
+    const casadi_int bound_ind[] = {CONIC_LBX, CONIC_LBA, CONIC_UBX, CONIC_UBA};
+    const char* bound_dest[] = {"d.lbz", "d.lbz+", "d.ubz", "d.ubz+"};
+    for (casadi_int i=0; i<4; ++i) {
+      casadi_int n = i % 2 ? na_ : nx_;
+      std::string a = "arg[" + str(bound_ind[i]) + "]";
+      std::string dest = bound_dest[i] + std::string(i % 2 ? str(nx_) : "");
+      g << "if (" << a << ") {\n"
+        << g.copy(a, n, dest) << "\n"
+        << "} else {\n"
+        << g.fill(dest, n, i<2 ? "-p.inf" : "p.inf") << "\n"
+        << "}\n";
+    }
+    // Pass initial guess
+    g.comment("Pass initial guess");
+    g << g.copy("arg[" + str(CONIC_X0) + "]", nx_, "d.z") << "\n";
+    g << g.copy("arg[" + str(CONIC_LAM_X0) + "]", nx_, "d.lam") << "\n";
+    g << g.copy("arg[" + str(CONIC_LAM_A0) + "]", na_, "d.lam+" + str(nx_)) << "\n";
+    // Reset solver
+    g << "if (casadi_qp_reset(&d)) return 1;\n";
+    // Return flag, constraint to be flipped, if any
+    g << "flag = 0;\n";
+    g << "index = -2;\n";
+    g << "sign = 0;\n";
+    g << "r_index = -2;\n";
+    g << "r_sign = 0;\n";
+    // QP iterations
+    g.comment("QP iterations");
+    g << "iter = 0;\n";
+    g << "while (1) {\n";
+    g << "casadi_qp_calc_dependent(&d);\n";
+    g << "casadi_qp_flip(&d, &index, &sign, r_index, r_sign);\n";
+    g << "casadi_qp_factorize(&d);\n";
+    g << "if (index==-1) {\n";
+    g << "casadi_qp_log(&d, \"QP converged\");\n";
+    g << "} else if (iter>=" << max_iter_ << ") {\n";
+    g << "casadi_qp_log(&d, \"QP terminated: max iter\");\n";
+    g << "flag = 1;\n";
+    g << "}\n";
+    if (print_iter_) {
+      g << "if (iter % 10 == 0) {\n";
+      g << g.printf("%5s %5s %9s %9s %5s %9s %5s %9s %5s %9s %40s\\n",
+                    {"\"Iter\"", "\"Sing\"", "\"fk\"", "\"|pr|\"", "\"con\"", "\"|du|\"",
+                     "\"var\"", "\"min_R\"", "\"con\"", "\"last_tau\"", "\"Note\""}) << "\n";
+      g << "}\n";
+      g << g.printf("%5d %5d %9.2g %9.2g %5d %9.2g %5d %9.2g %5d %9.2g %40s\\n",
+                    {"(int)iter", "(int)d.sing", "d.f", "d.pr", "(int)d.ipr", "d.du",
+                     "(int)d.idu", "d.mina", "(int)d.imina", "d.tau", "d.msg"}) << "\n";
+      g << "d.msg[0] = '\\0';\n";
+    }
+    g << "if (index==-1 || flag!=0) break;\n";
+    g << "iter++;\n";
+    // Calculate search direction
+    g << "if (casadi_qp_calc_step(&d, &r_index, &r_sign)) {\n";
+    if (print_iter_) g << g.printf("QP terminated: No search direction\\n") << "\n";
+    g << "flag = 1;\n";
+    g << "break;\n";
+    g << "}\n";
+    // Line search in the calculated direction
+    g << "casadi_qp_linesearch(&d, &index, &sign);\n";
+    g << "}\n";
+    // Get solution
+    g.comment("Get solution");
+    g << g.copy("&d.f", 1, "res[" + str(CONIC_COST) + "]") << "\n";
+    g << g.copy("d.z", nx_, "res[" + str(CONIC_X) + "]") << "\n";
+    g << g.copy("d.lam", nx_, "res[" + str(CONIC_LAM_X) + "]") << "\n";
+    g << g.copy("d.lam+" + str(nx_), na_, "res[" + str(CONIC_LAM_A) + "]") << "\n";
+  }
+
   Dict Qrqp::get_stats(void* mem) const {
     Dict stats = Conic::get_stats(mem);
     auto m = static_cast<QrqpMemory*>(mem);
@@ -0,0 +1,925 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "rosenbrock.hpp"
+#include "casadi/core/linsol_internal.hpp"
+
+using namespace std;
+namespace casadi {
+
+  extern "C"
+  int CASADI_INTEGRATOR_ROSENBROCK_EXPORT
+      casadi_register_integrator_rosenbrock(Integrator::Plugin* plugin) {
+    plugin->creator = Rosenbrock::creator;
+    plugin->name = "rosenbrock";
+    plugin->doc = Rosenbrock::meta_doc.c_str();
+    plugin->version = CASADI_VERSION;
+    plugin->options = &Rosenbrock::options_;
+    return 0;
+  }
+
+  extern "C"
+  void CASADI_INTEGRATOR_ROSENBROCK_EXPORT casadi_load_integrator_rosenbrock() {
+    Integrator::registerPlugin(casadi_register_integrator_rosenbrock);
+  }
+
+  // Coefficients of the method, Shampine & Reichelt, The MATLAB ODE Suite, 1997
+  static const double ros_d = 1./(2. + sqrt(2.));
+  static const double ros_e32 = 6. + sqrt(2.);
+
+  Rosenbrock::Rosenbrock(const std::string& name, const Function& dae)
+    : Integrator(name, dae) {
+  }
+
+  Rosenbrock::~Rosenbrock() {
+    clear_mem();
+  }
+
+  Options Rosenbrock::options_
+  = {{&Integrator::options_},
+     {{"abstol",
+       {OT_DOUBLE,
+        "Absolute tolerence for the IVP solution"}},
+      {"reltol",
+       {OT_DOUBLE,
+        "Relative tolerence for the IVP solution"}},
+      {"max_num_steps",
+       {OT_INT,
+        "Maximum number of integrator steps"}},
+      {"step0",
+       {OT_DOUBLE,
+        "initial step size [default: 0/estimated]"}},
+      {"max_step_size",
+       {OT_DOUBLE,
+        "Largest step size [default: inf]"}},
+      {"max_jacobian_age",
+       {OT_INT,
+        "Maximum number of steps before the Jacobian is reevaluated [10]"}},
+      {"linear_solver",
+       {OT_STRING,
+        "A custom linear solver creator function [default: qr]"}},
+      {"linear_solver_options",
+       {OT_DICT,
+        "Options to be passed to the linear solver"}}
+     }
+  };
+
+  void Rosenbrock::init(const Dict& opts) {
+    // Call the base class init
+    Integrator::init(opts);
+
+    // Default options
+    abstol_ = 1e-8;
+    reltol_ = 1e-6;
+    max_num_steps_ = 10000;
+    step0_ = 0;
+    max_step_size_ = inf;
+    max_jacobian_age_ = 10;
+    linear_solver_ = "qr";
+
+    // Read options
+    for (auto&& op : opts) {
+      if (op.first=="abstol") {
+        abstol_ = op.second;
+      } else if (op.first=="reltol") {
+        reltol_ = op.second;
+      } else if (op.first=="max_num_steps") {
+        max_num_steps_ = op.second;
+      } else if (op.first=="step0") {
+        step0_ = op.second;
+      } else if (op.first=="max_step_size") {
+        max_step_size_ = op.second;
+      } else if (op.first=="max_jacobian_age") {
+        max_jacobian_age_ = op.second;
+      } else if (op.first=="linear_solver") {
+        linear_solver_ = op.second.to_string();
+      } else if (op.first=="linear_solver_options") {
+        linear_solver_options_ = op.second;
+      }
+    }
+
+    // Algebraic variables not supported
+    casadi_assert(nz_==0 && nrz_==0,
+                  "Rosenbrock integrators do not support algebraic variables");
+    casadi_assert(max_step_size_>0, "Maximum step size must be positive");
+    casadi_assert(max_jacobian_age_>=1, "Maximum Jacobian age must be at least 1");
+
+    // Right-hand sides, forward and backward problem, including quadratures
+    create_function("daeF", {"x", "p", "t"}, {"ode", "quad"});
+    if (nrx_>0) create_function("daeB", {"rx", "rp", "x", "p", "t"}, {"rode", "rquad"});
+
+    // Size of the integrated vectors
+    ny_ = nx_ + nq_;
+    nry_ = nrx_ + nrq_;
+
+    // Derivative with respect to time, evaluated every step
+    autonomous_ = oracle_.sparsity_jac(DE_T, DE_ODE).nnz()==0
+      && oracle_.sparsity_jac(DE_T, DE_QUAD).nnz()==0;
+    if (!autonomous_) {
+      create_function("dtF", {"x", "p", "t"}, {"densify:jac:ode:t", "densify:jac:quad:t"});
+    }
+
+    // The backward problem also depends on time through the interpolated forward state
+    autonomousB_ = true;
+    if (nrx_>0) {
+      for (casadi_int i : {DE_X, DE_T}) {
+        for (casadi_int j : {DE_RODE, DE_RQUAD}) {
+          if (oracle_.sparsity_jac(i, j).nnz()>0) autonomousB_ = false;
+        }
+      }
+      if (!autonomousB_) {
+        Function dtB = getdtB();
+        set_function(dtB, dtB.name(), true);
+      }
+    }
+
+    // Jacobians and linear solvers, forward problem
+    Function J = getJ(false);
+    set_function(J, J.name(), true);
+    sp_W_ = J.sparsity_out(0);
+    sp_W_.get_diag(diag_);
+    linsolF_ = Linsol("linsolF", linear_solver_, sp_W_, linear_solver_options_);
+
+    // Jacobians and linear solvers, backward problem
+    if (nrx_>0) {
+      J = getJ(true);
+      set_function(J, J.name(), true);
+      sp_WB_ = J.sparsity_out(0);
+      sp_WB_.get_diag(diagB_);
+      linsolB_ = Linsol("linsolB", linear_solver_, sp_WB_, linear_solver_options_);
+    }
+
+    // Largest number of nonzeros in the iteration matrix
+    nnz_W_ = nrx_>0 ? max(sp_W_.nnz(), sp_WB_.nnz()) : sp_W_.nnz();
+
+    // Allocate work vectors
+    casadi_int n = max(ny_, nry_);
+    alloc_w(np_, true); // p
+    alloc_w(nrp_, true); // rp
+    alloc_w(9*n, true); // y, f0, f1, f2, k1, k2, k3, y_new, T
+    alloc_w(3*n, true); // cont
+    alloc_w(2*nnz_W_, true); // jac, W
+    alloc_w(nx_, true); // x_interp
+    if (nrx_>0) alloc_w(nx_, true); // xdot_interp
+    if (has_codegen()) alloc_w(linsolF_->sz_w_generate(), true); // factorization, C code
+  }
+
+  Function Rosenbrock::getJ(bool backward) const {
+    return oracle_.is_a("SXFunction") ? getJ<SX>(backward) : getJ<MX>(backward);
+  }
+
+  template<typename MatType>
+  Function Rosenbrock::getJ(bool backward) const {
+    vector<MatType> a = MatType::get_input(oracle_);
+    vector<MatType> r = const_cast<Function&>(oracle_)(a);
+
+    // The quadratures do not enter in the right-hand side
+    if (backward) {
+      MatType rhs = vertcat(vec(r[DE_RODE]), vec(r[DE_RQUAD]));
+      MatType jac = horzcat(MatType::jacobian(rhs, a[DE_RX]), MatType(nry_, nrq_));
+      jac = project(jac, jac.sparsity() + Sparsity::diag(nry_));
+      return Function("jacB", {a[DE_RX], a[DE_RP], a[DE_X], a[DE_P], a[DE_T]}, {jac});
+    } else {
+      MatType rhs = vertcat(vec(r[DE_ODE]), vec(r[DE_QUAD]));
+      MatType jac = horzcat(MatType::jacobian(rhs, a[DE_X]), MatType(ny_, nq_));
+      jac = project(jac, jac.sparsity() + Sparsity::diag(ny_));
+      return Function("jacF", {a[DE_X], a[DE_P], a[DE_T]}, {jac});
+    }
+  }
+
+  Function Rosenbrock::getdtB() const {
+    return oracle_.is_a("SXFunction") ? getdtB<SX>() : getdtB<MX>();
+  }
+
+  template<typename MatType>
+  Function Rosenbrock::getdtB() const {
+    vector<MatType> a = MatType::get_input(oracle_);
+    vector<MatType> r = const_cast<Function&>(oracle_)(a);
+
+    // d/dt f(rx, x(t), t) = df/dx * xdot + df/dt
+    MatType rhs = vertcat(vec(r[DE_RODE]), vec(r[DE_RQUAD]));
+    MatType xdot = MatType::sym("xdot", a[DE_X].sparsity());
+    MatType dt = jtimes(rhs, a[DE_X], xdot);
+    if (!a[DE_T].is_empty()) dt += jtimes(rhs, a[DE_T], MatType::ones(a[DE_T].sparsity()));
+    return Function("dtB", {a[DE_RX], a[DE_RP], a[DE_X], a[DE_P], a[DE_T], xdot},
+                    {densify(dt)});
+  }
+
+  int Rosenbrock::init_mem(void* mem) const {
+    if (Integrator::init_mem(mem)) return 1;
+    auto m = static_cast<RosenbrockMemory*>(mem);
+
+    m->mem_linsolF = linsolF_.checkout();
+    if (!linsolB_.is_null()) m->mem_linsolB = linsolB_.checkout();
+    return 0;
+  }
+
+  void Rosenbrock::free_mem(void *mem) const {
+    auto m = static_cast<RosenbrockMemory*>(mem);
+
+    linsolF_.release(m->mem_linsolF);
+    if (!linsolB_.is_null()) linsolB_.release(m->mem_linsolB);
+    delete m;
+  }
+
+  void Rosenbrock::set_work(void* mem, const double**& arg, double**& res,
+                            casadi_int*& iw, double*& w) const {
+    Integrator::set_work(mem, arg, res, iw, w);
+    auto m = static_cast<RosenbrockMemory*>(mem);
+
+    // The forward and backward problem share work vectors
+    casadi_int n = max(ny_, nry_);
+    m->p = w; w += np_;
+    m->rp = w; w += nrp_;
+    m->y = w; w += n;
+    m->f0 = w; w += n;
+    m->f1 = w; w += n;
+    m->f2 = w; w += n;
+    m->k1 = w; w += n;
+    m->k2 = w; w += n;
+    m->k3 = w; w += n;
+    m->y_new = w; w += n;
+    m->T = w; w += n;
+    m->cont = w; w += 3*n;
+    m->jac = w; w += nnz_W_;
+    m->W = w; w += nnz_W_;
+    m->x_interp = w; w += nx_;
+    if (nrx_>0) {
+      m->xdot_interp = w; w += nx_;
+    }
+
+    // Factorization in generated code
+    if (has_codegen()) w += linsolF_->sz_w_generate();
+  }
+
+  void Rosenbrock::forward_state(RosenbrockMemory* m, double t, double* xdot) const {
+    // Dense output of the step containing t
+    casadi_int nsteps = m->tape_t.size()-1;
+    casadi_int j = upper_bound(m->tape_t.begin(), m->tape_t.end(), t) - m->tape_t.begin() - 1;
+    j = min(max(j, casadi_int(0)), nsteps-1);
+    double dt = m->tape_t[j+1] - m->tape_t[j];
+    double theta = (t - m->tape_t[j])/dt;
+    interpolate(theta, nx_, get_ptr(m->tape) + 3*nx_*j, m->x_interp);
+    if (xdot) {
+      interpolate_derivative(theta, nx_, get_ptr(m->tape) + 3*nx_*j, xdot);
+      casadi_scal(nx_, 1/dt, xdot);
+    }
+  }
+
+  void Rosenbrock::rhs(RosenbrockMemory* m, bool backward, double t,
+                       const double* y, double* ydot) const {
+    if (backward) {
+      // Evaluate backward dynamics
+      forward_state(m, t);
+      m->arg[0] = y;
+      m->arg[1] = m->rp;
+      m->arg[2] = m->x_interp;
+      m->arg[3] = m->p;
+      m->arg[4] = &t;
+      m->res[0] = ydot;
+      m->res[1] = ydot + nrx_;
+      if (calc_function(m, "daeB")) casadi_error("'daeB' calculation failed");
+      m->nfevalsB++;
+    } else {
+      // Evaluate forward dynamics
+      m->arg[0] = y;
+      m->arg[1] = m->p;
+      m->arg[2] = &t;
+      m->res[0] = ydot;
+      m->res[1] = ydot + nx_;
+      if (calc_function(m, "daeF")) casadi_error("'daeF' calculation failed");
+      m->nfevals++;
+    }
+  }
+
+  void Rosenbrock::jac(RosenbrockMemory* m, bool backward, double t, const double* y) const {
+    if (backward) {
+      // The method is of W-type, the time derivative is not needed
+      forward_state(m, t);
+      m->arg[0] = y;
+      m->arg[1] = m->rp;
+      m->arg[2] = m->x_interp;
+      m->arg[3] = m->p;
+      m->arg[4] = &t;
+      m->res[0] = m->jac;
+      if (calc_function(m, "jacB")) casadi_error("'jacB' calculation failed");
+      m->njevalsB++;
+    } else {
+      m->arg[0] = y;
+      m->arg[1] = m->p;
+      m->arg[2] = &t;
+      m->res[0] = m->jac;
+      if (calc_function(m, "jacF")) casadi_error("'jacF' calculation failed");
+      m->njevals++;
+    }
+
+    // Fresh Jacobian, the iteration matrix needs to be refactorized
+    m->jac_age = 0;
+    m->h_fact = 0;
+  }
+
+  void Rosenbrock::time_derivative(RosenbrockMemory* m, bool backward, double t,
+                                   const double* y) const {
+    if (backward) {
+      forward_state(m, t, m->xdot_interp);
+      m->arg[0] = y;
+      m->arg[1] = m->rp;
+      m->arg[2] = m->x_interp;
+      m->arg[3] = m->p;
+      m->arg[4] = &t;
+      m->arg[5] = m->xdot_interp;
+      m->res[0] = m->T;
+      if (calc_function(m, "dtB")) casadi_error("'dtB' calculation failed");
+    } else {
+      m->arg[0] = y;
+      m->arg[1] = m->p;
+      m->arg[2] = &t;
+      m->res[0] = m->T;
+      m->res[1] = m->T + nx_;
+      if (calc_function(m, "dtF")) casadi_error("'dtF' calculation failed");
+    }
+  }
+
+  void Rosenbrock::factorize(RosenbrockMemory* m, bool backward, double h) const {
+    const Sparsity& sp = backward ? sp_WB_ : sp_W_;
+    const vector<casadi_int>& diag = backward ? diagB_ : diag_;
+
+    // W = I - h*d*J
+    for (casadi_int k=0; k<sp.nnz(); ++k) m->W[k] = -h*ros_d*m->jac[k];
+    for (casadi_int i : diag) m->W[i] += 1;
+
+    // Numeric factorization
+    if (backward) {
+      if (linsolB_.nfact(m->W, m->mem_linsolB)) casadi_error("'jacB' factorization failed");
+      m->nlinsetupsB++;
+    } else {
+      if (linsolF_.nfact(m->W, m->mem_linsolF)) casadi_error("'jacF' factorization failed");
+      m->nlinsetups++;
+    }
+    m->h_fact = h;
+  }
+
+  /// Weighted RMS norm, as used for the error control
+  static double wrms_norm(casadi_int n, const double* v, const double* y, const double* y_new,
+                          double abstol, double reltol) {
+    if (n==0) return 0;
+    double r = 0;
+    for (casadi_int i=0; i<n; ++i) {
+      double sc = abstol + reltol*fmax(fabs(y[i]), fabs(y_new[i]));
+      r += (v[i]/sc)*(v[i]/sc);
+    }
+    return sqrt(r/static_cast<double>(n));
+  }
+
+  double Rosenbrock::step(RosenbrockMemory* m, bool backward, double t, double h) const {
+    casadi_int n = backward ? nry_ : ny_;
+    double dir = backward ? -1 : 1;
+    const Linsol& linsol = backward ? linsolB_ : linsolF_;
+    casadi_int mem = backward ? m->mem_linsolB : m->mem_linsolF;
+    double *y = m->y, *y_new = m->y_new, *f0 = m->f0, *f1 = m->f1, *f2 = m->f2;
+    double *k1 = m->k1, *k2 = m->k2, *k3 = m->k3;
+
+    // Iteration matrix
+    if (h!=m->h_fact) factorize(m, backward, h);
+
+    // Derivative of the right-hand side with respect to the direction of integration
+    bool autonomous = backward ? autonomousB_ : autonomous_;
+
+    // First stage, the right-hand side at the beginning of the step is available
+    casadi_copy(f0, n, k1);
+    if (!autonomous) casadi_axpy(n, dir*h*ros_d, m->T, k1);
+    if (linsol.solve(m->W, k1, 1, false, mem)) casadi_error("Linear solve failed");
+
+    // Second stage
+    casadi_copy(y, n, y_new);
+    casadi_axpy(n, h/2, k1, y_new);
+    rhs(m, backward, t + dir*h/2, y_new, f1);
+    for (casadi_int i=0; i<n; ++i) k2[i] = f1[i] - k1[i];
+    if (linsol.solve(m->W, k2, 1, false, mem)) casadi_error("Linear solve failed");
+    casadi_axpy(n, 1., k1, k2);
+
+    // Solution, its right-hand side is the first stage of the next step
+    casadi_copy(y, n, y_new);
+    casadi_axpy(n, h, k2, y_new);
+    rhs(m, backward, t + dir*h, y_new, f2);
+
+    // Third stage, only needed for the error estimate
+    for (casadi_int i=0; i<n; ++i) {
+      k3[i] = f2[i] - ros_e32*(k2[i] - f1[i]) - 2*(k1[i] - f0[i]);
+    }
+    if (!autonomous) casadi_axpy(n, dir*h*ros_d, m->T, k3);
+    if (linsol.solve(m->W, k3, 1, false, mem)) casadi_error("Linear solve failed");
+
+    // Estimate the error of the states
+    casadi_int nerr = backward ? nrx_ : nx_;
+    for (casadi_int i=0; i<nerr; ++i) k3[i] = h/6*(k1[i] - 2*k2[i] + k3[i]);
+    return wrms_norm(nerr, k3, y, y_new, abstol_, reltol_);
+  }
+
+  double Rosenbrock::initial_step(RosenbrockMemory* m, bool backward, double t) const {
+    // Hairer, Norsett & Wanner, Solving Ordinary Differential Equations I, Sec. II.4
+    casadi_int n = backward ? nry_ : ny_;
+    casadi_int nerr = backward ? nrx_ : nx_;
+    double dir = backward ? -1 : 1;
+    double t_end = backward ? grid_.front() : grid_.back();
+    double *y = m->y, *f0 = m->f0, *y1 = m->y_new, *f1 = m->f1;
+    double d0 = wrms_norm(nerr, y, y, y, abstol_, reltol_);
+    double d1 = wrms_norm(nerr, f0, y, y, abstol_, reltol_);
+    double h0 = d0<1e-5 || d1<1e-5 ? 1e-6 : 0.01*d0/d1;
+    h0 = fmin(h0, fabs(t_end - t));
+
+    // Explicit Euler step
+    casadi_copy(y, n, y1);
+    casadi_axpy(n, h0, f0, y1);
+    rhs(m, backward, t + dir*h0, y1, f1);
+    casadi_axpy(nerr, -1., f0, f1);
+    double d2 = wrms_norm(nerr, f1, y, y, abstol_, reltol_)/h0;
+
+    // Step size such that the local error is about 0.01
+    double dmax = fmax(d1, d2);
+    double h1 = dmax<=1e-15 ? fmax(1e-6, 1e-3*h0) : pow(0.01/dmax, 1./3);
+    return fmin(100*h0, h1);
+  }
+
+  void Rosenbrock::interpolate(double theta, casadi_int n, const double* cont, double* y) {
+    const double *y0 = cont, *hk1 = cont+n, *hk2 = cont+2*n;
+    double c1 = theta*(1 - theta)/(1 - 2*ros_d), c2 = theta*(theta - 2*ros_d)/(1 - 2*ros_d);
+    for (casadi_int i=0; i<n; ++i) y[i] = y0[i] + c1*hk1[i] + c2*hk2[i];
+  }
+
+  void Rosenbrock::interpolate_derivative(double theta, casadi_int n, const double* cont,
+                                          double* ydot) {
+    const double *hk1 = cont+n, *hk2 = cont+2*n;
+    double c1 = (1 - 2*theta)/(1 - 2*ros_d), c2 = (2*theta - 2*ros_d)/(1 - 2*ros_d);
+    for (casadi_int i=0; i<n; ++i) ydot[i] = c1*hk1[i] + c2*hk2[i];
+  }
+
+  void Rosenbrock::integrate(RosenbrockMemory* m, bool backward, double t_out) const {
+    // Forward or backward problem
+    double& t = backward ? m->rt : m->t;
+    double& h = backward ? m->rh : m->h;
+    long& nsteps = backward ? m->nstepsB : m->nsteps;
+    long& netfails = backward ? m->netfailsB : m->netfails;
+    casadi_int n = backward ? nry_ : ny_;
+    double dir = backward ? -1 : 1;
+    double t_end = backward ? grid_.front() : grid_.back();
+
+    // Take steps until t_out has been reached
+    while (dir*(t_out - t) > 0) {
+      casadi_assert(nsteps<max_num_steps_,
+        "Maximum number of steps (" + str(max_num_steps_) + ") reached at t=" + str(t));
+
+      // Initial step size
+      if (h==0) h = step0_>0 ? step0_ : initial_step(m, backward, t);
+      h = fmin(h, max_step_size_);
+
+      // Reevaluate an outdated Jacobian
+      if (m->jac_age>=max_jacobian_age_) jac(m, backward, t, m->y);
+
+      // Time derivative, which cannot be reused without deteriorating the error estimate
+      if (!(backward ? autonomousB_ : autonomous_)) time_derivative(m, backward, t, m->y);
+
+      // Try steps until the error test passes
+      double fac_max = 5;
+      double err;
+      bool last;
+      while (true) {
+        // Do not step past the end of the time horizon
+        double remaining = dir*(t_end - t);
+        last = h >= remaining*(1 - 1e-12);
+        if (last) h = remaining;
+        casadi_assert(h>16*eps*fabs(t), "Step size too small at t=" + str(t));
+
+        // Take step
+        err = step(m, backward, t, h);
+        if (err<=1) break;
+
+        // Step rejected, reduce step size
+        netfails++;
+        h *= fmax(0.2, 0.9*pow(err, -1./3));
+        fac_max = 1;
+
+        // The rejection may be caused by an outdated Jacobian
+        if (m->jac_age>0) jac(m, backward, t, m->y);
+      }
+
+      // Dense output of the accepted step
+      for (casadi_int i=0; i<n; ++i) {
+        m->cont[i] = m->y[i];
+        m->cont[n + i] = h*m->k1[i];
+        m->cont[2*n + i] = h*m->k2[i];
+      }
+      m->t_old = t;
+      m->h_old = h;
+      t = last ? t_end : t + dir*h;
+      nsteps++;
+      m->jac_age++;
+
+      // Forward state trajectory, for the backward problem
+      if (!backward && nrx_>0) {
+        for (casadi_int r=0; r<3; ++r) {
+          const double* c = m->cont + n*r;
+          m->tape.insert(m->tape.end(), c, c + nx_);
+        }
+        m->tape_t.push_back(t);
+      }
+
+      // Accept step
+      casadi_copy(m->y_new, n, m->y);
+      casadi_copy(m->f2, n, m->f0);
+
+      // Step size for the next step, keep the factorization for small increases
+      double fac = err==0 ? fac_max : fmin(fac_max, fmax(0.2, 0.9*pow(err, -1./3)));
+      if (fac<1 || fac>1.2) h *= fac;
+    }
+
+    // Interpolate the solution at t_out
+    if (m->h_old==0) {
+      casadi_copy(m->y, n, m->y_new);
+    } else {
+      interpolate(dir*(t_out - m->t_old)/m->h_old, n, m->cont, m->y_new);
+    }
+  }
+
+  void Rosenbrock::reset(IntegratorMemory* mem, double t, const double* x,
+                         const double* z, const double* p) const {
+    auto m = static_cast<RosenbrockMemory*>(mem);
+
+    // Update time, step size to be estimated, Jacobian to be evaluated
+    m->t = t;
+    m->h = 0;
+    m->h_old = 0;
+    m->h_fact = 0;
+    m->jac_age = max_jacobian_age_;
+
+    // Set parameters
+    casadi_copy(p, np_, m->p);
+
+    // Update the state, reset quadratures
+    casadi_copy(x, nx_, m->y);
+    casadi_fill(m->y + nx_, nq_, 0.);
+
+    // Reset statistics
+    m->nsteps = m->nfevals = m->njevals = m->nlinsetups = m->netfails = 0;
+
+    // Clear the tape
+    if (nrx_>0) {
+      m->tape.clear();
+      m->tape_t.clear();
+      m->tape_t.push_back(t);
+    }
+
+    // Right-hand side at the initial time
+    rhs(m, false, t, m->y, m->f0);
+  }
+
+  void Rosenbrock::advance(IntegratorMemory* mem, double t,
+                           double* x, double* z, double* q) const {
+    auto m = static_cast<RosenbrockMemory*>(mem);
+
+    // Integrate and interpolate at t
+    integrate(m, false, t);
+
+    // Return to user
+    casadi_copy(m->y_new, nx_, x);
+    casadi_copy(m->y_new + nx_, nq_, q);
+  }
+
+  void Rosenbrock::resetB(IntegratorMemory* mem, double t, const double* rx,
+                          const double* rz, const double* rp) const {
+    auto m = static_cast<RosenbrockMemory*>(mem);
+    casadi_assert(m->tape_t.size()>1 && m->t==grid_.back(),
+                  "Forward integration must reach the end of the time horizon");
+
+    // Update time, step size to be estimated, Jacobian to be evaluated
+    m->rt = t;
+    m->rh = 0;
+    m->h_old = 0;
+    m->h_fact = 0;
+    m->jac_age = max_jacobian_age_;
+
+    // Set parameters
+    casadi_copy(rp, nrp_, m->rp);
+
+    // Update the state, reset quadratures
+    casadi_copy(rx, nrx_, m->y);
+    casadi_fill(m->y + nrx_, nrq_, 0.);
+
+    // Reset statistics
+    m->nstepsB = m->nfevalsB = m->njevalsB = m->nlinsetupsB = m->netfailsB = 0;
+
+    // Right-hand side at the initial time
+    rhs(m, true, t, m->y, m->f0);
+  }
+
+  void Rosenbrock::retreat(IntegratorMemory* mem, double t,
+                           double* rx, double* rz, double* rq) const {
+    auto m = static_cast<RosenbrockMemory*>(mem);
+
+    // Integrate backward and interpolate at t
+    integrate(m, true, t);
+
+    // Return to user
+    casadi_copy(m->y_new, nrx_, rx);
+    casadi_copy(m->y_new + nrx_, nrq_, rq);
+  }
+
+  void Rosenbrock::print_stats(IntegratorMemory* mem) const {
+    auto m = static_cast<RosenbrockMemory*>(mem);
+    print("FORWARD INTEGRATION:\n");
+    print("Number of steps taken: %ld\n", m->nsteps);
+    print("Number of calls to the user's f function: %ld\n", m->nfevals);
+    print("Number of Jacobian evaluations: %ld\n", m->njevals);
+    print("Number of calls to the linear solver setup routine: %ld\n", m->nlinsetups);
+    print("Number of error test failures: %ld\n", m->netfails);
+    if (nrx_>0) {
+      print("BACKWARD INTEGRATION:\n");
+      print("Number of steps taken: %ld\n", m->nstepsB);
+      print("Number of calls to the user's f function: %ld\n", m->nfevalsB);
+      print("Number of Jacobian evaluations: %ld\n", m->njevalsB);
+      print("Number of calls to the linear solver setup routine: %ld\n", m->nlinsetupsB);
+      print("Number of error test failures: %ld\n", m->netfailsB);
+    }
+  }
+
+  Dict Rosenbrock::get_stats(void* mem) const {
+    Dict stats = Integrator::get_stats(mem);
+    auto m = static_cast<RosenbrockMemory*>(mem);
+
+    // Counters, forward problem
+    stats["nsteps"] = static_cast<casadi_int>(m->nsteps);
+    stats["nfevals"] = static_cast<casadi_int>(m->nfevals);
+    stats["njevals"] = static_cast<casadi_int>(m->njevals);
+    stats["nlinsetups"] = static_cast<casadi_int>(m->nlinsetups);
+    stats["netfails"] = static_cast<casadi_int>(m->netfails);
+
+    // Counters, backward problem
+    stats["nstepsB"] = static_cast<casadi_int>(m->nstepsB);
+    stats["nfevalsB"] = static_cast<casadi_int>(m->nfevalsB);
+    stats["njevalsB"] = static_cast<casadi_int>(m->njevalsB);
+    stats["nlinsetupsB"] = static_cast<casadi_int>(m->nlinsetupsB);
+    stats["netfailsB"] = static_cast<casadi_int>(m->netfailsB);
+    return stats;
+  }
+
+  bool Rosenbrock::has_codegen() const {
+    // Forward problem only, the linear solver must support a separate factorization
+    return nrx_==0 && linsolF_->has_generate_nfact();
+  }
+
+  void Rosenbrock::codegen_declarations(CodeGenerator& g) const {
+    casadi_assert(nrx_==0, "Code generation is not supported for the backward problem");
+    casadi_assert(linsolF_->has_generate_nfact(),
+                  "Code generation requires a linear solver that supports it, e.g. 'qr' or 'ldl'");
+    g.add_dependency(get_function("daeF"));
+    g.add_dependency(get_function("jacF"));
+    if (!autonomous_) g.add_dependency(get_function("dtF"));
+  }
+
+  std::string Rosenbrock::codegen_calc(CodeGenerator& g, const Function& f,
+                                       const std::vector<std::string>& arg,
+                                       const std::vector<std::string>& res) const {
+    std::string fname = g.add_dependency(f);
+    for (casadi_int i=0; i<arg.size(); ++i) g << "arg1[" << i << "] = " << arg[i] << ";\n";
+    for (casadi_int i=0; i<res.size(); ++i) g << "res1[" << i << "] = " << res[i] << ";\n";
+    return fname + "(arg1, res1, iw, w1, 0)";
+  }
+
+  /// Generate code for the weighted RMS norm of the expression v(i), stored in r
+  static void codegen_wrms(CodeGenerator& g, casadi_int n, const std::string& v,
+                           const std::string& y, const std::string& y_new,
+                           double abstol, double reltol) {
+    if (n==0) {
+      g << "r = 0;\n";
+      return;
+    }
+    g << "r = 0;\n"
+      << "for (i=0; i<" << n << "; ++i) {\n"
+      << "sc = " << g.constant(abstol) << "+" << g.constant(reltol)
+      << "*casadi_fmax(fabs(" << y << "[i]), fabs(" << y_new << "[i]));\n"
+      << "e = " << v << ";\n"
+      << "r += (e/sc)*(e/sc);\n"
+      << "}\n"
+      << "r = sqrt(r/" << n << ".);\n";
+  }
+
+  void Rosenbrock::codegen_body(CodeGenerator& g) const {
+    g.add_auxiliary(CodeGenerator::AUX_FMIN);
+    g.add_auxiliary(CodeGenerator::AUX_FMAX);
+    string d = g.constant(ros_d), t_end = g.constant(grid_.back());
+    string pow_err = "pow(err, -1./3)";
+
+    // Temporary arguments, results and work vector for function calls
+    g.local("arg1", "const casadi_real", "**");
+    g.local("res1", "casadi_real", "**");
+    g.local("w1", "casadi_real", "*");
+    g << "arg1 = arg+" << INTEGRATOR_NUM_IN << ";\n";
+    g << "res1 = res+" << INTEGRATOR_NUM_OUT << ";\n";
+
+    // Persistent work vectors, as laid out by set_work
+    casadi_int n = max(ny_, nry_);
+    const char* work[] = {"p", "rp", "y", "f0", "f1", "f2", "k1", "k2", "k3", "y_new", "T",
+                          "cont", "jac", "W", "x_interp", "lin"};
+    const casadi_int work_sz[] = {np_, nrp_, n, n, n, n, n, n, n, n, n,
+                                  3*n, nnz_W_, nnz_W_, nx_, linsolF_->sz_w_generate()};
+    casadi_int offset = 0;
+    for (casadi_int i=0; i<16; ++i) {
+      // Not needed for the forward problem or for an autonomous system
+      string s = work[i];
+      if (s!="rp" && s!="x_interp" && !(s=="T" && autonomous_)) {
+        g.local(s, "casadi_real", "*");
+        g << s << " = w+" << offset << ";\n";
+      }
+      offset += work_sz[i];
+    }
+    g << "w1 = w+" << offset << ";\n";
+
+    // Scalars
+    const char* scalars[] = {"t", "t1", "t_out", "t_old", "h", "h_old", "h_fact", "h0",
+                             "d0", "d1", "d2", "err", "fac", "fac_max", "remaining",
+                             "theta", "r", "sc", "e"};
+    for (const char* s : scalars) g.local(s, "casadi_real");
+    g.local("i", "casadi_int");
+    g.local("k", "casadi_int");
+    g.local("nsteps", "casadi_int");
+    g.local("jac_age", "casadi_int");
+    g.local("last", "casadi_int");
+
+    g.comment("Initial state and parameters");
+    g << g.copy("arg[" + str(INTEGRATOR_P) + "]", np_, "p") << "\n"
+      << g.copy("arg[" + str(INTEGRATOR_X0) + "]", nx_, "y") << "\n"
+      << g.fill("y+" + str(nx_), nq_, "0.") << "\n";
+    g << "t = " << g.constant(grid_.front()) << ";\n"
+      << "h = 0;\n"
+      << "t_old = t;\n"
+      << "h_old = 0;\n"
+      << "h_fact = 0;\n"
+      << "jac_age = " << max_jacobian_age_ << ";\n"
+      << "nsteps = 0;\n";
+    string call = codegen_calc(g, get_function("daeF"), {"y", "p", "&t"},
+                               {"f0", "f0+" + str(nx_)});
+    g << "if (" << call << ") return 1;\n";
+
+    g.comment("Integrate to each point of the time grid");
+    string grid = g.constant(grid_);
+    casadi_int k0 = output_t0_ ? 0 : 1;
+    g << "for (k=" << k0 << "; k<" << ngrid_ << "; ++k) {\n"
+      << "t_out = " << grid << "[k];\n"
+      << "while (t_out-t>0) {\n"
+      << "if (nsteps>=" << max_num_steps_ << ") return 1;\n";
+
+    // Initial step size
+    if (step0_>0) {
+      g << "if (h==0) h = " << g.constant(step0_) << ";\n";
+    } else {
+      g.comment("Initial step size, Hairer, Norsett & Wanner");
+      g << "if (h==0) {\n";
+      codegen_wrms(g, nx_, "y[i]", "y", "y", abstol_, reltol_);
+      g << "d0 = r;\n";
+      codegen_wrms(g, nx_, "f0[i]", "y", "y", abstol_, reltol_);
+      g << "d1 = r;\n"
+        << "h0 = d0<1e-5 || d1<1e-5 ? 1e-6 : 0.01*d0/d1;\n"
+        << "h0 = casadi_fmin(h0, " << t_end << "-t);\n"
+        << g.copy("y", n, "y_new") << "\n"
+        << g.axpy(n, "h0", "f0", "y_new") << "\n"
+        << "t1 = t+h0;\n";
+      call = codegen_calc(g, get_function("daeF"), {"y_new", "p", "&t1"},
+                          {"f1", "f1+" + str(nx_)});
+      g << "if (" << call << ") return 1;\n"
+        << g.axpy(nx_, "-1.", "f0", "f1") << "\n";
+      codegen_wrms(g, nx_, "f1[i]", "y", "y", abstol_, reltol_);
+      g << "d2 = casadi_fmax(d1, r/h0);\n"
+        << "h = d2<=1e-15 ? casadi_fmax(1e-6, 1e-3*h0) : pow(0.01/d2, 1./3);\n"
+        << "h = casadi_fmin(100*h0, h);\n"
+        << "}\n";
+    }
+    if (max_step_size_<inf) g << "h = casadi_fmin(h, " << g.constant(max_step_size_) << ");\n";
+
+    g.comment("Reevaluate an outdated Jacobian");
+    call = codegen_calc(g, get_function("jacF"), {"y", "p", "&t"}, {"jac"});
+    g << "if (jac_age>=" << max_jacobian_age_ << ") {\n"
+      << "if (" << call << ") return 1;\n"
+      << "jac_age = 0;\n"
+      << "h_fact = 0;\n"
+      << "}\n";
+    if (!autonomous_) {
+      g.comment("Time derivative");
+      call = codegen_calc(g, get_function("dtF"), {"y", "p", "&t"}, {"T", "T+" + str(nx_)});
+      g << "if (" << call << ") return 1;\n";
+    }
+
+    g.comment("Try steps until the error test passes");
+    g << "fac_max = 5;\n"
+      << "while (1) {\n"
+      << "remaining = " << t_end << "-t;\n"
+      << "last = h>=remaining*(1-1e-12);\n"
+      << "if (last) h = remaining;\n"
+      << "if (h<=" << g.constant(16*eps) << "*fabs(t)) return 1;\n";
+    g.comment("Iteration matrix W = I - h*d*J");
+    g << "if (h!=h_fact) {\n"
+      << "for (i=0; i<" << sp_W_.nnz() << "; ++i) W[i] = -h*" << d << "*jac[i];\n"
+      << "for (i=0; i<" << ny_ << "; ++i) W[" << g.constant(diag_) << "[i]] += 1;\n";
+    linsolF_->generate_nfact(g, "W", "lin");
+    g << "h_fact = h;\n"
+      << "}\n";
+    g.comment("First stage");
+    g << g.copy("f0", ny_, "k1") << "\n";
+    if (!autonomous_) g << g.axpy(ny_, "h*" + d, "T", "k1") << "\n";
+    linsolF_->generate_solve(g, "k1", 1, false, "lin");
+    g.comment("Second stage");
+    g << g.copy("y", ny_, "y_new") << "\n"
+      << g.axpy(ny_, "h/2", "k1", "y_new") << "\n"
+      << "t1 = t+h/2;\n";
+    call = codegen_calc(g, get_function("daeF"), {"y_new", "p", "&t1"},
+                        {"f1", "f1+" + str(nx_)});
+    g << "if (" << call << ") return 1;\n"
+      << "for (i=0; i<" << ny_ << "; ++i) k2[i] = f1[i]-k1[i];\n";
+    linsolF_->generate_solve(g, "k2", 1, false, "lin");
+    g << g.axpy(ny_, "1.", "k1", "k2") << "\n";
+    g.comment("Solution");
+    g << g.copy("y", ny_, "y_new") << "\n"
+      << g.axpy(ny_, "h", "k2", "y_new") << "\n"
+      << "t1 = t+h;\n";
+    call = codegen_calc(g, get_function("daeF"), {"y_new", "p", "&t1"},
+                        {"f2", "f2+" + str(nx_)});
+    g << "if (" << call << ") return 1;\n";
+    g.comment("Third stage");
+    g << "for (i=0; i<" << ny_ << "; ++i) {\n"
+      << "k3[i] = f2[i]-" << g.constant(ros_e32) << "*(k2[i]-f1[i])-2*(k1[i]-f0[i]);\n"
+      << "}\n";
+    if (!autonomous_) g << g.axpy(ny_, "h*" + d, "T", "k3") << "\n";
+    linsolF_->generate_solve(g, "k3", 1, false, "lin");
+    g.comment("Error test");
+    codegen_wrms(g, nx_, "h/6*(k1[i]-2*k2[i]+k3[i])", "y", "y_new", abstol_, reltol_);
+    g << "err = r;\n"
+      << "if (err<=1) break;\n"
+      << "h *= casadi_fmax(0.2, 0.9*" << pow_err << ");\n"
+      << "fac_max = 1;\n";
+    call = codegen_calc(g, get_function("jacF"), {"y", "p", "&t"}, {"jac"});
+    g << "if (jac_age>0) {\n"
+      << "if (" << call << ") return 1;\n"
+      << "jac_age = 0;\n"
+      << "h_fact = 0;\n"
+      << "}\n"
+      << "}\n";
+
+    g.comment("Accept step");
+    g << "for (i=0; i<" << ny_ << "; ++i) {\n"
+      << "cont[i] = y[i];\n"
+      << "cont[" << n << "+i] = h*k1[i];\n"
+      << "cont[" << 2*n << "+i] = h*k2[i];\n"
+      << "}\n"
+      << "t_old = t;\n"
+      << "h_old = h;\n"
+      << "t = last ? " << t_end << " : t+h;\n"
+      << "nsteps++;\n"
+      << "jac_age++;\n"
+      << g.copy("y_new", ny_, "y") << "\n"
+      << g.copy("f2", ny_, "f0") << "\n"
+      << "fac = err==0 ? fac_max : casadi_fmin(fac_max, casadi_fmax(0.2, 0.9*"
+      << pow_err << "));\n"
+      << "if (fac<1 || fac>1.2) h *= fac;\n"
+      << "}\n";
+
+    g.comment("Interpolate the solution");
+    g << "if (h_old==0) {\n"
+      << g.copy("y", ny_, "y_new") << "\n"
+      << "} else {\n"
+      << "theta = (t_out-t_old)/h_old;\n"
+      << "for (i=0; i<" << ny_ << "; ++i) {\n"
+      << "y_new[i] = cont[i] + theta*(1-theta)/(1-2*" << d << ")*cont[" << n << "+i]"
+      << " + theta*(theta-2*" << d << ")/(1-2*" << d << ")*cont[" << 2*n << "+i];\n"
+      << "}\n"
+      << "}\n";
+    string xf = "res[" + str(INTEGRATOR_XF) + "]", qf = "res[" + str(INTEGRATOR_QF) + "]";
+    g << "if (" << xf << ") "
+      << g.copy("y_new", nx_, xf + "+(k-" + str(k0) + ")*" + str(nx_)) << "\n"
+      << "if (" << qf << ") "
+      << g.copy("y_new+" + str(nx_), nq_, qf + "+(k-" + str(k0) + ")*" + str(nq_)) << "\n"
+      << "}\n";
+    g << "return 0;\n";
+  }
+
+} // namespace casadi
@@ -0,0 +1,278 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_ROSENBROCK_HPP
+#define CASADI_ROSENBROCK_HPP
+
+#include "casadi/core/integrator_impl.hpp"
+#include "casadi/core/linsol.hpp"
+#include <casadi/solvers/casadi_integrator_rosenbrock_export.h>
+
+/** \defgroup plugin_Integrator_rosenbrock
+      Adaptive-step linearly implicit integrator for stiff ODEs. Implements the
+      L-stable Rosenbrock-W method of order 2(3) by Shampine and Reichelt
+      (ode23s), with dense output for the time grid.
+
+      Each step requires a single factorization of I - h*d*J, computed with a
+      Linsol plugin. Since the method is of W-type, the Jacobian J can be
+      reused over several steps, in which case the factorization is only
+      updated when the step size changes.
+
+      Adjoint sensitivities are calculated by integrating the backward problem
+      with its own step size control, interpolating the forward solution from
+      the dense output of the accepted forward steps. Code generation is
+      supported for the forward problem with the linear solvers 'qr' and 'ldl'.
+*/
+/** \pluginsection{Integrator,rosenbrock} */
+
+/// \cond INTERNAL
+namespace casadi {
+
+  struct CASADI_INTEGRATOR_ROSENBROCK_EXPORT RosenbrockMemory : public IntegratorMemory {
+    // Current time, forward and backward problem
+    double t, rt;
+
+    // Step size to be attempted next, forward and backward problem
+    double h, rh;
+
+    // Step size of the current factorization, 0 if none
+    double h_fact;
+
+    // Number of accepted steps since the Jacobian was evaluated
+    casadi_int jac_age;
+
+    // Parameters, forward and backward problem
+    double *p, *rp;
+
+    // Current state, including quadratures, and its time derivative
+    double *y, *f0;
+
+    // Right-hand sides at the second stage and at the candidate solution
+    double *f1, *f2;
+
+    // Stage solutions
+    double *k1, *k2, *k3;
+
+    // Candidate state, or interpolated state after integration
+    double *y_new;
+
+    // Jacobian, iteration matrix and derivative with respect to time
+    double *jac, *W, *T;
+
+    // Dense output of the last accepted step
+    double t_old, h_old;
+    double *cont;
+
+    // Interpolated forward state and its time derivative
+    double *x_interp, *xdot_interp;
+
+    // Start times of the accepted forward steps
+    std::vector<double> tape_t;
+
+    // Dense output of the forward state for all accepted steps, stored contiguously
+    std::vector<double> tape;
+
+    // Linear solver memory, forward and backward problem
+    casadi_int mem_linsolF, mem_linsolB;
+
+    // Statistics
+    long nsteps, nfevals, njevals, nlinsetups, netfails;
+    long nstepsB, nfevalsB, njevalsB, nlinsetupsB, netfailsB;
+  };
+
+  /** \brief \pluginbrief{Integrator,rosenbrock}
+
+      @copydoc DAE_doc
+      @copydoc plugin_Integrator_rosenbrock
+
+  */
+  class CASADI_INTEGRATOR_ROSENBROCK_EXPORT Rosenbrock : public Integrator {
+  public:
+
+    /// Constructor
+    explicit Rosenbrock(const std::string& name, const Function& dae);
+
+    /** \brief  Create a new integrator */
+    static Integrator* creator(const std::string& name, const Function& dae) {
+      return new Rosenbrock(name, dae);
+    }
+
+    /// Destructor
+    ~Rosenbrock() override;
+
+    // Get name of the plugin
+    const char* plugin_name() const override { return "rosenbrock";}
+
+    // Get name of the class
+    std::string class_name() const override { return "Rosenbrock";}
+
+    ///@{
+    /** \brief Options */
+    static Options options_;
+    const Options& get_options() const override { return options_;}
+    ///@}
+
+    /// Initialize stage
+    void init(const Dict& opts) override;
+
+    /** \brief Create memory block */
+    void* alloc_mem() const override { return new RosenbrockMemory();}
+
+    /** \brief Initalize memory block */
+    int init_mem(void* mem) const override;
+
+    /** \brief Free memory block */
+    void free_mem(void *mem) const override;
+
+    /** \brief Set the (persistent) work vectors */
+    void set_work(void* mem, const double**& arg, double**& res,
+                  casadi_int*& iw, double*& w) const override;
+
+    /** \brief Reset the forward problem */
+    void reset(IntegratorMemory* mem, double t,
+               const double* x, const double* z, const double* p) const override;
+
+    /** \brief  Advance solution in time */
+    void advance(IntegratorMemory* mem, double t,
+                 double* x, double* z, double* q) const override;
+
+    /** \brief Reset the backward problem */
+    void resetB(IntegratorMemory* mem, double t,
+                const double* rx, const double* rz, const double* rp) const override;
+
+    /** \brief  Retreat solution in time */
+    void retreat(IntegratorMemory* mem, double t,
+                 double* rx, double* rz, double* rq) const override;
+
+    /** \brief  Print solver statistics */
+    void print_stats(IntegratorMemory* mem) const override;
+
+    /// Get all statistics
+    Dict get_stats(void* mem) const override;
+
+    /** \brief Is codegen supported? */
+    bool has_codegen() const override;
+
+    /** \brief Generate code for the declarations of the C function */
+    void codegen_declarations(CodeGenerator& g) const override;
+
+    /** \brief Generate code for the function body */
+    void codegen_body(CodeGenerator& g) const override;
+
+    /// Generate code for a call to a dependency, returns the call
+    std::string codegen_calc(CodeGenerator& g, const Function& f,
+                             const std::vector<std::string>& arg,
+                             const std::vector<std::string>& res) const;
+
+    ///@{
+    /// Jacobian of the right-hand side, projected onto the sparsity of the iteration matrix
+    Function getJ(bool backward) const;
+    template<typename MatType> Function getJ(bool backward) const;
+    ///@}
+
+    ///@{
+    /// Total time derivative of the backward right-hand side, along the forward state
+    Function getdtB() const;
+    template<typename MatType> Function getdtB() const;
+    ///@}
+
+    /// Interpolate the forward state at time t, for the backward problem
+    void forward_state(RosenbrockMemory* m, double t, double* xdot=nullptr) const;
+
+    /// Evaluate the right-hand side, forward or backward problem
+    void rhs(RosenbrockMemory* m, bool backward, double t,
+             const double* y, double* ydot) const;
+
+    /// Evaluate the Jacobian, forward or backward problem
+    void jac(RosenbrockMemory* m, bool backward, double t, const double* y) const;
+
+    /// Evaluate the derivative of the right-hand side with respect to time
+    void time_derivative(RosenbrockMemory* m, bool backward, double t, const double* y) const;
+
+    /// Form and factorize the iteration matrix for step size h
+    void factorize(RosenbrockMemory* m, bool backward, double h) const;
+
+    /// Take a step of size h, returns the weighted RMS norm of the error estimate
+    double step(RosenbrockMemory* m, bool backward, double t, double h) const;
+
+    /// Initial step size
+    double initial_step(RosenbrockMemory* m, bool backward, double t) const;
+
+    /// Integrate until time t has been passed, the state interpolated at t is stored in y_new
+    void integrate(RosenbrockMemory* m, bool backward, double t) const;
+
+    /// Evaluate the dense output of a step
+    static void interpolate(double theta, casadi_int n, const double* cont, double* y);
+
+    /// Derivative of the dense output with respect to theta
+    static void interpolate_derivative(double theta, casadi_int n, const double* cont,
+                                       double* ydot);
+
+    /// A documentation string
+    static const std::string meta_doc;
+
+    // Tolerances
+    double abstol_, reltol_;
+
+    // Maximum number of steps
+    casadi_int max_num_steps_;
+
+    // Initial step size, 0 to estimate
+    double step0_;
+
+    // Largest step size
+    double max_step_size_;
+
+    // Number of steps before the Jacobian is reevaluated
+    casadi_int max_jacobian_age_;
+
+    // Linear solver
+    std::string linear_solver_;
+    Dict linear_solver_options_;
+    Linsol linsolF_, linsolB_;
+
+    // Sparsity of the iteration matrix, forward and backward problem
+    Sparsity sp_W_, sp_WB_;
+
+    // Does the right-hand side of the forward problem depend on time?
+    bool autonomous_;
+
+    // Does the right-hand side of the backward problem depend on time, directly or through x?
+    bool autonomousB_;
+
+    // Largest number of nonzeros in the iteration matrix
+    casadi_int nnz_W_;
+
+    // Nonzero indices of the diagonal of the iteration matrix
+    std::vector<casadi_int> diag_, diagB_;
+
+    // Size of the integrated vectors, forward and backward problem
+    casadi_int ny_, nry_;
+  };
+
+} // namespace casadi
+
+/// \endcond
+#endif // CASADI_ROSENBROCK_HPP
@@ -0,0 +1,89 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+      #include "rosenbrock.hpp"
+      #include <string>
+
+      const std::string casadi::Rosenbrock::meta_doc=
+      "\n"
+"Adaptive-step linearly implicit integrator for stiff ODEs. Implements\n"
+"the L-stable Rosenbrock-W method of order 2(3) by Shampine and Reichelt\n"
+"(ode23s), with dense output for the time grid.\n"
+"\n"
+"Each step requires a single factorization of I - h*d*J, computed with a\n"
+"Linsol plugin. Since the method is of W-type, the Jacobian J can be\n"
+"reused over several steps, in which case the factorization is only\n"
+"updated when the step size changes.\n"
+"\n"
+"Adjoint sensitivities are calculated by integrating the backward\n"
+"problem with its own step size control, interpolating the forward\n"
+"solution from the dense output of the accepted forward steps. Code\n"
+"generation is supported for the forward problem with the linear solver\n"
+"'qr'.\n"
+"\n"
+"\n"
+">List of available options\n"
+"\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"|       Id        |      Type       |     Default     |   Description   |\n"
+"+=================+=================+=================+=================+\n"
+"| abstol          | OT_DOUBLE       | 1e-8            | Absolute        |\n"
+"|                 |                 |                 | tolerence for   |\n"
+"|                 |                 |                 | the IVP         |\n"
+"|                 |                 |                 | solution        |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| linear_solver   | OT_STRING       | qr              | A custom linear |\n"
+"|                 |                 |                 | solver creator  |\n"
+"|                 |                 |                 | function        |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| linear_solver_o | OT_DICT         | GenericType()   | Options to be   |\n"
+"| ptions          |                 |                 | passed to the   |\n"
+"|                 |                 |                 | linear solver   |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| max_jacobian_ag | OT_INT          | 10              | Maximum number  |\n"
+"| e               |                 |                 | of steps before |\n"
+"|                 |                 |                 | the Jacobian is |\n"
+"|                 |                 |                 | reevaluated     |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| max_num_steps   | OT_INT          | 10000           | Maximum number  |\n"
+"|                 |                 |                 | of integrator   |\n"
+"|                 |                 |                 | steps           |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| max_step_size   | OT_DOUBLE       | inf             | Largest step    |\n"
+"|                 |                 |                 | size            |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| reltol          | OT_DOUBLE       | 1e-6            | Relative        |\n"
+"|                 |                 |                 | tolerence for   |\n"
+"|                 |                 |                 | the IVP         |\n"
+"|                 |                 |                 | solution        |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| step0           | OT_DOUBLE       | 0/estimated     | initial step    |\n"
+"|                 |                 |                 | size            |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"\n"
+"\n"
+"\n"
+"\n"
+;
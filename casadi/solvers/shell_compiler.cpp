@@ -35,6 +35,7 @@
 #endif // OBJECT_FILE_SUFFIX
 
 #include <cstdlib>
+#include <cstdio>
 
 using namespace std;
 namespace casadi {
@@ -70,7 +71,9 @@ namespace casadi {
 
     if (cleanup_) {
       if (remove(bin_name_.c_str())) casadi_warning("Failed to remove " + bin_name_);
-      if (remove(obj_name_.c_str())) casadi_warning("Failed to remove " + obj_name_);
+      for (auto&& obj : obj_name_) {
+        if (remove(obj.c_str())) casadi_warning("Failed to remove " + obj);
+      }
     }
   }
 
@@ -166,14 +169,25 @@ namespace casadi {
       }
     }
 
-    // Name of temporary file
-    obj_name_ = temporary_file("tmp_casadi_compiler_shell", OBJECT_FILE_SUFFIX);
+    // Source files: the main file and any files listed in its meta data
+    vector<string> src_name = {name_};
+    if (has_meta("split")) {
+      string dir = name_.substr(0, name_.find_last_of("/\\")+1);
+      casadi_int n_split = text2type<casadi_int>(get_meta("split"));
+      for (casadi_int k=0; k<n_split; ++k) src_name.push_back(dir + get_meta("split", k));
+    }
+
+    // Name of temporary files
+    obj_name_.clear();
+    for (casadi_int k=0; k<src_name.size(); ++k) {
+      obj_name_.push_back(temporary_file("tmp_casadi_compiler_shell", OBJECT_FILE_SUFFIX));
+    }
     bin_name_ = temporary_file("tmp_casadi_compiler_shell", SHARED_LIBRARY_SUFFIX);
 
 #ifndef _WIN32
     // Have relative paths start with ./
-    if (obj_name_.at(0)!='/') {
-      obj_name_ = "./" + obj_name_;
+    for (auto&& obj : obj_name_) {
+      if (obj.at(0)!='/') obj = "./" + obj;
     }
 
     if (bin_name_.at(0)!='/') {
@@ -181,24 +195,46 @@ namespace casadi {
     }
 #endif // _WIN32
 
-    // Construct the compiler command
-    stringstream cccmd;
-    cccmd << compiler;
-    for (vector<string>::const_iterator i=compiler_flags.begin(); i!=compiler_flags.end(); ++i) {
-      cccmd << " " << *i;
-    }
-    cccmd << " " << compiler_setup;
+    // Construct the compiler commands
+    vector<string> cccmd;
+    for (casadi_int k=0; k<src_name.size(); ++k) {
+      stringstream ss;
+      ss << compiler;
+      for (vector<string>::const_iterator i=compiler_flags.begin();
+           i!=compiler_flags.end(); ++i) {
+        ss << " " << *i;
+      }
+      ss << " " << compiler_setup;
 
-    // C/C++ source file
-    cccmd << " " << name_;
+      // C/C++ source file
+      ss << " " << src_name[k];
 
-    // Temporary object file
-    cccmd << " " + compiler_output_flag << obj_name_;
+      // Temporary object file
+      ss << " " + compiler_output_flag << obj_name_[k];
+      cccmd.push_back(ss.str());
+    }
 
-    // Compile into an object
-    if (verbose_) uout() << "calling \"" << cccmd.str() + "\"" << std::endl;
-    if (system(cccmd.str().c_str())) {
-      casadi_error("Compilation failed. Tried \"" + cccmd.str() + "\"");
+    // Compile into objects, all compiler processes are started before waiting for any
+    vector<FILE*> proc;
+    for (auto&& c : cccmd) {
+      if (verbose_) uout() << "calling \"" << c + "\"" << std::endl;
+#ifdef _WIN32
+      proc.push_back(_popen(c.c_str(), "w"));
+#else // _WIN32
+      proc.push_back(popen(c.c_str(), "w"));
+#endif // _WIN32
+    }
+    vector<int> flag(cccmd.size(), -1);
+    for (casadi_int k=0; k<cccmd.size(); ++k) {
+      if (proc[k]==nullptr) continue;
+#ifdef _WIN32
+      flag[k] = _pclose(proc[k]);
+#else // _WIN32
+      flag[k] = pclose(proc[k]);
+#endif // _WIN32
+    }
+    for (casadi_int k=0; k<cccmd.size(); ++k) {
+      if (flag[k]) casadi_error("Compilation failed. Tried \"" + cccmd[k] + "\"");
     }
 
     // Link step
@@ -209,8 +245,9 @@ namespace casadi {
     }
     ldcmd << " " << linker_setup;
 
-    // Temporary file
-    ldcmd << " " << obj_name_ << " " + linker_output_flag + bin_name_;
+    // Temporary files
+    for (auto&& obj : obj_name_) ldcmd << " " << obj;
+    ldcmd << " " + linker_output_flag + bin_name_;
 
     // Compile into a shared library
     if (verbose_) uout() << "calling \"" << ldcmd.str() << "\"" << std::endl;
@@ -81,12 +81,15 @@ namespace casadi {
 
     /// Get a function pointer for numerical evaluation
     signal_t get_function(const std::string& symname) override;
+
+    /// Shared library holding the compiled code
+    std::string library() const override { return bin_name_;}
   protected:
     /// Temporary file
     std::string bin_name_;
 
-    /// Temporary file
-    std::string obj_name_;
+    /// Temporary object files, one per source file
+    std::vector<std::string> obj_name_;
 
     /// Cleanup temporary files when unloading
     bool cleanup_;
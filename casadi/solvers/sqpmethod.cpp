@@ -578,6 +578,294 @@ namespace casadi {
     if (verbose_) print("QP solved\n");
   }
 
+  void Sqpmethod::codegen_declarations(CodeGenerator& g) const {
+    casadi_assert(fcallback_.is_null(),
+                  "Code generation is not supported with 'iteration_callback'");
+    casadi_assert(qpsol_->has_codegen(),
+                  "Code generation requires a QP solver that supports it, e.g. 'qrqp'");
+    g.add_dependency(get_function("nlp_fg"));
+    g.add_dependency(get_function("nlp_jac_fg"));
+    if (exact_hessian_) g.add_dependency(get_function("nlp_hess_l"));
+    if (calc_f_ || calc_g_ || calc_lam_x_ || calc_lam_p_) {
+      g.add_dependency(get_function("nlp_grad"));
+    }
+    g.add_dependency(qpsol_);
+  }
+
+  std::string Sqpmethod::codegen_calc(CodeGenerator& g, const Function& f,
+                                      const std::vector<std::string>& arg,
+                                      const std::vector<std::string>& res) const {
+    std::string fname = g.add_dependency(f);
+    for (casadi_int i=0; i<arg.size(); ++i) g << "arg1[" << i << "] = " << arg[i] << ";\n";
+    for (casadi_int i=0; i<res.size(); ++i) g << "res1[" << i << "] = " << res[i] << ";\n";
+    return fname + "(arg1, res1, iw, w1, 0)";
+  }
+
+  void Sqpmethod::codegen_body(CodeGenerator& g) const {
+    g.add_auxiliary(CodeGenerator::AUX_FMIN);
+    g.add_auxiliary(CodeGenerator::AUX_FMAX);
+    if (!exact_hessian_) g.add_auxiliary(CodeGenerator::AUX_BFGS);
+    if (exact_hessian_ && regularize_) g.add_auxiliary(CodeGenerator::AUX_REGULARIZE);
+    if (bound_consistency_) g.add_auxiliary(CodeGenerator::AUX_BOUND_CONSISTENCY);
+
+    // Temporary arguments, results and work vector for function calls
+    g.local("arg1", "const casadi_real", "**");
+    g.local("res1", "casadi_real", "**");
+    g.local("w1", "casadi_real", "*");
+    g << "arg1 = arg+" << NLPSOL_NUM_IN << ";\n";
+    g << "res1 = res+" << NLPSOL_NUM_OUT << ";\n";
+
+    // Problem data
+    const char* data[] = {"p", "lbx", "ubx", "lbg", "ubg"};
+    const casadi_int data_ind[] = {NLPSOL_P, NLPSOL_LBX, NLPSOL_UBX, NLPSOL_LBG, NLPSOL_UBG};
+    for (casadi_int i=0; i<5; ++i) {
+      g.local(data[i], "const casadi_real", "*");
+      g << data[i] << " = arg[" << data_ind[i] << "];\n";
+    }
+
+    // Persistent work vectors, as laid out by set_work
+    const char* work[] = {"x", "lam_x", "lam_g", "lam_p", "g", "x_cand", "gLag", "gLag_old",
+                          "g_cand", "gf", "qp_LBA", "qp_UBA", "qp_LBX", "qp_UBX", "dx",
+                          "qp_DUAL_X", "qp_DUAL_A", "Bk", "Jk", "merit_mem"};
+    const casadi_int work_sz[] = {nx_, nx_, ng_, np_, ng_, nx_, nx_, nx_,
+                                  ng_, nx_, ng_, ng_, nx_, nx_, nx_,
+                                  nx_, ng_, Hsp_.nnz(), Asp_.nnz(), merit_memsize_};
+    casadi_int offset = 0;
+    for (casadi_int i=0; i<20; ++i) {
+      // The previous Lagrangian gradient is only needed for BFGS updates
+      if (!(exact_hessian_ && std::string(work[i])=="gLag_old")) {
+        g.local(work[i], "casadi_real", "*");
+        g << work[i] << " = w+" << offset << ";\n";
+      }
+      offset += work_sz[i];
+    }
+    g << "w1 = w+" << offset << ";\n";
+
+    // Scalars
+    g.local("iter", "casadi_int");
+    g.local("ls_iter", "casadi_int");
+    g.local("merit_ind", "casadi_int");
+    g.local("i", "casadi_int");
+    const char* scalars[] = {"f", "one", "t", "sigma", "pr_inf", "du_inf", "dx_norminf",
+                             "l1_infeas", "L1dir", "L1merit", "L1merit_cand", "meritmax",
+                             "fk_cand"};
+    for (const char* e : scalars) g.local(e, "casadi_real");
+    // Only needed for printing, regularization or failure detection
+    bool with_reg = print_iteration_ || (exact_hessian_ && regularize_);
+    if (with_reg) g.local("reg", "casadi_real");
+    if (print_iteration_) g.local("gain", "casadi_real");
+    if (print_iteration_) g.local("ls_success", "int");
+    if (error_on_fail_) g.local("success", "int");
+
+    // Initial guess
+    g.comment("Initial guess");
+    g << g.copy("arg[" + str(NLPSOL_X0) + "]", nx_, "x") << "\n";
+    g << g.copy("arg[" + str(NLPSOL_LAM_X0) + "]", nx_, "lam_x") << "\n";
+    g << g.copy("arg[" + str(NLPSOL_LAM_G0) + "]", ng_, "lam_g") << "\n";
+    g << g.fill("lam_p", np_, "0.") << "\n";
+    // The previous step is the initial guess for the first QP
+    g << g.fill("dx", nx_, "0.") << "\n";
+    g << "iter = 0;\n";
+    g << "ls_iter = 0;\n";
+    if (print_iteration_) g << "ls_success = 1;\n";
+    if (error_on_fail_) g << "success = 0;\n";
+    g << "merit_ind = 0;\n";
+    g << "sigma = 0.;\n";
+    if (with_reg) g << "reg = 0.;\n";
+    g << "t = 0.;\n";
+    g << "one = 1.;\n";
+
+    // Main optimization loop
+    g.comment("MAIN OPTIMIZATION LOOP");
+    g << "while (1) {\n";
+    g.comment("Evaluate f, g and first order derivative information");
+    std::string call = codegen_calc(g, get_function("nlp_jac_fg"), {"x", "p"},
+                                    {"&f", "gf", "g", "Jk"});
+    g << "if (" << call << ") return 1;\n";
+    g.comment("Evaluate the gradient of the Lagrangian");
+    g << g.copy("gf", nx_, "gLag") << "\n";
+    g << g.mv("Jk", Asp_, "lam_g", "gLag", true) << "\n";
+    g << g.axpy(nx_, "1.", "lam_x", "gLag") << "\n";
+    g << "pr_inf = casadi_fmax(" << g.max_viol(nx_, "x", "lbx", "ubx") << ", "
+      << g.max_viol(ng_, "g", "lbg", "ubg") << ");\n";
+    g << "du_inf = " << g.norm_inf(nx_, "gLag") << ";\n";
+    g << "dx_norminf = " << g.norm_inf(nx_, "dx") << ";\n";
+    if (print_iteration_) {
+      g << "if (iter % 10 == 0) "
+        << g.printf("%4s %14s %9s %9s %9s %7s %2s\\n",
+                    {"\"iter\"", "\"objective\"", "\"inf_pr\"", "\"inf_du\"", "\"||d||\"",
+                     "\"lg(rg)\"", "\"ls\""}) << "\n";
+      g << g.printf("%4d %14.6e %9.2e %9.2e %9.2e ",
+                    {"(int)iter", "f", "pr_inf", "du_inf", "dx_norminf"}) << "\n";
+      g << "if (reg>0) {\n"
+        << g.printf("%7.2f ", "log10(reg)") << "\n"
+        << "} else {\n"
+        << g.printf("%7s ", "\"-\"") << "\n"
+        << "}\n";
+      g << g.printf("%2d", "(int)ls_iter") << "\n";
+      g << "if (!ls_success) " << g.printf("F") << "\n";
+      g << g.printf("\\n") << "\n";
+    }
+    g.comment("Checking convergence criteria");
+    g << "if (iter>=" << min_iter_ << " && pr_inf<" << g.constant(tol_pr_)
+      << " && du_inf<" << g.constant(tol_du_) << ") {\n";
+    if (print_iteration_) {
+      g << g.printf("MESSAGE(sqpmethod): Convergence achieved after %d iterations\\n",
+                    "(int)iter") << "\n";
+    }
+    if (error_on_fail_) g << "success = 1;\n";
+    g << "break;\n"
+      << "}\n";
+    g << "if (iter>=" << max_iter_ << ") {\n";
+    if (print_iteration_) {
+      g << g.printf("MESSAGE(sqpmethod): Maximum number of iterations reached.\\n") << "\n";
+    }
+    g << "break;\n"
+      << "}\n";
+    g << "if (iter>=1 && iter>=" << min_iter_ << " && dx_norminf<=" << g.constant(min_step_size_)
+      << ") {\n";
+    if (print_iteration_) {
+      g << g.printf("MESSAGE(sqpmethod): Search direction becomes too small without "
+                    "convergence criteria being met.\\n") << "\n";
+    }
+    g << "break;\n"
+      << "}\n";
+    if (exact_hessian_) {
+      g.comment("Update/reset exact Hessian");
+      call = codegen_calc(g, get_function("nlp_hess_l"), {"x", "p", "&one", "lam_g"}, {"Bk"});
+      g << "if (" << call << ") return 1;\n";
+      if (regularize_) {
+        g.comment("Determing regularization parameter with Gershgorin theorem");
+        g << "reg = casadi_fmin(0, -casadi_lb_eig(" << g.sparsity(Hsp_) << ", Bk));\n";
+        g << "if (reg>0) casadi_regularize(" << g.sparsity(Hsp_) << ", Bk, reg);\n";
+      }
+    } else {
+      g.comment("Initialize or update BFGS");
+      g << "if (iter==0) {\n"
+        << g.fill("Bk", Hsp_.nnz(), "1.") << "\n"
+        << "casadi_bfgs_reset(" << g.sparsity(Hsp_) << ", Bk);\n"
+        << "} else {\n"
+        << "if (iter % " << lbfgs_memory_ << "==0) "
+        << "casadi_bfgs_reset(" << g.sparsity(Hsp_) << ", Bk);\n"
+        << "casadi_bfgs(" << g.sparsity(Hsp_) << ", Bk, dx, gLag, gLag_old, w1);\n"
+        << "}\n";
+    }
+    g.comment("Formulate the QP");
+    g << g.copy("lbx", nx_, "qp_LBX") << "\n"
+      << g.axpy(nx_, "-1.", "x", "qp_LBX") << "\n"
+      << g.copy("ubx", nx_, "qp_UBX") << "\n"
+      << g.axpy(nx_, "-1.", "x", "qp_UBX") << "\n"
+      << g.copy("lbg", ng_, "qp_LBA") << "\n"
+      << g.axpy(ng_, "-1.", "g", "qp_LBA") << "\n"
+      << g.copy("ubg", ng_, "qp_UBA") << "\n"
+      << g.axpy(ng_, "-1.", "g", "qp_UBA") << "\n";
+    g << "iter++;\n";
+    g.comment("Solve the QP");
+    std::vector<std::string> qp_arg(qpsol_.n_in(), "0"), qp_res(qpsol_.n_out(), "0");
+    qp_arg[CONIC_H] = "Bk";
+    qp_arg[CONIC_G] = "gf";
+    qp_arg[CONIC_X0] = "dx";
+    qp_arg[CONIC_LBX] = "qp_LBX";
+    qp_arg[CONIC_UBX] = "qp_UBX";
+    qp_arg[CONIC_A] = "Jk";
+    qp_arg[CONIC_LBA] = "qp_LBA";
+    qp_arg[CONIC_UBA] = "qp_UBA";
+    qp_res[CONIC_X] = "dx";
+    qp_res[CONIC_LAM_X] = "qp_DUAL_X";
+    qp_res[CONIC_LAM_A] = "qp_DUAL_A";
+    call = codegen_calc(g, qpsol_, qp_arg, qp_res);
+    g << call << ";\n";
+    g.comment("Detecting indefiniteness");
+    if (print_iteration_) {
+      g << "gain = " << g.bilin("Bk", Hsp_, "dx", "dx") << ";\n";
+      g << "if (gain<0) "
+        << g.printf("WARNING(sqpmethod): Indefinite Hessian detected\\n") << "\n";
+    }
+    g.comment("Calculate penalty parameter of merit function");
+    g << "sigma = casadi_fmax(sigma, 1.01*" << g.norm_inf(nx_, "qp_DUAL_X") << ");\n";
+    g << "sigma = casadi_fmax(sigma, 1.01*" << g.norm_inf(ng_, "qp_DUAL_A") << ");\n";
+    g.comment("Calculate L1-merit function in the actual iterate");
+    g << "l1_infeas = casadi_fmax(" << g.max_viol(nx_, "x", "lbx", "ubx") << ", "
+      << g.max_viol(ng_, "g", "lbg", "ubg") << ");\n";
+    g << "L1dir = " << g.dot(nx_, "dx", "gf") << " - sigma*l1_infeas;\n";
+    g << "L1merit = f + sigma*l1_infeas;\n";
+    g << "merit_mem[merit_ind] = L1merit;\n";
+    g << "merit_ind = (merit_ind+1) % " << merit_memsize_ << ";\n";
+    g << "meritmax = merit_mem[0];\n";
+    g << "for (i=1; i<" << merit_memsize_ << " && i<iter; ++i) {\n"
+      << "if (meritmax<merit_mem[i]) meritmax = merit_mem[i];\n"
+      << "}\n";
+    g << "t = 1.;\n";
+    g << "ls_iter = 0;\n";
+    if (print_iteration_) g << "ls_success = 1;\n";
+    if (max_iter_ls_>0) {
+      g.comment("Line-search");
+      g << "while (1) {\n";
+      g << "ls_iter++;\n";
+      g << g.copy("x", nx_, "x_cand") << "\n";
+      g << g.axpy(nx_, "t", "dx", "x_cand") << "\n";
+      call = codegen_calc(g, get_function("nlp_fg"), {"x_cand", "p"}, {"&fk_cand", "g_cand"});
+      g << "if (" << call << ") {\n"
+        << "t = " << g.constant(beta_) << "*t;\n"
+        << "continue;\n"
+        << "}\n";
+      g << "l1_infeas = casadi_fmax(" << g.max_viol(nx_, "x_cand", "lbx", "ubx") << ", "
+        << g.max_viol(ng_, "g_cand", "lbg", "ubg") << ");\n";
+      g << "L1merit_cand = fk_cand + sigma*l1_infeas;\n";
+      g << "if (L1merit_cand<=meritmax + t*" << g.constant(c1_) << "*L1dir) break;\n";
+      g << "if (ls_iter==" << max_iter_ls_ << ") {\n";
+      if (print_iteration_) g << "ls_success = 0;\n";
+      g << "break;\n"
+        << "}\n";
+      g << "t = " << g.constant(beta_) << "*t;\n";
+      g << "}\n";
+      g.comment("Candidate accepted, update dual variables");
+      g << g.scal(ng_, "1-t", "lam_g") << "\n"
+        << g.axpy(ng_, "t", "qp_DUAL_A", "lam_g") << "\n"
+        << g.scal(nx_, "1-t", "lam_x") << "\n"
+        << g.axpy(nx_, "t", "qp_DUAL_X", "lam_x") << "\n"
+        << g.scal(nx_, "t", "dx") << "\n";
+    } else {
+      g.comment("Full step");
+      g << g.copy("qp_DUAL_A", ng_, "lam_g") << "\n"
+        << g.copy("qp_DUAL_X", nx_, "lam_x") << "\n";
+    }
+    g.comment("Take step");
+    g << g.axpy(nx_, "1.", "dx", "x") << "\n";
+    if (!exact_hessian_) {
+      g.comment("Gradient of the Lagrangian with the old x but new lam_g (for BFGS)");
+      g << g.copy("gf", nx_, "gLag_old") << "\n"
+        << g.mv("Jk", Asp_, "lam_g", "gLag_old", true) << "\n"
+        << g.axpy(nx_, "1.", "lam_x", "gLag_old") << "\n";
+    }
+    g << "}\n";
+
+    // Calculate multipliers
+    if (calc_f_ || calc_g_ || calc_lam_x_ || calc_lam_p_) {
+      g.comment("Calculate multipliers");
+      call = codegen_calc(g, get_function("nlp_grad"), {"x", "p", "&one", "lam_g"},
+                          {calc_f_ ? "&f" : "0", calc_g_ ? "g" : "0",
+                           calc_lam_x_ ? "lam_x" : "0", calc_lam_p_ ? "lam_p" : "0"});
+      g << call << ";\n";
+      if (calc_lam_x_) g << g.scal(nx_, "-1.", "lam_x") << "\n";
+      if (calc_lam_p_) g << g.scal(np_, "-1.", "lam_p") << "\n";
+    }
+    // Make sure that an optimal solution is consistant with bounds
+    if (bound_consistency_) {
+      g << "casadi_bound_consistency(" << nx_ << ", x, lam_x, lbx, ubx, HUGE_VAL);\n";
+      g << "casadi_bound_consistency(" << ng_ << ", g, lam_g, lbg, ubg, HUGE_VAL);\n";
+    }
+    // Get optimal solution
+    g.comment("Get optimal solution");
+    g << g.copy("x", nx_, "res[" + str(NLPSOL_X) + "]") << "\n";
+    g << g.copy("&f", 1, "res[" + str(NLPSOL_F) + "]") << "\n";
+    g << g.copy("g", ng_, "res[" + str(NLPSOL_G) + "]") << "\n";
+    g << g.copy("lam_x", nx_, "res[" + str(NLPSOL_LAM_X) + "]") << "\n";
+    g << g.copy("lam_g", ng_, "res[" + str(NLPSOL_LAM_G) + "]") << "\n";
+    g << g.copy("lam_p", np_, "res[" + str(NLPSOL_LAM_P) + "]") << "\n";
+    if (error_on_fail_) g << "if (!success) return 1;\n";
+  }
+
   Dict Sqpmethod::get_stats(void* mem) const {
     Dict stats = Nlpsol::get_stats(mem);
     auto m = static_cast<SqpmethodMemory*>(mem);
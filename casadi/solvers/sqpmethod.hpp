@@ -179,6 +179,22 @@ namespace casadi {
                           const double* A, const double* lbA, const double* ubA,
                           double* x_opt, double* lambda_x_opt, double* lambda_A_opt) const;
 
+    /** \brief Is code generation supported? */
+    bool has_codegen() const override { return true;}
+
+    /** \brief Generate code for the declarations of the C function */
+    void codegen_declarations(CodeGenerator& g) const override;
+
+    /** \brief Generate code for the function body */
+    void codegen_body(CodeGenerator& g) const override;
+
+    /** \brief Generate code for passing arguments to a function
+     * Returns the call, with temporary work vectors following the persistent ones
+     */
+    std::string codegen_calc(CodeGenerator& g, const Function& f,
+                             const std::vector<std::string>& arg,
+                             const std::vector<std::string>& res) const;
+
     /// A documentation string
     static const std::string meta_doc;
 
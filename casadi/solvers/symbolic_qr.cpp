@@ -57,7 +57,7 @@ namespace casadi {
   }
 
   Options SymbolicQr::options_
-  = {{&FunctionInternal::options_},
+  = {{&LinsolInternal::options_},
     {{"fopts",
       {OT_DICT,
        "Options to be passed to generated function objects"}}
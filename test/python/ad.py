@@ -329,6 +329,27 @@ class ADtests(casadiTestCase):
             J = self.jacobians[inputtype][outputtype](*n)
             self.checkarray(array(J_out),J,"jacobian")
 
+  def test_bicoloring(self):
+    # Banded Jacobian with dense rows and dense columns
+    n = 40
+    for X in [SX, MX]:
+      x = X.sym("x",n)
+      g = vertcat(x[:-2]*x[2:]+sin(x[1:-1])*x[0]*x[-1],dot(x,x),sum1(sin(x)))
+      x0 = DM(range(n))/n
+      J_ref = Function("J_ref",[x],[jacobian(g,x)])(x0)
+      for bi in [False, True]:
+        f = Function("f",[x],[g],{"bicoloring":bi})
+        J = f.jacobian()
+        self.checkarray(J(x0,0),J_ref)
+        stats = J.stats()
+        if bi:
+          self.assertTrue(stats["coloring_n_fwd"]>0)
+          self.assertTrue(stats["coloring_n_adj"]>0)
+          self.assertTrue(stats["coloring_n_fwd"]+stats["coloring_n_adj"]<n/2)
+          self.assertFalse("coloring_lower_bound" in stats)
+        Jf = Function("Jf",[x],[jacobian(g,x,{"bicoloring":bi})])
+        self.checkarray(Jf(x0),J_ref)
+
   def test_jacsparsity(self):
     n=array([1.2,2.3,7,4.6])
     for inputshape in ["column","row","matrix"]:
@@ -971,5 +971,14 @@ class ConicTests(casadiTestCase):
 
       self.assertTrue(solver.stats()["success"])
 
+  @requires_conic("qrqp")
+  def test_qrqp_codegen(self):
+    x = SX.sym("x",3)
+    f = sumsqr(x-DM([1,2,3]))+x[0]*x[1]
+    g = vertcat(x[0]+x[1]+x[2],x[0]-x[2])
+    solver = qpsol("solver","qrqp",{"x":x,"f":f,"g":g},{"print_header":False})
+    inputs = {"lbx":DM([-inf,0.5,-inf]),"ubx":DM([inf,inf,2]),"lbg":DM([-inf,-1]),"ubg":DM([4,1])}
+    self.check_codegen(solver,inputs=inputs)
+
 if __name__ == '__main__':
     unittest.main()
@@ -870,6 +870,50 @@ class Functiontests(casadiTestCase):
   #   [v] = f([])
   #   self.checkarray(2.37683, v, digits=4)
 
+  @requiresPlugin(Importer,"shell")
+  def test_jit_cache(self):
+    import tempfile
+    folder = tempfile.mkdtemp()
+    x = SX.sym("x",3)
+    opts = {"jit":True,"compiler":"shell","jit_cache":True,"jit_cache_folder":folder}
+    hits = []
+    for i in range(2):
+      f = Function("f",[x],[sin(x)*dot(x,x)],opts)
+      self.checkarray(f(DM([1,2,3])),sin(DM([1,2,3]))*14)
+      hits.append(f.stats()["jit_cache_hit"])
+    self.assertEqual(hits,[False,True])
+
+  @requiresPlugin(Importer,"shell")
+  def test_jit_background(self):
+    import time
+    x = SX.sym("x",3)
+    f = Function("f",[x],[sin(x)*dot(x,x)],{"jit":True,"compiler":"shell","jit_background":True})
+    ref = sin(DM([1,2,3]))*14
+    self.checkarray(f(DM([1,2,3])),ref)
+    for i in range(200):
+      if f.stats()["jit_ready"]: break
+      time.sleep(0.05)
+    self.assertTrue(f.stats()["jit_ready"])
+    self.checkarray(f(DM([1,2,3])),ref)
+
+  @requiresPlugin(Importer,"shell")
+  def test_jit_split(self):
+    x = SX.sym("x",3)
+    g1 = Function("g1",[x],[sin(x)*dot(x,x)])
+    g2 = Function("g2",[x],[cos(x)+x])
+    g3 = Function("g3",[x],[exp(-x)*x[0]])
+    y = MX.sym("y",3)
+    f = Function("f",[y],[g3(g2(g1(y)))+g1(y)])
+    ref = f(DM([1,2,3]))
+    fj = Function("f",[y],[g3(g2(g1(y)))+g1(y)],{"jit":True,"compiler":"shell","jit_split":3})
+    self.checkarray(fj(DM([1,2,3])),ref)
+    # A single large SX function is divided into chunks
+    e = x
+    for i in range(300): e = sin(0.5*e+vertcat(e[1:],e[0]))
+    f = Function("f",[x],[e])
+    fj = Function("f",[x],[e],{"jit":True,"compiler":"shell","jit_split":3})
+    self.checkarray(fj(DM([1,2,3])),f(DM([1,2,3])))
+
   def test_depends_on(self):
     x = SX.sym("x")
     y = x**2
@@ -1678,6 +1722,78 @@ class Functiontests(casadiTestCase):
     self.check_codegen(f,inputs=[np.random.random((3,3))])
     self.check_codegen(f,inputs=[np.random.random((3,3))], opts={"avoid_stack": True})
 
+  def test_codegen_reroll(self):
+    x = SX.sym("x",2)
+    u = SX.sym("u")
+    F = Function('F',[x,u],[vertcat(x[1]*sin(x[0])+u,x[0]-0.1*x[1]**2)])
+    X0 = MX.sym("x0",2)
+    U = MX.sym("U",1,50)
+    f = Function('f',[X0,U],[F.mapaccum(50)(X0,U)]).expand()
+    np.random.seed(0)
+    self.check_codegen(f,inputs=[np.random.random(2),np.random.random((1,50))], opts={"reroll": True})
+    g = CodeGenerator("f_reroll.c",{"reroll": True})
+    g.add(f)
+    self.assertTrue("for (i=0; i<" in g.dump())
+
+
+  def test_codegen_openmp(self):
+    x = SX.sym("x",3)
+    g = Function('g',[x],[sin(x)*dot(x,x)])
+    h = Function('h',[x],[cos(x)+x])
+    X = MX.sym("X",3,4)
+    r = [h(g(c)) for c in horzsplit(X)]
+    f = Function('f',[X],[sum(r),horzcat(*r)])
+    np.random.seed(0)
+    self.check_codegen(f,inputs=[np.random.random((3,4))], opts={"openmp": True})
+    cg = CodeGenerator("f_openmp.c",{"openmp": True})
+    cg.add(f)
+    self.assertTrue("#pragma omp section" in cg.dump())
+
+  def test_codegen_mixed_precision(self):
+    x = SX.sym("x",4)
+    e = sum1(sin(x)*x+0.5*x**2)
+    f = Function('f',[x],[vertcat(e,exp(x[0])/(2+x[1]**2))])
+    self.check_codegen(f,inputs=[DM([0.3,-0.7,0.9,0.1])], opts={"mixed_precision": 1e-12})
+    f.generate("f_mixed_precision.c",{"mixed_precision": 1e-3})
+    with open("f_mixed_precision.c") as src:
+      code = src.read()
+    self.assertTrue("float f" in code)
+    bound = float(code.split("Forward error bound, output 0: ")[1].split(" ")[0])
+    self.assertTrue(bound<=1e-3)
+
+  def test_codegen_static_memory(self):
+    x = SX.sym("x",3)
+    g = Function('g',[x],[sin(x)*dot(x,x)])
+    X = MX.sym("X",3,2)
+    r = g(g(X[:,0])+X[:,1])
+    f = Function('f',[X],[r,sumsqr(r)])
+    np.random.seed(0)
+    self.check_codegen(f,inputs=[np.random.random((3,2))], opts={"static_memory": True})
+    f.generate("f_static_memory.c",{"static_memory": True})
+    with open("f_static_memory_memory.txt") as report:
+      self.assertTrue("Worst-case stack" in report.read())
+    with self.assertInException("cannot be combined"):
+      f.generate("f_static_memory.c",{"static_memory": True, "with_mem": True})
+
+  def test_batch(self):
+    x = SX.sym("x",2)
+    p = SX.sym("p")
+    f = Function('f',[x,p],[vertcat(sin(x[0])*p,x[1]*x[0]+1),p**2])
+    np.random.seed(0)
+    X = np.random.random((5,2))
+    P = np.random.random((5,1))
+    fb = f.batch(5)
+    self.assertEqual(fb.size_in(0),(5,2))
+    [Y,Z] = fb(X,P)
+    for k in range(5):
+      [y,z] = f(X[k,:],P[k])
+      self.checkarray(Y[k,:].T,y)
+      self.checkarray(Z[k],z)
+    self.check_codegen(fb,inputs=[X,P])
+    xm = MX.sym("x",2)
+    pm = MX.sym("p")
+    fm = Function('fm',[xm,pm],f(xm,pm))
+    self.check_codegen(fm.batch(5),inputs=[X,P])
 
   def test_sx_serialize(self):
     x = SX.sym("x")
@@ -45,6 +45,7 @@ except:
   pass
 
 solvers.append(("fast_newton",{},("codegen")))
+solvers.append(("newton_krylov",{},[]))
 
 print(solvers)
 
@@ -304,5 +305,45 @@ class ImplicitFunctiontests(casadiTestCase):
       with self.assertInException("process"):
         solver(x0=0)
 
+  def test_jacobian_update(self):
+    self.message("newton with modified Jacobian and Broyden updates")
+    n = 50
+    u = SX.sym("u",n)
+    lam = SX.sym("lam")
+    h = 1./(n+1)
+    uu = vertcat(0,u,0)
+    g = Function("g",[u,lam],[(uu[:-2]-2*u+uu[2:])/h**2+lam*exp(u)])
+    ref = rootfinder("ref","newton",g)
+    ref_sol = ref(0,3)
+    for update in ["modified","broyden"]:
+      solver = rootfinder("solver","newton",g,{"jacobian_update":update})
+      self.checkarray(solver(0,3),ref_sol,digits=10)
+      stats = solver.stats()
+      self.assertTrue(stats["success"])
+      self.assertTrue(stats["jac_count"]<ref.stats()["jac_count"])
+      self.checkfunction(solver,ref,inputs=[0,3],digits=8)
+
+  def test_newton_krylov(self):
+    self.message("matrix-free Newton-Krylov")
+    N = 10
+    h = 1./(N+1)
+    u = SX.sym("u",N,N)
+    lam = SX.sym("lam")
+    uu = horzcat(DM.zeros(N+2,1),vertcat(DM.zeros(1,N),u,DM.zeros(1,N)),DM.zeros(N+2,1))
+    lap = (uu[:-2,1:-1]+uu[2:,1:-1]+uu[1:-1,:-2]+uu[1:-1,2:]-4*u)/h**2
+    g = Function("g",[vec(u),lam],[vec(lap+lam*exp(u))])
+    v = SX.sym("v",N*N)
+    prec = Function("prec",[vec(u),lam,v],[v/(-4/h**2+lam*exp(vec(u)))])
+    ref = rootfinder("ref","newton",g)
+    for opts in [{},{"preconditioner":"ilu"},{"krylov_method":"bicgstab"},
+                 {"krylov_method":"bicgstab","preconditioner":"ilu"},
+                 {"preconditioner_function":prec,"gmres_restart":10}]:
+      solver = rootfinder("solver","newton_krylov",g,opts)
+      self.checkarray(solver(0,5),ref(0,5),digits=10)
+      stats = solver.stats()
+      self.assertTrue(stats["success"])
+      self.assertTrue(stats["krylov_iter_count"]>=stats["iter_count"]-1)
+      self.checkfunction(solver,ref,inputs=[0,5],digits=8)
+
 if __name__ == '__main__':
     unittest.main()
@@ -1013,6 +1013,258 @@ class Integrationtests(casadiTestCase):
       self.assertEqual(len(r),k+1)
 
 
+  def test_erk(self):
+    self.message("adaptive-step explicit Runge-Kutta")
+    x = SX.sym("x",2)
+    p = SX.sym("p")
+    dae = {"x":x,"p":p,"ode":vertcat(x[1],-p*sin(x[0])),"quad":x[1]**2}
+    grid = [0,0.5,1.3,2,5]
+    ref = integrator("ref","rk",dae,{"grid":grid,"number_of_finite_elements":20000})
+    ref_out = ref(x0=[0.3,0.1],p=2)
+    x0 = MX.sym("x0",2)
+    pp = MX.sym("p")
+    sol = integrator("ref","rk",dae,{"tf":5,"number_of_finite_elements":20000})(x0=x0,p=pp)
+    g_ref = Function("g",[x0,pp],[gradient(dot(sol["xf"],DM([1,2]))+sol["qf"],vertcat(x0,pp))])
+    for scheme in ["dopri5","bs32"]:
+      opts = {"scheme":scheme,"abstol":1e-10,"reltol":1e-10}
+      intg = integrator("intg","erk",dae,dict(opts,grid=grid))
+      intg_out = intg(x0=[0.3,0.1],p=2)
+      self.checkarray(intg_out["xf"],ref_out["xf"],digits=7)
+      self.checkarray(intg_out["qf"],ref_out["qf"],digits=7)
+      self.assertTrue(intg.stats()["nfevals"]<10000)
+
+      # Forward and adjoint sensitivities
+      sol = integrator("intg","erk",dae,dict(opts,tf=5))(x0=x0,p=pp)
+      obj = dot(sol["xf"],DM([1,2]))+sol["qf"]
+      g = Function("g",[x0,pp],[gradient(obj,vertcat(x0,pp)),jtimes(obj,vertcat(x0,pp),DM.eye(3))])
+      g_out = g([0.3,0.1],2)
+      self.checkarray(g_out[0],g_ref([0.3,0.1],2),digits=7)
+      self.checkarray(g_out[1].T,g_ref([0.3,0.1],2),digits=7)
+
+  def test_checkpoints(self):
+    self.message("binomial checkpointing of fixed step integrators")
+    # Van der Pol oscillator, the backward sweep depends on the recomputed states
+    x = SX.sym("x",2)
+    p = SX.sym("p")
+    dae = {"x":x,"p":p,"ode":vertcat(x[1],p*(1-x[0]**2)*x[1]-x[0]),"quad":x[0]**2+p*x[1]**2}
+    x0 = MX.sym("x0",2)
+    pp = MX.sym("p")
+    for Integrator in ["rk","collocation"]:
+      ref = None
+      for checkpoints in [0,1,2,3,7,60]:
+        intg = integrator("intg",Integrator,dae,{"tf":5,"number_of_finite_elements":50,"checkpoints":checkpoints})
+        sol = intg(x0=x0,p=pp)
+        obj = dot(sol["xf"],DM([1,2]))+sol["qf"]
+        f = Function("f",[x0,pp],[gradient(obj,vertcat(x0,pp)),jtimes(obj,vertcat(x0,pp),DM.eye(3))])
+        [adj,fwd] = f([1.5,0.2],1.3)
+        # Recomputation is not bit-exact, e.g. with the simplified Newton iterations
+        self.checkarray(adj,fwd.T,digits=8)
+        if ref is None: ref = adj
+        self.checkarray(adj,ref,digits=8)
+
+  def test_rosenbrock(self):
+    self.message("Rosenbrock-W integrator for stiff ODEs")
+    x = SX.sym("x",2)
+    p = SX.sym("p")
+    t = SX.sym("t")
+    dae = {"x":x,"p":p,"t":t,"ode":vertcat(x[1],p*(1-x[0]**2)*x[1]-x[0]+sin(3*t)),"quad":x[0]**2}
+    grid = [0,0.5,1.3,2]
+    ref = integrator("ref","erk",dae,{"grid":grid,"abstol":1e-12,"reltol":1e-12,"max_num_steps":100000})
+    ref_out = ref(x0=[2,0],p=100)
+    x0 = MX.sym("x0",2)
+    pp = MX.sym("p")
+    sol = integrator("ref","erk",dae,{"tf":2,"abstol":1e-12,"reltol":1e-12,"max_num_steps":100000})(x0=x0,p=pp)
+    g_ref = Function("g",[x0,pp],[gradient(dot(sol["xf"],DM([1,2]))+sol["qf"],vertcat(x0,pp))])
+    for opts in [{}, {"linear_solver":"csparse"}, {"max_jacobian_age":1}]:
+      opts = dict(opts,abstol=1e-9,reltol=1e-9)
+      intg = integrator("intg","rosenbrock",dae,dict(opts,grid=grid))
+      intg_out = intg(x0=[2,0],p=100)
+      self.checkarray(intg_out["xf"],ref_out["xf"],digits=6)
+      self.checkarray(intg_out["qf"],ref_out["qf"],digits=6)
+      self.assertTrue(intg.stats()["nfevals"]<ref.stats()["nfevals"])
+
+      # Forward and adjoint sensitivities
+      sol = integrator("intg","rosenbrock",dae,dict(opts,tf=2))(x0=x0,p=pp)
+      obj = dot(sol["xf"],DM([1,2]))+sol["qf"]
+      g = Function("g",[x0,pp],[gradient(obj,vertcat(x0,pp)),jtimes(obj,vertcat(x0,pp),DM.eye(3))])
+      g_out = g([2,0],100)
+      self.checkarray(g_out[0],g_ref([2,0],100),digits=5)
+      self.checkarray(g_out[1].T,g_ref([2,0],100),digits=5)
+
+    # Code generation, forward problem
+    intg = integrator("intg","rosenbrock",dae,{"grid":grid,"output_t0":True,"max_jacobian_age":4})
+    self.check_codegen(intg,inputs={"x0":[2,0],"p":100})
+
+    # Adjoint sensitivities of an autonomous system, without a time input
+    dae = {"x":x,"p":p,"ode":vertcat(x[1],p*(1-x[0]**2)*x[1]-x[0]),"quad":x[0]**2}
+    g = []
+    for Integrator in ["cvodes","rosenbrock"]:
+      sol = integrator("intg",Integrator,dae,{"tf":2,"abstol":1e-10,"reltol":1e-10})(x0=x0,p=pp)
+      obj = dot(sol["xf"],DM([1,2]))+sol["qf"]
+      g.append(Function("g",[x0,pp],[gradient(obj,vertcat(x0,pp))]))
+    self.checkarray(g[1]([2,0],1.3),g[0]([2,0],1.3),digits=5)
+
+    # Code generation with a symmetric iteration matrix, factorized with ldl
+    dae = {"x":x,"p":p,"t":t,"ode":mtimes(DM([[-3,1],[1,-2]]),x)*p+sin(t)}
+    intg = integrator("intg","rosenbrock",dae,{"grid":grid,"linear_solver":"ldl"})
+    ref = integrator("ref","rosenbrock",dae,{"grid":grid})
+    self.checkarray(intg(x0=[1,2],p=3)["xf"],ref(x0=[1,2],p=3)["xf"],digits=10)
+    self.check_codegen(intg,inputs={"x0":[1,2],"p":3})
+
+  def test_batch(self):
+    self.message("integration of several trajectories as a batch")
+    x = SX.sym("x",2)
+    p = SX.sym("p")
+    dae = {"x":x,"p":p,"ode":vertcat(x[1],p*(1-x[0]**2)*x[1]-x[0]),"quad":x[0]**2}
+    numpy.random.seed(0)
+    X0 = numpy.random.random((7,2))
+    P = 1+numpy.random.random((7,1))
+    for Integrator, digits in [("rk",12),("collocation",10),("cvodes",6),("erk",4)]:
+      for batch_group in [0,3]:
+        opts = {"tf":2,"batch_group":batch_group}
+        if Integrator=="cvodes": opts = dict(opts,abstol=1e-10,reltol=1e-10)
+        intg = integrator("intg",Integrator,dae,opts)
+        intg_batch = intg.batch(7)
+        self.assertEqual(intg_batch.size_in("x0"),(7,2))
+        sol = intg_batch(x0=X0,p=P)
+        for k in range(7):
+          ref = intg(x0=X0[k,:],p=P[k])
+          self.checkarray(sol["xf"][k,:].T,ref["xf"],digits=digits)
+          self.checkarray(sol["qf"][k],ref["qf"],digits=digits)
+
+        # Sensitivities
+        x0 = MX.sym("x0",7,2)
+        pp = MX.sym("p",7)
+        sol = intg_batch(x0=x0,p=pp)
+        g = Function("g",[x0,pp],[gradient(sum1(sum2(sol["xf"]))+sum1(sol["qf"]),pp)])
+        x0 = MX.sym("x0",2)
+        pp = MX.sym("p")
+        sol = intg(x0=x0,p=pp)
+        g_ref = Function("g_ref",[x0,pp],[gradient(sum1(sol["xf"])+sol["qf"],pp)])
+        g_out = g(X0,P)
+        for k in range(7):
+          self.checkarray(g_out[k],g_ref(X0[k,:],P[k]),digits=digits)
+
+  def test_simplified_newton(self):
+    self.message("collocation with simplified Newton iterations")
+    x = SX.sym("x",2)
+    z = SX.sym("z")
+    p = SX.sym("p")
+    ode = {"x":x,"p":p,"ode":vertcat(x[1],p*(1-x[0]**2)*x[1]-x[0]),"quad":x[0]**2}
+    dae = {"x":x,"z":z,"p":p,"ode":vertcat(x[1],z-x[0]),"alg":z+0.1*z**3-p*(1-x[0]**2)*x[1],
+           "quad":x[0]**2}
+    for prob in [ode,dae]:
+      for scheme in ["radau","legendre"]:
+        for degree in [1,3,4]:
+          opts = {"tf":2,"collocation_scheme":scheme,"interpolation_order":degree,
+                  "number_of_finite_elements":20}
+          ref = integrator("ref","collocation",prob,opts)
+          intg = integrator("intg","collocation",prob,dict(opts,simplified_newton=True))
+          sol = intg(x0=[0.3,0.1],p=1.5)
+          sol_ref = ref(x0=[0.3,0.1],p=1.5)
+          self.checkarray(sol["xf"],sol_ref["xf"],digits=10)
+          self.checkarray(sol["qf"],sol_ref["qf"],digits=10)
+          stats = intg.stats()
+          self.assertTrue(stats["njevals"]>0)
+          self.assertTrue(stats["nniter"]>=stats["njevals"])
+
+          # Sensitivities
+          x0 = MX.sym("x0",2)
+          pp = MX.sym("p")
+          for f in [intg,ref]:
+            sol = f(x0=x0,p=pp)
+            obj = sum1(sol["xf"])+sol["qf"]
+            g = Function("g",[x0,pp],[gradient(obj,vertcat(x0,pp))])
+            if f is intg:
+              g_out = g([0.3,0.1],1.5)
+            else:
+              self.checkarray(g_out,g([0.3,0.1],1.5),digits=8)
+
+  def test_parareal(self):
+    self.message("parallel-in-time integration")
+    t = SX.sym("t")
+    x = SX.sym("x",2)
+    z = SX.sym("z")
+    p = SX.sym("p")
+    ode = {"t":t,"x":x,"p":p,"ode":vertcat(x[1],p*(1-x[0]**2)*x[1]-x[0]+0.1*sin(t)),
+           "quad":x[0]**2}
+    dae = {"x":x,"z":z,"p":p,"ode":vertcat(x[1],z-x[0]),"alg":z+0.1*z**3-p*(1-x[0]**2)*x[1],
+           "quad":x[0]**2}
+    tol = {"abstol":1e-12,"reltol":1e-12}
+    for prob, fine in [(ode,"cvodes"),(dae,"idas")]:
+      for nslices in [1,4,16]:
+        opts = {"fine":fine,"fine_options":tol,"number_of_slices":nslices,"tol":1e-10}
+        ref = integrator("ref",fine,prob,dict(tol,grid=[0,0.7,2,4.1,6]))
+        intg = integrator("intg","parareal",prob,dict(opts,grid=[0,0.7,2,4.1,6]))
+        sol = intg(x0=[0.3,0.1],p=1.5)
+        sol_ref = ref(x0=[0.3,0.1],p=1.5)
+        for f in ["xf","qf","zf"]:
+          self.checkarray(sol[f],sol_ref[f],digits=7)
+        self.assertTrue(intg.stats()["niter"]<=max(nslices,4))
+
+        # Sensitivities
+        x0 = MX.sym("x0",2)
+        pp = MX.sym("p")
+        for f in [integrator("intg","parareal",prob,dict(opts,tf=6)),
+                  integrator("ref",fine,prob,dict(tol,tf=6))]:
+          sol = f(x0=x0,p=pp)
+          obj = sol["xf"][0]+2*sol["xf"][1]+sol["qf"]
+          g = Function("g",[x0,pp],[gradient(obj,vertcat(x0,pp))])
+          if f.name()=="intg":
+            g_out = g([0.3,0.1],1.5)
+          else:
+            self.checkarray(g_out,g([0.3,0.1],1.5),digits=6)
+
+  def test_events(self):
+    self.message("event detection and dense output")
+    t = SX.sym("t")
+    x = SX.sym("x",2)
+    z = SX.sym("z")
+    p = SX.sym("p")
+    ode = {"x":x,"p":p,"ode":vertcat(x[1],-p*x[0]),"quad":x[0]}
+    dae = {"x":x,"z":z,"p":p,"ode":vertcat(x[1],-p*z),"alg":z-x[0],"quad":x[0]}
+    grid = [0,0.123,1,3.333,10]
+    tg = DM(grid[1:]).T
+    for plugin, prob, opts in [("rk",ode,{"number_of_finite_elements":100}),
+                               ("collocation",ode,{"number_of_finite_elements":100}),
+                               ("collocation",dae,{"number_of_finite_elements":100}),
+                               ("cvodes",ode,{"abstol":1e-10,"reltol":1e-10}),
+                               ("idas",dae,{"abstol":1e-10,"reltol":1e-10})]:
+      zz = SX.sym("z",prob["alg"].numel() if "alg" in prob else 0)
+      ev = Function("ev",[t,x,zz,p],[vertcat(x[0],x[1]-0.5,t-2)])
+      intg = integrator("intg",plugin,prob,dict(opts,grid=grid,event=ev))
+      sol = intg(x0=[1,0],p=1)
+      self.checkarray(sol["xf"],vertcat(cos(tg),-sin(tg)),digits=5)
+      self.checkarray(sol["qf"],sin(tg),digits=5)
+      stats = intg.stats()
+      t_ref = sorted([pi/2,3*pi/2,5*pi/2,7*pi/6,11*pi/6,19*pi/6,2])
+      self.checkarray(DM(stats["event_time"]),DM(t_ref),digits=5)
+      for tk, ik, xk in zip(stats["event_time"],stats["event_index"],stats["event_x"]):
+        self.checkarray(DM(xk),DM([cos(tk),-sin(tk)]),digits=5)
+        self.checkarray(ev(tk,xk,cos(tk)*DM.ones(zz.numel()),1)[ik],0,digits=5)
+
+  def test_staggered_sensitivities(self):
+    self.message("forward sensitivities sharing the iteration matrix")
+    x = SX.sym("x",2)
+    z = SX.sym("z")
+    p = SX.sym("p")
+    dae = {"x":x,"z":z,"p":p,"ode":vertcat(x[1],z-x[0]),"alg":z+0.1*z**3-p*(1-x[0]**2)*x[1],
+           "quad":x[0]**2}
+    opts = {"tf":3,"number_of_finite_elements":30}
+    x0 = MX.sym("x0",2)
+    pp = MX.sym("p")
+    v = vertcat(x0,pp)
+    for f in [integrator("intg","collocation",dae,dict(opts,simplified_newton=True)),
+              integrator("ref","collocation",dae,opts)]:
+      sol = f(x0=x0,p=pp)
+      obj = sol["xf"][0]+2*sol["xf"][1]+sol["qf"]+sol["zf"]
+      g = Function("g",[v],[jtimes(obj,v,DM.eye(3)),hessian(obj,v)[0]])
+      if f.name()=="intg":
+        g_out = g([0.3,0.1,1.5])
+      else:
+        for i, r in enumerate(g([0.3,0.1,1.5])):
+          self.checkarray(g_out[i],r,digits=9)
+
   @memory_heavy()
   def test_thread_safety(self):
     x = MX.sym('x')
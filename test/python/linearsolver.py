@@ -408,6 +408,62 @@ class LinearSolverTests(casadiTestCase):
 
       self.checkarray(mtimes(A,f_out),b)
 
+  def test_multi_rhs(self):
+    n = 12
+    numpy.random.seed(1)
+    A = DM(Sparsity.banded(n,2),numpy.random.random(Sparsity.banded(n,2).nnz()))+5*DM.eye(n)
+    B = DM(numpy.random.random((n,21)))
+    for Solver, options,req in lsolvers:
+      A0 = A.T+A if "symmetry" in req else A
+      solver = casadi.Linsol("solver", Solver, A0.sparsity(), options)
+      for tr in [False, True]:
+        X = solver.solve(A0, B, tr)
+        self.checkarray(mtimes(A0.T if tr else A0,X),B)
+
+      As = MX.sym("A",A0.sparsity())
+      Bs = MX.sym("B",B.sparsity())
+      f = Function("f",[As,Bs],[solve(As,Bs,Solver,options),solve(As.T,Bs,Solver,options)])
+      [X,Xt] = f(A0,B)
+      self.checkarray(mtimes(A0,X),B)
+      self.checkarray(mtimes(A0.T,Xt),B)
+      if Solver in ["qr","ldl"]:
+        self.check_codegen(f,inputs=[A0,B])
+
+  def test_block_ldl(self):
+    numpy.random.seed(1)
+    spb = Sparsity.banded(6,1)+Sparsity.rowcol([0],range(6),6,6)
+    sp = (spb+spb.T).block_expand(3)
+    A = DM(sp,numpy.random.random(sp.nnz()))
+    A = A+A.T+DM(Sparsity.diag(18),[5*(-1)**i for i in range(18)])
+    B = DM(numpy.random.random((18,2)))
+    solver = casadi.Linsol("solver", "ldl", A.sparsity())
+    X = solver.solve(A, B)
+    self.checkarray(mtimes(A,X),B)
+    self.assertEqual(solver.neig(A),sum(numpy.linalg.eigvalsh(numpy.array(A))<0))
+    As = MX.sym("A",A.sparsity())
+    Bs = MX.sym("B",B.sparsity())
+    f = Function("f",[As,Bs],[solve(As,Bs,"ldl")])
+    self.checkarray(mtimes(A,f(A,B)),B)
+    self.check_codegen(f,inputs=[A,B])
+
+  def test_reuse_factorization(self):
+    n = 10
+    numpy.random.seed(1)
+    A = DM(Sparsity.banded(n,2),numpy.random.random(Sparsity.banded(n,2).nnz()))+5*DM.eye(n)
+    B = DM(numpy.random.random((n,2)))
+    for Solver in ["qr","ldl","symbolicqr"]:
+      A0 = A.T+A if Solver=="ldl" else A
+      solver = casadi.Linsol("solver", Solver, A0.sparsity(), {"reuse_factorization":True})
+      solver.nfact(A0)
+      for eps in [1e-3, 1e-2, 1]:
+        A1 = A0+eps*DM(A0.sparsity(),1)
+        for tr in [False, True]:
+          X = solver.solve(A1, B, tr)
+          self.checkarray(mtimes(A1.T if tr else A1,X),B,digits=8)
+      stats = solver.stats()
+      self.assertTrue(stats["n_refine"]>0)
+      self.assertTrue(stats["n_nfact"]<6)
+
   def test_ma27(self):
       n = np.nan
 
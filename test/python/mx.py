@@ -1106,6 +1106,32 @@ class MXtests(casadiTestCase):
     self.assertEqual(D.shape[0],4)
     self.assertEqual(D.shape[1],7)
 
+  def test_block_mtimes(self):
+    sp = Sparsity.banded(4,1).block_expand(3)
+    spb = Sparsity.diag(4).block_expand(3)
+    a = MX.sym("a",sp)
+    b = MX.sym("b",spb)
+    c = MX.sym("c",sp)
+    f = Function("f",[a,b,c],[mtimes(a,b),mac(a,b,c)])
+    A = DM.rand(sp)
+    B = DM.rand(spb)
+    C = DM.rand(sp)
+    r = f(A,B,C)
+    self.checkarray(r[0],mtimes(A,B))
+    self.checkarray(r[1],C+mtimes(A,B))
+    self.checkfunction(f,f.expand(),inputs=[A,B,C])
+    self.check_codegen(f,inputs=[A,B,C])
+
+    sp = (Sparsity.banded(4,1)+Sparsity.rowcol([1],[3],4,4)).block_expand(3)
+    a = MX.sym("a",sp)
+    f = Function("f",[a],[a.T,mtimes(a.T,a)])
+    A = DM.rand(sp)
+    r = f(A)
+    self.checkarray(r[0],A.T)
+    self.checkarray(r[1],mtimes(A.T,A))
+    self.checkfunction(f,f.expand(),inputs=[A])
+    self.check_codegen(f,inputs=[A])
+
   def test_truth(self):
     self.message("Truth values")
     self.assertRaises(Exception, lambda : bool(MX.sym("x")))
@@ -1368,6 +1368,21 @@ class NLPtests(casadiTestCase):
       self.checkarray(solver_out["x"],DM([0]),digits=7)
       if "bonmin" not in str(Solver): self.checkarray(solver_out["lam_x"],DM([0]),digits=7)
 
+  @requires_nlpsol("sqpmethod")
+  @requires_conic("qrqp")
+  def test_sqpmethod_codegen(self):
+    x = SX.sym("x",2)
+    p = SX.sym("p")
+    f = (1-x[0])**2+p*(x[1]-x[0]**2)**2
+    g = x[0]+x[1]
+    nlp = {"x":x,"p":p,"f":f,"g":g}
+    for hessian_approximation in ["exact","limited-memory"]:
+      solver = nlpsol("solver","sqpmethod",nlp,{"qpsol":"qrqp","hessian_approximation":hessian_approximation,
+                                                "print_header":False,"print_iteration":False,
+                                                "qpsol_options":{"print_iter":False,"print_header":False}})
+      inputs = {"x0":DM([0.5,0.5]),"p":100,"lbx":DM([-inf,0.2]),"ubx":DM([inf,inf]),"lbg":1.5,"ubg":2}
+      self.check_codegen(solver,inputs=inputs)
+
 if __name__ == '__main__':
     unittest.main()
     print(solvers)
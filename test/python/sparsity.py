@@ -547,5 +547,62 @@ class Sparsitytests(casadiTestCase):
     self.checkarray(A,B)
     self.assertFalse(np.any(D[[e for e,k in zip(z,zres) if k==-1]]))    
 
+  def test_coloring_ordering(self):
+    # Banded Hessian with a few dense rows and columns
+    n = 50
+    sp = Sparsity.banded(n,2)
+    sp = sp + Sparsity.rowcol(range(n),[0,n-1],n,n)
+    sp = sp + sp.T
+
+    for f in [sp.largest_first, sp.smallest_last, sp.incidence_degree, sp.dynamic_largest_first]:
+      ord = f()
+      self.assertEqual(sorted(ord),list(range(n)))
+
+    self.assertEqual(sp.coloring_lower_bound(),n)
+    lb = sp.coloring_lower_bound(True)
+    self.assertEqual(lb,4)
+
+    ncol = dict()
+    for ordering in [0,1,2,3,4,-1]:
+      for coloring in [sp.star_coloring, sp.star_coloring2]:
+        D = coloring(ordering)
+        self.assertEqual(D.size1(),n)
+        self.assertEqual(D.nnz(),n)
+        self.assertTrue(D.size2()>=lb)
+        ncol[(coloring.__name__,ordering)] = D.size2()
+      D = sp.uni_coloring(sp,n,ordering)
+      # Columns with the same color may not share a row
+      S = mtimes(IM.ones(sp),IM.ones(D))
+      self.assertTrue(np.all(np.array(S)<=1))
+
+    for coloring in [sp.star_coloring, sp.star_coloring2]:
+      best = ncol[(coloring.__name__,-1)]
+      for ordering in range(5):
+        self.assertTrue(best<=ncol[(coloring.__name__,ordering)])
+
+  def test_coloring_stats(self):
+    x = SX.sym("x",20)
+    g = vertcat(x[1:]-x[:-1],sum1(x))
+    f = Function("f",[x],[g],{"coloring":"best"})
+    J = f.jacobian()
+    stats = J.stats()
+    self.assertTrue(stats["coloring_n_fwd"]+stats["coloring_n_adj"]>=stats["coloring_lower_bound"])
+    self.assertTrue("coloring_t_wall" in stats)
+
+    H = jacobian(gradient(sum1(g**2),x),x,{"symmetric":True,"coloring":"smallest_last"})
+    self.checkarray(IM.ones(H.sparsity()),IM.ones(hessian(sum1(g**2),x)[0].sparsity()))
+
+  def test_block(self):
+    sb = Sparsity.banded(4,1)
+    sp = sb.block_expand(3)
+    self.assertEqual(sp.block_size(),3)
+    self.assertTrue(sp.is_blocked(3))
+    self.assertFalse(sp.is_blocked(2))
+    self.assertTrue(sp.block_compress(3)==sb)
+    self.assertTrue(sp==kron(sb,Sparsity.dense(3,3)))
+    self.assertEqual(Sparsity.dense(4,6).block_size(),2)
+    self.assertEqual(Sparsity.diag(5).block_size(),1)
+    self.assertRaises(Exception,lambda: Sparsity.diag(4).block_compress(2))
+
 if __name__ == '__main__':
     unittest.main()